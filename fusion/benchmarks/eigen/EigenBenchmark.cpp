@@ -2,6 +2,7 @@
 
 #include <nanobench.h>
 #include <random>
+#include <string>
 #include <vector>
 
 #include <Eigen/Core>
@@ -17,6 +18,23 @@ std::vector<float> make_random_float_vector(std::size_t N, unsigned seed,
    return v;
 }
 
+template <int N> void run_fixed_matmul(ankerl::nanobench::Bench &bench) {
+   using Mat = Matrix<float, N, N, RowMajor>;
+   const Mat a = Mat::Random();
+   const Mat b = Mat::Random();
+   Mat c;
+   bench.run("MatMul fixed [" + std::to_string(N) + "]", [&] {
+      c.noalias() = a * b;
+      ankerl::nanobench::doNotOptimizeAway(c);
+   });
+   MatrixXf da = a;
+   MatrixXf db = b;
+   bench.run("MatMul dynamic [" + std::to_string(N) + "]", [&] {
+      MatrixXf r = da * db;
+      ankerl::nanobench::doNotOptimizeAway(r);
+   });
+}
+
 int main() {
    unsigned seed = 123456789;
    int epoch_iterations = 10000;
@@ -102,5 +120,28 @@ int main() {
           });
    }
 
+   // GEMM throughput, comparable with the "sgemm" table of FusionBenchMark.
+   ankerl::nanobench::Bench gemm;
+   gemm.title("Eigen sgemm").unit("flop").minEpochIterations(3);
+   for (const int n : {64, 128, 256, 512, 1024}) {
+      MatrixXf a = MatrixXf::Random(n, n);
+      MatrixXf b = MatrixXf::Random(n, n);
+      MatrixXf c(n, n);
+      gemm.batch(2.0 * double(n) * n * n);
+      gemm.run("MatMul [" + std::to_string(n) + "^3]", [&] {
+         c.noalias() = a * b;
+         ankerl::nanobench::doNotOptimizeAway(c.data());
+      });
+   }
+
+   // Fixed-size products, unrolled at compile time by Eigen; compare with
+   // the "small matmul" table of FusionBenchMark.
+   ankerl::nanobench::Bench small;
+   small.title("Eigen small matmul").minEpochIterations(epoch_iterations);
+   run_fixed_matmul<2>(small);
+   run_fixed_matmul<4>(small);
+   run_fixed_matmul<8>(small);
+   run_fixed_matmul<16>(small);
+
    return 0;
 }
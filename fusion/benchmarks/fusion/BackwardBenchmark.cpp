@@ -0,0 +1,73 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <nanobench.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+#include "Fusion/autodiff/ADTensor.hpp"
+#include "Fusion/core/Parallel.h"
+
+RawTensor<float> make_random_tensor(std::vector<std::size_t> shape,
+                                    unsigned seed) {
+   std::size_t n = 1;
+   for (auto d : shape) {
+      n *= d;
+   }
+   std::mt19937 engine{seed};
+   std::uniform_real_distribution<float> dist{-0.1f, 0.1f};
+   std::vector<float> v(n);
+   std::generate(v.begin(), v.end(), [&]() { return dist(engine); });
+   return RawTensor<float>(shape, v, DType::FLOAT32,
+                           Device{DeviceType::CPU, 0});
+}
+
+// `branches` independent x @ w_i -> exp -> @ w_i chains sharing one input,
+// summed into a scalar loss: the shape of multi-head / residual fan-outs.
+void run_wide_graph(bool parallel, const std::vector<RawTensor<float>> &ws,
+                    const RawTensor<float> &x_raw) {
+   EngineScope<float> scope;
+   scope.enter();
+   EngineContext<float>::get().set_parallel_backward(parallel);
+
+   ADTensor<float> x(x_raw, true);
+   std::vector<ADTensor<float>> heads;
+   heads.reserve(ws.size());
+   for (const auto &w_raw : ws) {
+      ADTensor<float> w(w_raw, true);
+      heads.push_back(x.matmul(w).exp().matmul(w).sum(-1, false));
+   }
+   ADTensor<float> loss = heads[0];
+   for (std::size_t i = 1; i < heads.size(); ++i) {
+      loss = loss + heads[i];
+   }
+   loss.backward();
+   ankerl::nanobench::doNotOptimizeAway(x.grad());
+}
+
+int main() {
+   const std::size_t dim = 128;
+   std::vector<std::size_t> branch_counts = {4, 16, 64};
+
+   ankerl::nanobench::Bench bench;
+   bench.title("Backward on wide graph (" +
+               std::to_string(fusion::parallel::get_num_threads()) +
+               " threads)")
+       .minEpochIterations(5)
+       .relative(true);
+
+   auto x = make_random_tensor({dim, dim}, 1);
+   for (auto branches : branch_counts) {
+      std::vector<RawTensor<float>> ws;
+      for (std::size_t b = 0; b < branches; ++b) {
+         ws.push_back(make_random_tensor({dim, dim}, unsigned(b + 2)));
+      }
+      const std::string suffix = " branches=" + std::to_string(branches);
+
+      bench.run("Sequential" + suffix, [&] { run_wide_graph(false, ws, x); });
+      bench.run("Parallel" + suffix, [&] { run_wide_graph(true, ws, x); });
+   }
+
+   return 0;
+}
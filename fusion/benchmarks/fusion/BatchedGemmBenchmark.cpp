@@ -0,0 +1,67 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <nanobench.h>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+#include "Fusion/core/Parallel.h"
+#include "Fusion/cpu/blas/backend/Gemm.hpp"
+
+std::vector<float> make_random_buffer(std::size_t n, unsigned seed) {
+   std::mt19937 engine{seed};
+   std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+   std::vector<float> v(n);
+   std::generate(v.begin(), v.end(), [&]() { return dist(engine); });
+   return v;
+}
+
+// Square [n x n] GEMMs over a grid of item sizes and batch counts, once per
+// strategy. "auto" is what matmul picks; compare it with the best row.
+// Without cblas_sgemm_batch the library-batch rows run over-batch.
+int main() {
+   using fusion::blas::BatchedGemmStrategy;
+   const std::vector<std::pair<std::string, BatchedGemmStrategy>> strategies =
+       {{"auto", BatchedGemmStrategy::Auto},
+        {"sequential", BatchedGemmStrategy::Sequential},
+        {"over-batch", BatchedGemmStrategy::OverBatch},
+        {"library-batch", BatchedGemmStrategy::LibraryBatch}};
+   const std::vector<int> sizes = {16, 64, 256};
+   const std::vector<std::size_t> batches = {1, 8, 64, 256};
+
+   ankerl::nanobench::Bench bench;
+   bench.title("batched sgemm (" +
+               std::to_string(fusion::parallel::get_num_threads()) +
+               " threads)")
+       .unit("flop")
+       .minEpochIterations(3);
+
+   for (const int n : sizes) {
+      for (const std::size_t batch : batches) {
+         const std::size_t item = std::size_t(n) * std::size_t(n);
+         if (item * batch > (std::size_t{1} << 24)) {
+            continue;
+         }
+         auto a = make_random_buffer(item * batch, 1);
+         auto b = make_random_buffer(item * batch, 2);
+         std::vector<float> c(item * batch);
+         const auto stride = static_cast<std::int64_t>(item);
+         bench.batch(2.0 * double(item) * n * double(batch));
+
+         for (const auto &[name, strategy] : strategies) {
+            const std::string label = name + " [" + std::to_string(batch) +
+                                      " x " + std::to_string(n) + "^3]";
+            bench.run(label, [&] {
+               fusion::blas::batched_gemm_rowmajor<float>(
+                   false, false, n, n, n, 1.0f, a.data(), n, stride, b.data(),
+                   n, stride, 0.0f, c.data(), n, stride, batch, strategy);
+               ankerl::nanobench::doNotOptimizeAway(c.data());
+            });
+         }
+      }
+   }
+
+   return 0;
+}
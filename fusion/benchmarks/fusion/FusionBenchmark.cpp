@@ -2,9 +2,13 @@
 
 #include <nanobench.h>
 #include <random>
+#include <string>
 #include <vector>
 
 #include "Fusion/core/RawTensor.hpp"
+#include "Fusion/cpu/blas/PackedGemm.hpp"
+#include "Fusion/cpu/blas/SmallGemm.hpp"
+#include "Fusion/cpu/blas/backend/Gemm.hpp"
 
 std::vector<float> make_random_float_vector(std::size_t N, unsigned seed,
                                             float min = 0, float max = 100) {
@@ -92,5 +96,95 @@ int main() {
           });
    }
 
+   // Raw GEMM throughput: the packed native kernel (what builds without a
+   // BLAS library use) against the linked BLAS on the same buffers.
+   ankerl::nanobench::Bench gemm;
+   gemm.title("sgemm").unit("flop").minEpochIterations(3);
+   for (const int n : {64, 128, 256, 512, 1024}) {
+      const std::size_t nn = std::size_t(n) * std::size_t(n);
+      auto a = make_random_float_vector(nn, seed, -1, 1);
+      auto b = make_random_float_vector(nn, seed + 1, -1, 1);
+      std::vector<float> c(nn);
+      gemm.batch(2.0 * double(nn) * n);
+      const std::string suffix = " [" + std::to_string(n) + "^3]";
+
+      gemm.run("packed" + suffix, [&] {
+         fusion::blas::packed::gemm<float>(false, false, n, n, n, 1.0f,
+                                           a.data(), n, b.data(), n, 0.0f,
+                                           c.data(), n);
+         ankerl::nanobench::doNotOptimizeAway(c.data());
+      });
+      gemm.run("blas" + suffix, [&] {
+         fusion::blas::backend::gemm_rowmajor(false, false, n, n, n, 1.0f,
+                                              a.data(), n, b.data(), n, 0.0f,
+                                              c.data(), n);
+         ankerl::nanobench::doNotOptimizeAway(c.data());
+      });
+   }
+
+   // Small products, where call overhead dominates: matmul end to end, the
+   // small-GEMM kernels alone, and BLAS on the same buffers. Compare with
+   // the fixed-size "Eigen small matmul" table of EigenBenchMark.
+   ankerl::nanobench::Bench small;
+   small.title("small matmul").minEpochIterations(epoch_iterations);
+   for (const std::size_t n : {2, 4, 8, 16}) {
+      const int ni = static_cast<int>(n);
+      const auto ld = static_cast<std::int64_t>(n);
+      auto va = make_random_float_vector(n * n, seed, -1, 1);
+      auto vb = make_random_float_vector(n * n, seed + 1, -1, 1);
+      RawTensor<float> a({n, n}, va, DType::FLOAT32,
+                         Device{DeviceType::CPU, 0});
+      RawTensor<float> b({n, n}, vb, DType::FLOAT32,
+                         Device{DeviceType::CPU, 0});
+      std::vector<float> c(n * n);
+      const std::string suffix = " [" + std::to_string(n) + "]";
+
+      small.run("matmul" + suffix, [&] {
+         RawTensor<float> r = a.matmul(b);
+         ankerl::nanobench::doNotOptimizeAway(r);
+      });
+      small.run("kernel" + suffix, [&] {
+         fusion::blas::small::gemm<float>(false, false, n, n, n, va.data(), ld,
+                                          vb.data(), ld, c.data(), ld);
+         ankerl::nanobench::doNotOptimizeAway(c.data());
+      });
+      small.run("blas" + suffix, [&] {
+         fusion::blas::backend::gemm_rowmajor(false, false, ni, ni, ni, 1.0f,
+                                              va.data(), ni, vb.data(), ni,
+                                              0.0f, c.data(), ni);
+         ankerl::nanobench::doNotOptimizeAway(c.data());
+      });
+   }
+
+   // A dense layer, relu(x W^T + b): the fused op against matmul, bias add
+   // and activation as three passes over the output.
+   ankerl::nanobench::Bench dense;
+   dense.title("linear").minEpochIterations(10);
+   const std::size_t features = 512;
+   auto vw = make_random_float_vector(features * features, seed, -1, 1);
+   auto vbias = make_random_float_vector(features, seed + 1, -1, 1);
+   RawTensor<float> w({features, features}, vw, DType::FLOAT32,
+                      Device{DeviceType::CPU, 0});
+   RawTensor<float> bias({features}, vbias, DType::FLOAT32,
+                         Device{DeviceType::CPU, 0});
+   RawTensor<float> zero({1}, std::vector<float>{0.0f}, DType::FLOAT32,
+                         Device{DeviceType::CPU, 0});
+   for (const std::size_t rows : {32, 256, 1024}) {
+      auto vx = make_random_float_vector(rows * features, seed + 2, -1, 1);
+      RawTensor<float> x({rows, features}, vx, DType::FLOAT32,
+                         Device{DeviceType::CPU, 0});
+      const std::string suffix = " [" + std::to_string(rows) + "]";
+
+      dense.run("fused" + suffix, [&] {
+         RawTensor<float> r = x.linear(w, bias, Activation::ReLU);
+         ankerl::nanobench::doNotOptimizeAway(r);
+      });
+      dense.run("unfused" + suffix, [&] {
+         RawTensor<float> r =
+             (x.matmul(w.swapaxes_view(0, 1)) + bias).maximum(zero);
+         ankerl::nanobench::doNotOptimizeAway(r);
+      });
+   }
+
    return 0;
 }
@@ -0,0 +1,72 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <nanobench.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+#include "Fusion/core/Parallel.h"
+#include "Fusion/ops/PackedWeight.hpp"
+
+RawTensor<float> make_random_tensor(std::vector<std::size_t> shape,
+                                    unsigned seed) {
+   std::size_t n = 1;
+   for (const std::size_t d : shape) {
+      n *= d;
+   }
+   std::mt19937 engine{seed};
+   std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+   std::vector<float> v(n);
+   std::generate(v.begin(), v.end(), [&]() { return dist(engine); });
+   return RawTensor<float>(shape, v, DType::FLOAT32,
+                           Device{DeviceType::CPU, 0});
+}
+
+// Forward pass of a three-layer MLP, relu(relu(x W1^T + b1) W2^T + b2)
+// W3^T + b3, called over and over on the same weights as in inference.
+// "packed" keeps every kernel as a PackedWeight, so calls skip transposing
+// or packing it; "raw" passes the kernels as they are.
+int main() {
+   using fusion::math::linalg::PackedWeight;
+   const std::size_t features = 1024;
+   const std::size_t classes = 16;
+
+   std::vector<RawTensor<float>> kernels = {
+       make_random_tensor({features, features}, 1),
+       make_random_tensor({features, features}, 2),
+       make_random_tensor({classes, features}, 3)};
+   std::vector<RawTensor<float>> biases = {
+       make_random_tensor({features}, 4), make_random_tensor({features}, 5),
+       make_random_tensor({classes}, 6)};
+   std::vector<PackedWeight<float>> packed;
+   for (const RawTensor<float> &k : kernels) {
+      packed.emplace_back(k, true);
+   }
+
+   ankerl::nanobench::Bench bench;
+   bench.title("mlp inference (" +
+               std::to_string(fusion::parallel::get_num_threads()) +
+               " threads)")
+       .minEpochIterations(5);
+
+   for (const std::size_t rows : {1, 8, 32, 128}) {
+      const RawTensor<float> x = make_random_tensor({rows, features}, 7);
+      const std::string suffix = " [" + std::to_string(rows) + " rows]";
+
+      bench.run("raw" + suffix, [&] {
+         RawTensor<float> h = x.linear(kernels[0], biases[0], Activation::ReLU);
+         h = h.linear(kernels[1], biases[1], Activation::ReLU);
+         h = h.linear(kernels[2], biases[2]);
+         ankerl::nanobench::doNotOptimizeAway(h);
+      });
+      bench.run("packed" + suffix, [&] {
+         RawTensor<float> h = x.linear(packed[0], biases[0], Activation::ReLU);
+         h = h.linear(packed[1], biases[1], Activation::ReLU);
+         h = h.linear(packed[2], biases[2]);
+         ankerl::nanobench::doNotOptimizeAway(h);
+      });
+   }
+
+   return 0;
+}
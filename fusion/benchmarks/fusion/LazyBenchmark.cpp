@@ -0,0 +1,68 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <nanobench.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+#include "Fusion/core/Expr.hpp"
+#include "Fusion/core/Lazy.hpp"
+
+RawTensor<float> make_random_tensor(std::vector<std::size_t> shape,
+                                    unsigned seed) {
+   std::size_t n = 1;
+   for (auto d : shape) {
+      n *= d;
+   }
+   std::mt19937 engine{seed};
+   std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+   std::vector<float> v(n);
+   std::generate(v.begin(), v.end(), [&]() { return dist(engine); });
+   return RawTensor<float>(shape, v, DType::FLOAT32,
+                           Device{DeviceType::CPU, 0});
+}
+
+// The MeanSquaredError chain, eager (three passes, two temporaries) against
+// one fused tiled pass, plus a * b + c eager, lazy and as an expression
+// template.
+int main() {
+   const std::vector<std::size_t> sizes = {std::size_t{1} << 12,
+                                           std::size_t{1} << 16,
+                                           std::size_t{1} << 22};
+
+   ankerl::nanobench::Bench bench;
+   bench.title("eager vs lazy elementwise chains").minEpochIterations(10);
+
+   for (const std::size_t n : sizes) {
+      auto y = make_random_tensor({n}, 1);
+      auto p = make_random_tensor({n}, 2);
+      auto c = make_random_tensor({n}, 3);
+      const std::string suffix = " [" + std::to_string(n) + "]";
+      bench.batch(n).unit("elem");
+
+      bench.run("mse eager" + suffix, [&] {
+         auto out = ((y - p) * (y - p)).mean({}, false);
+         ankerl::nanobench::doNotOptimizeAway(out);
+      });
+      bench.run("mse lazy" + suffix, [&] {
+         auto d = fusion::lazy::defer(y) - p;
+         auto out = (d * d).mean({}, false);
+         ankerl::nanobench::doNotOptimizeAway(out);
+      });
+      bench.run("a*b+c eager" + suffix, [&] {
+         auto out = y * p + c;
+         ankerl::nanobench::doNotOptimizeAway(out);
+      });
+      bench.run("a*b+c lazy" + suffix, [&] {
+         auto out = (fusion::lazy::defer(y) * p + c).materialize();
+         ankerl::nanobench::doNotOptimizeAway(out);
+      });
+      bench.run("a*b+c expr" + suffix, [&] {
+         RawTensor<float> out = fusion::expr::ref(y) * p + c;
+         ankerl::nanobench::doNotOptimizeAway(out);
+      });
+   }
+
+   return 0;
+}
@@ -0,0 +1,77 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <nanobench.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+#include "Fusion/core/Parallel.h"
+
+template <typename T>
+RawTensor<T> make_random_tensor(std::vector<std::size_t> shape,
+                                unsigned seed) {
+   std::size_t n = 1;
+   for (const std::size_t d : shape) {
+      n *= d;
+   }
+   std::mt19937 engine{seed};
+   using A = fusion::accum_t<T>;
+   std::uniform_real_distribution<A> dist{A(-1), A(1)};
+   std::vector<T> v(n);
+   std::generate(v.begin(), v.end(), [&]() { return dist(engine); });
+   return RawTensor<T>(shape, v, dtype_of<T>(), Device{DeviceType::CPU, 0});
+}
+
+// The same GEMM, linear, element-wise and reduction calls at one precision;
+// the float32, float64, bfloat16 and float16 rows sit next to each other in
+// the table. The 16-bit rows load half the bytes and compute in fp32.
+template <typename T>
+void run_precision(ankerl::nanobench::Bench &bench, const std::string &tag) {
+   for (const std::size_t n : {128, 512, 1024}) {
+      const RawTensor<T> a = make_random_tensor<T>({n, n}, 1);
+      const RawTensor<T> b = make_random_tensor<T>({n, n}, 2);
+      bench.run("matmul " + std::to_string(n) + " " + tag, [&] {
+         RawTensor<T> c = a.matmul(b);
+         ankerl::nanobench::doNotOptimizeAway(c);
+      });
+   }
+
+   const RawTensor<T> x = make_random_tensor<T>({256, 1024}, 3);
+   const RawTensor<T> w = make_random_tensor<T>({1024, 1024}, 4);
+   const RawTensor<T> bias = make_random_tensor<T>({1024}, 5);
+   bench.run("linear+relu 256x1024 " + tag, [&] {
+      RawTensor<T> y = x.linear(w, bias, Activation::ReLU);
+      ankerl::nanobench::doNotOptimizeAway(y);
+   });
+
+   const std::size_t len = std::size_t{1} << 20;
+   const RawTensor<T> u = make_random_tensor<T>({len}, 6);
+   const RawTensor<T> v = make_random_tensor<T>({len}, 7);
+   bench.run("add 1M " + tag, [&] {
+      RawTensor<T> s = u + v;
+      ankerl::nanobench::doNotOptimizeAway(s);
+   });
+   bench.run("exp 1M " + tag, [&] {
+      RawTensor<T> e = u.exp();
+      ankerl::nanobench::doNotOptimizeAway(e);
+   });
+   bench.run("sum 1M " + tag, [&] {
+      RawTensor<T> s = u.sum(kGlobalReduceAxis, false);
+      ankerl::nanobench::doNotOptimizeAway(s);
+   });
+}
+
+int main() {
+   ankerl::nanobench::Bench bench;
+   bench.title("float32 vs float64 vs 16-bit storage (" +
+               std::to_string(fusion::parallel::get_num_threads()) +
+               " threads)")
+       .minEpochIterations(5);
+
+   run_precision<float>(bench, "f32");
+   run_precision<double>(bench, "f64");
+   run_precision<fusion::bfloat16>(bench, "bf16");
+   run_precision<fusion::float16>(bench, "f16");
+   return 0;
+}
@@ -0,0 +1,144 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <nanobench.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+#include "Fusion/core/Parallel.h"
+#include "Fusion/cpu/blas/backend/Gemm.hpp"
+#include "Fusion/ops/Quantize.hpp"
+
+using namespace fusion::math::quant;
+
+RawTensor<float> make_uniform(std::vector<std::size_t> shape, float lo,
+                              float hi, unsigned seed) {
+   std::size_t n = 1;
+   for (const std::size_t d : shape) {
+      n *= d;
+   }
+   std::mt19937 engine{seed};
+   std::uniform_real_distribution<float> dist{lo, hi};
+   std::vector<float> v(n);
+   std::generate(v.begin(), v.end(), [&]() { return dist(engine); });
+   return RawTensor<float>(shape, v, DType::FLOAT32,
+                           Device{DeviceType::CPU, 0});
+}
+
+// y = x W^T for [n x n] operands: the fp32 BatchedGemmBLAS call matmul and
+// linear make, against the int8 GEMM with a pre-packed weight, writing
+// float or requantized int8.
+void run_gemm(ankerl::nanobench::Bench &bench) {
+   for (const std::size_t n : {256, 512, 1024}) {
+      const RawTensor<float> x = make_uniform({n, n}, -1.0f, 1.0f, 1);
+      const RawTensor<float> w = make_uniform({n, n}, -1.0f, 1.0f, 2);
+      std::vector<float> y(n * n);
+      const auto ni = static_cast<int>(n);
+      const auto item = static_cast<std::int64_t>(n * n);
+      bench.batch(2.0 * double(n) * double(n) * double(n));
+
+      bench.run("fp32 sgemm " + std::to_string(n), [&] {
+         fusion::blas::batched_gemm_rowmajor<float>(
+             false, true, ni, ni, ni, 1.0f, x.get_ptr(), ni, item,
+             w.get_ptr(), ni, item, 0.0f, y.data(), ni, item, 1);
+         ankerl::nanobench::doNotOptimizeAway(y.data());
+      });
+
+      const QuantizedTensor xq = quantize(x, QuantScheme::Affine);
+      const QuantizedWeight wq(w);
+      bench.run("int8 -> f32 " + std::to_string(n), [&] {
+         RawTensor<float> out = linear(xq, wq);
+         ankerl::nanobench::doNotOptimizeAway(out);
+      });
+      const QuantParams out_params = calibrate(linear(xq, wq),
+                                               QuantScheme::Affine);
+      bench.run("int8 -> int8 " + std::to_string(n), [&] {
+         QuantizedTensor out =
+             linear(xq, wq, nullptr, Activation::None, out_params);
+         ankerl::nanobench::doNotOptimizeAway(out);
+      });
+   }
+}
+
+// A 784-512-256-10 ReLU MLP run in fp32 and in int8: per-unit symmetric
+// weights, activations requantized between layers with ranges calibrated
+// on the fp32 run, logits dequantized by the last layer.
+void report_mlp_accuracy() {
+   const std::vector<std::size_t> widths = {784, 512, 256, 10};
+   const std::size_t batch = 512;
+   std::vector<RawTensor<float>> weights;
+   std::vector<RawTensor<float>> biases;
+   for (std::size_t l = 0; l + 1 < widths.size(); ++l) {
+      const float bound = 1.0f / std::sqrt(float(widths[l]));
+      weights.push_back(make_uniform({widths[l + 1], widths[l]}, -bound,
+                                     bound, 10 + unsigned(l)));
+      biases.push_back(
+          make_uniform({widths[l + 1]}, -bound, bound, 20 + unsigned(l)));
+   }
+   const RawTensor<float> x = make_uniform({batch, widths[0]}, 0.0f, 1.0f, 3);
+
+   std::vector<RawTensor<float>> ref = {x};
+   for (std::size_t l = 0; l < weights.size(); ++l) {
+      const Activation act =
+          l + 1 < weights.size() ? Activation::ReLU : Activation::None;
+      ref.push_back(ref.back().linear(weights[l], biases[l], act));
+   }
+
+   QuantizedTensor h = quantize(x, QuantScheme::Affine);
+   RawTensor<float> logits;
+   for (std::size_t l = 0; l < weights.size(); ++l) {
+      const QuantizedWeight wq(weights[l]);
+      if (l + 1 < weights.size()) {
+         h = linear(h, wq, &biases[l], Activation::ReLU,
+                    calibrate(ref[l + 1], QuantScheme::Affine));
+         const RawTensor<float> got = dequantize(h);
+         float max_err = 0.0f;
+         for (std::size_t i = 0; i < got.flat_size(); ++i) {
+            max_err = std::max(
+                max_err, std::abs(got.get_ptr()[i] - ref[l + 1].get_ptr()[i]));
+         }
+         std::printf("layer %zu: max |int8 - fp32| %.4g (step %.4g)\n", l + 1,
+                     max_err, h.params().scale[0]);
+      } else {
+         logits = linear(h, wq, &biases[l], Activation::None);
+      }
+   }
+
+   const RawTensor<float> &want = ref.back();
+   const std::size_t classes = widths.back();
+   double err2 = 0.0;
+   double ref2 = 0.0;
+   std::size_t agree = 0;
+   for (std::size_t r = 0; r < batch; ++r) {
+      const float *a = logits.get_ptr() + r * classes;
+      const float *b = want.get_ptr() + r * classes;
+      for (std::size_t c = 0; c < classes; ++c) {
+         err2 += double(a[c] - b[c]) * double(a[c] - b[c]);
+         ref2 += double(b[c]) * double(b[c]);
+      }
+      agree += std::max_element(a, a + classes) - a ==
+               std::max_element(b, b + classes) - b;
+   }
+   std::printf("logits: relative RMS error %.4g, top-1 agreement %.2f%% "
+               "(%zu samples, %s kernel)\n",
+               std::sqrt(err2 / ref2), 100.0 * double(agree) / double(batch),
+               batch, fusion::blas::quant::kKernelName);
+}
+
+int main() {
+   ankerl::nanobench::Bench bench;
+   bench.title(std::string("int8 vs fp32 GEMM, ") +
+               fusion::blas::quant::kKernelName + " (" +
+               std::to_string(fusion::parallel::get_num_threads()) +
+               " threads)")
+       .unit("op")
+       .minEpochIterations(5);
+
+   run_gemm(bench);
+   report_mlp_accuracy();
+   return 0;
+}
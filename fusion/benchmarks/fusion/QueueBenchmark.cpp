@@ -0,0 +1,72 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <atomic>
+#include <nanobench.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Fusion/core/MPMCQueue.hpp"
+#include "Fusion/core/ThreadSafeQueue.hpp"
+
+// Moves kItems integers through the queue with `threads` producers and
+// `threads` consumers running concurrently.
+template <typename Queue> void run_contention(Queue &q, std::size_t threads) {
+   constexpr std::size_t kItems = 1 << 16;
+   const std::size_t per_producer = kItems / threads;
+   const std::size_t total = per_producer * threads;
+   std::atomic<std::size_t> popped{0};
+
+   std::vector<std::thread> workers;
+   workers.reserve(2 * threads);
+   for (std::size_t p = 0; p < threads; ++p) {
+      workers.emplace_back([&] {
+         for (std::size_t i = 0; i < per_producer; ++i) {
+            q.push(i);
+         }
+      });
+   }
+   for (std::size_t c = 0; c < threads; ++c) {
+      workers.emplace_back([&] {
+         std::size_t v;
+         while (popped.load(std::memory_order_relaxed) < total) {
+            if (q.try_pop(v)) {
+               popped.fetch_add(1, std::memory_order_relaxed);
+               ankerl::nanobench::doNotOptimizeAway(v);
+            } else {
+               std::this_thread::yield();
+            }
+         }
+      });
+   }
+   for (auto &t : workers) {
+      t.join();
+   }
+}
+
+int main() {
+   std::vector<std::size_t> thread_counts = {1, 2, 8, 32};
+
+   ankerl::nanobench::Bench bench;
+   bench.title("Queue contention (N producers / N consumers)")
+       .unit("item")
+       .batch(1 << 16)
+       .minEpochIterations(5);
+
+   for (auto n : thread_counts) {
+      const std::string suffix = " " + std::to_string(n) + "x" +
+                                 std::to_string(n);
+
+      bench.run("ThreadSafeQueue" + suffix, [&] {
+         ThreadSafeQueue<std::size_t> q;
+         run_contention(q, n);
+      });
+
+      bench.run("MPMCQueue" + suffix, [&] {
+         MPMCQueue<std::size_t> q(1024);
+         run_contention(q, n);
+      });
+   }
+
+   return 0;
+}
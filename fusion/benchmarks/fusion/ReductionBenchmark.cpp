@@ -0,0 +1,64 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <nanobench.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+
+RawTensor<float> make_random_tensor(std::vector<std::size_t> shape,
+                                    unsigned seed) {
+   std::size_t n = 1;
+   for (auto d : shape) {
+      n *= d;
+   }
+   std::mt19937 engine{seed};
+   std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+   std::vector<float> v(n);
+   std::generate(v.begin(), v.end(), [&]() { return dist(engine); });
+   return RawTensor<float>(shape, v, DType::FLOAT32,
+                           Device{DeviceType::CPU, 0});
+}
+
+// axis=0 is the bias-gradient reduction over the batch (column kernel),
+// axis=1 the per-row reduction over features (contiguous SIMD reduce).
+int main() {
+   const std::vector<std::vector<std::size_t>> shapes = {
+       {64, 1024}, {1024, 1024}, {16384, 256}, {256, 16384}};
+
+   ankerl::nanobench::Bench bench;
+   bench.title("sum over axis 0 vs axis 1").minEpochIterations(10);
+
+   for (const auto &shape : shapes) {
+      auto x = make_random_tensor(shape, 42);
+      const std::string suffix = " [" + std::to_string(shape[0]) + "x" +
+                                 std::to_string(shape[1]) + "]";
+      bench.batch(shape[0] * shape[1]).unit("elem");
+
+      bench.run("sum axis=0" + suffix, [&] {
+         auto out = x.sum(0, false);
+         ankerl::nanobench::doNotOptimizeAway(out);
+      });
+      bench.run("sum axis=1" + suffix, [&] {
+         auto out = x.sum(1, false);
+         ankerl::nanobench::doNotOptimizeAway(out);
+      });
+   }
+
+   ankerl::nanobench::Bench global;
+   global.title("global sum").minEpochIterations(5);
+   auto big = make_random_tensor({std::size_t{1} << 24}, 7);
+   global.batch(big.flat_size()).unit("elem");
+   global.run("sum pairwise", [&] {
+      auto out = big.sum(std::vector<std::size_t>{}, false);
+      ankerl::nanobench::doNotOptimizeAway(out);
+   });
+   global.run("sum compensated", [&] {
+      auto out = big.sum(std::vector<std::size_t>{}, false,
+                         SumMode::Compensated);
+      ankerl::nanobench::doNotOptimizeAway(out);
+   });
+
+   return 0;
+}
@@ -32,7 +32,7 @@ template <typename T> class Random {
          data.push_back(dist(engine_));
       }
 
-      return RawTensor<T>(shape, std::move(data), DType::FLOAT32, device);
+      return RawTensor<T>(shape, std::move(data), dtype_of<T>(), device);
    }
 };
 
@@ -14,7 +14,7 @@ RawTensor<T> fill(const std::vector<size_t> &shape, T value, Device device) {
    size_t n = std::accumulate(shape.begin(), shape.end(), size_t{1},
                               std::multiplies<size_t>());
    std::vector<T> data(n, value);
-   return RawTensor<T>(shape, std::move(data), DType::FLOAT32, device);
+   return RawTensor<T>(shape, std::move(data), dtype_of<T>(), device);
 }
 
 template <typename T>
@@ -57,6 +57,7 @@ PoolAllocator::PoolAllocator()
 PoolAllocator::~PoolAllocator() = default;
 
 void *PoolAllocator::allocate(std::size_t size, Alignment alignment) {
+   std::lock_guard<std::mutex> lock(mutex_);
    if (size == 0) {
       size = 1;
    }
@@ -95,6 +96,7 @@ void PoolAllocator::deallocate(void *ptr) {
    if (ptr == nullptr) {
       return;
    }
+   std::lock_guard<std::mutex> lock(mutex_);
 
    ChunkID chunk_id = region_manager_.get_chunkid_from_ptr(ptr);
    Chunk &chunk = get_chunk_from_id(chunk_id);
@@ -110,10 +112,14 @@ void PoolAllocator::deallocate(void *ptr) {
    bucket.free_chunks.insert(chunk_id);
 }
 
-std::vector<Chunk> PoolAllocator::chunks() const { return chunks_; }
+std::vector<Chunk> PoolAllocator::chunks() const {
+   std::lock_guard<std::mutex> lock(mutex_);
+   return chunks_;
+}
 
 std::vector<ChunkID>
 PoolAllocator::get_free_chunks(std::size_t bucket_size) const {
+   std::lock_guard<std::mutex> lock(mutex_);
    std::vector<ChunkID> result;
    auto it = buckets_by_size_.find(bucket_size);
    if (it == buckets_by_size_.end()) {
@@ -6,6 +6,7 @@
 #include <cstddef>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <set>
 #include <stdexcept>
 #include <unordered_map>
@@ -89,6 +90,9 @@ class PoolAllocator final : public IAllocator {
    ChunkID free_and_maybe_coalesce(ChunkID chunk_id);
 
  private:
+   // Guards all pool state; tensors are allocated and freed from pool
+   // workers as well as the caller.
+   mutable std::mutex mutex_;
    std::unique_ptr<ISubAllocator> sub_allocator_;
    std::vector<Chunk> chunks_;
    RegionManager region_manager_;
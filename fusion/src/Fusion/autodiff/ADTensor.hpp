@@ -5,6 +5,8 @@
 #include <memory>
 #include <ostream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -257,6 +259,40 @@ template <typename T> class ADTensor {
           other, [](const Raw &x, const Raw &y) { return x.matmul(y); });
    }
 
+   // act(this W^T + b) as one node: bias and activation run in the GEMM
+   // epilogue, and the backward pass applies the activation derivative to
+   // the upstream gradient in a single pass.
+   ADTensor linear(const ADTensor &W, const ADTensor &b,
+                   const Activation act = Activation::None) const {
+      LinearParam lp{.activation = act};
+      return autodiff::ternary<T, Operation<T, Linear<T>>, LinearParam>(
+          *this, W, b, lp,
+          [](const ADTensor &x, const ADTensor &w, const ADTensor &bias,
+             const LinearParam &p) {
+             Raw out = x.raw().linear(w.raw(), bias.raw(), p.activation);
+             const bool req_grad = x.requires_grad() || w.requires_grad() ||
+                                   bias.requires_grad();
+             return ADTensor(std::move(out), req_grad);
+          });
+   }
+
+   ADTensor linear(const ADTensor &W,
+                   const Activation act = Activation::None) const {
+      LinearParam lp{.activation = act};
+      return apply_binary_op<Linear<T>, LinearParam>(
+          W, lp, [](const Raw &x, const Raw &w, const LinearParam &p) {
+             return x.linear(w, p.activation);
+          });
+   }
+
+   ADTensor einsum(std::string_view subscripts, const ADTensor &other) const {
+      EinsumParam ep{.subscripts = std::string(subscripts)};
+      return apply_binary_op<Einsum<T>, EinsumParam>(
+          other, ep, [](const Raw &x, const Raw &y, const EinsumParam &p) {
+             return x.einsum(p.subscripts, y);
+          });
+   }
+
    ADTensor sqrt() const {
       return apply_unary_op<Sqrt<T>>([](const Raw &x) { return x.sqrt(); });
    }
@@ -270,21 +306,54 @@ template <typename T> class ADTensor {
    }
 
    ADTensor sum(const std::size_t axis, const bool keepdim) const {
-      ReductionParam rp{.reduction_axis = axis, .keepdim = keepdim};
+      if (axis == kGlobalReduceAxis) {
+         return sum(std::vector<std::size_t>{}, keepdim);
+      }
+      return sum(std::vector<std::size_t>{axis}, keepdim);
+   }
+
+   ADTensor sum(const std::vector<std::size_t> &axes,
+                 const bool keepdim) const {
+      ReductionParam rp{.reduction_axes = axes, .keepdim = keepdim};
       return apply_unary_op<Sum<T>, ReductionParam>(
           rp, [](const Raw &x, const ReductionParam &p) {
-             return x.sum(p.reduction_axis, p.keepdim);
+             return x.sum(p.reduction_axes, p.keepdim);
           });
    }
 
    ADTensor mean(const std::size_t axis, const bool keepdim) const {
-      ReductionParam rp{.reduction_axis = axis, .keepdim = keepdim};
+      if (axis == kGlobalReduceAxis) {
+         return mean(std::vector<std::size_t>{}, keepdim);
+      }
+      return mean(std::vector<std::size_t>{axis}, keepdim);
+   }
+
+   ADTensor mean(const std::vector<std::size_t> &axes,
+                 const bool keepdim) const {
+      ReductionParam rp{.reduction_axes = axes, .keepdim = keepdim};
       return apply_unary_op<Mean<T>, ReductionParam>(
           rp, [](const Raw &x, const ReductionParam &p) {
-             return x.mean(p.reduction_axis, p.keepdim);
+             return x.mean(p.reduction_axes, p.keepdim);
+          });
+   }
+
+   // correction = 1 for the unbiased sample estimate.
+   ADTensor var(const std::vector<std::size_t> &axes, const bool keepdim,
+                const std::size_t correction = 0) const {
+      VarianceParam vp{.reduction_axes = axes,
+                       .keepdim = keepdim,
+                       .correction = correction};
+      return apply_unary_op<Variance<T>, VarianceParam>(
+          vp, [](const Raw &x, const VarianceParam &p) {
+             return x.var(p.reduction_axes, p.keepdim, p.correction);
           });
    }
 
+   ADTensor stddev(const std::vector<std::size_t> &axes, const bool keepdim,
+                   const std::size_t correction = 0) const {
+      return var(axes, keepdim, correction).sqrt();
+   }
+
    ADTensor swapaxes(int axis1, int axis2) const {
       using SwapAxesOp = SwapAxes<T>;
       SwapAxesParam sp{.axis1 = axis1, .axis2 = axis2};
@@ -330,6 +399,21 @@ template <typename T> class ADTensor {
           });
    }
 
+   template <typename OpTag, typename Param, typename F>
+   ADTensor apply_binary_op(const ADTensor &other, const Param &p,
+                            F &&f) const {
+      using Op = Operation<T, OpTag>;
+      const ADTensor &self = *this;
+      F ff = std::forward<F>(f);
+      return autodiff::binary<T, Op, Param>(
+          self, other, p,
+          [&](const ADTensor &x, const ADTensor &y, const Param &param) {
+             Raw out = ff(x.raw(), y.raw(), param);
+             bool req_grad = grad_flow(x, y);
+             return ADTensor(std::move(out), req_grad);
+          });
+   }
+
    template <typename OpTag, typename F> ADTensor apply_unary_op(F &&f) const {
       using Op = Operation<T, OpTag>;
       const ADTensor &self = *this;
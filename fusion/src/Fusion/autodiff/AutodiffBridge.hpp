@@ -12,4 +12,27 @@ template <typename T> inline void set_autodiff_enabled(bool on) {
    EngineContext<T>::set(on ? &kDefaultEngine : nullptr);
 }
 
+// Python exposes Tensor (float) and Tensor64 (double). Its autodiff switch
+// and grad_tape install an engine for both, so ops in either precision are
+// recorded.
+inline void set_autodiff_enabled_all(bool on) {
+   set_autodiff_enabled<float>(on);
+   set_autodiff_enabled<double>(on);
+}
+
+struct GradTape {
+   void enter() {
+      f32_.enter();
+      f64_.enter();
+   }
+   void exit() {
+      f32_.exit();
+      f64_.exit();
+   }
+
+ private:
+   EngineScope<float> f32_;
+   EngineScope<double> f64_;
+};
+
 #endif // AUTODIFF_BRIDGE_HPP
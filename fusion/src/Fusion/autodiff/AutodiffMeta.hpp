@@ -20,6 +20,10 @@ template <typename T> struct AutodiffMeta {
    // but must be strongly typed at call site. This means strongtypes
    // must be defined for each ops param type (curr defs in ops/OpParams.h)
    std::any op_param;
+   // Backward only: accumulate_into[j], when set, is the live gradient
+   // buffer of input j. An op may add input j's gradient there itself (e.g.
+   // a GEMM with beta = 1) and return an uninitialised tensor in slot j.
+   std::vector<RawTensor<T> *> accumulate_into;
 
    AutodiffMeta() = default;
    explicit AutodiffMeta(std::size_t n) { data.reserve(n); }
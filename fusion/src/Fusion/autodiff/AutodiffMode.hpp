@@ -41,6 +41,14 @@ inline bool should_trace(const ADTensor<T> &x, const ADTensor<T> &y) {
    return grad_enabled() && (x.requires_grad() || y.requires_grad()) &&
           EngineContext<T>::has();
 }
+
+template <typename T>
+inline bool should_trace(const ADTensor<T> &x, const ADTensor<T> &y,
+                         const ADTensor<T> &z) {
+   return grad_enabled() &&
+          (x.requires_grad() || y.requires_grad() || z.requires_grad()) &&
+          EngineContext<T>::has();
+}
 } // namespace autodiff
 
 #endif // AUTODIFF_MODE_HPP
@@ -40,6 +40,17 @@ inline AutodiffMeta<T> construct_meta(const ADTensor<T> &x,
    return meta;
 }
 
+template <typename T, typename Param>
+inline AutodiffMeta<T> construct_meta(const ADTensor<T> &x,
+                                      const ADTensor<T> &y,
+                                      const Param &param) {
+   AutodiffMeta<T> meta;
+   meta.push_back(x.raw());
+   meta.push_back(y.raw());
+   meta.op_param = param;
+   return meta;
+}
+
 template <typename T, class Op, typename Param, class EagerFn>
 inline ADTensor<T> unary(const ADTensor<T> &x, const Param &params,
                          EagerFn &&eager) {
@@ -59,6 +70,18 @@ inline ADTensor<T> unary(const ADTensor<T> &x, const Param &params,
    return result;
 }
 
+template <typename T, typename Param>
+inline AutodiffMeta<T>
+construct_meta(const ADTensor<T> &x, const ADTensor<T> &y,
+               const ADTensor<T> &z, const Param &param) {
+   AutodiffMeta<T> meta;
+   meta.push_back(x.raw());
+   meta.push_back(y.raw());
+   meta.push_back(z.raw());
+   meta.op_param = param;
+   return meta;
+}
+
 template <typename T, class Op, class EagerFn>
 inline ADTensor<T> unary(const ADTensor<T> &x, EagerFn &&eager) {
    EagerFn feager = std::forward<EagerFn>(eager);
@@ -100,6 +123,51 @@ inline ADTensor<T> binary(const ADTensor<T> &x, const ADTensor<T> &y,
    return result;
 }
 
+template <typename T, class Op, typename Param, class EagerFn>
+inline ADTensor<T> binary(const ADTensor<T> &x, const ADTensor<T> &y,
+                          const Param &params, EagerFn &&eager) {
+   EagerFn feager = std::forward<EagerFn>(eager);
+   const bool needs_grad =
+       grad_enabled() && (x.requires_grad() || y.requires_grad());
+   if (!needs_grad || !should_trace(x, y)) {
+      return feager(x, y, params);
+   }
+   Engine<T> &eng = EngineContext<T>::get();
+   ValueID vx = const_cast<ADTensor<T> &>(x).ensure_vid();
+   ValueID vy = const_cast<ADTensor<T> &>(y).ensure_vid();
+   AutodiffMeta<T> meta = construct_meta<T>(x, y, params);
+   std::vector<ValueID> vids{vx, vy};
+   ValueID out = eng.template apply<Op>(meta, vids);
+   RawTensor<T> raw = eng.materialise(out);
+   ADTensor<T> result(std::move(raw), needs_grad);
+   result.set_vid(out);
+   return result;
+}
+
+template <typename T, class Op, typename Param, class EagerFn>
+inline ADTensor<T> ternary(const ADTensor<T> &x, const ADTensor<T> &y,
+                           const ADTensor<T> &z, const Param &params,
+                           EagerFn &&eager) {
+   EagerFn feager = std::forward<EagerFn>(eager);
+   const bool needs_grad = grad_enabled() && (x.requires_grad() ||
+                                              y.requires_grad() ||
+                                              z.requires_grad());
+   if (!needs_grad || !should_trace(x, y, z)) {
+      return feager(x, y, z, params);
+   }
+   Engine<T> &eng = EngineContext<T>::get();
+   ValueID vx = const_cast<ADTensor<T> &>(x).ensure_vid();
+   ValueID vy = const_cast<ADTensor<T> &>(y).ensure_vid();
+   ValueID vz = const_cast<ADTensor<T> &>(z).ensure_vid();
+   AutodiffMeta<T> meta = construct_meta<T>(x, y, z, params);
+   std::vector<ValueID> vids{vx, vy, vz};
+   ValueID out = eng.template apply<Op>(meta, vids);
+   RawTensor<T> raw = eng.materialise(out);
+   ADTensor<T> result(std::move(raw), needs_grad);
+   result.set_vid(out);
+   return result;
+}
+
 } // namespace autodiff
 
 #endif // DISPATCH_HPP
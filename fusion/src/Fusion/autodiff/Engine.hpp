@@ -1,15 +1,21 @@
 #ifndef ENGINE_HPP
 #define ENGINE_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ostream>
 #include <stdexcept>
+#include <thread>
 #include <unordered_set>
 
 #include "Fusion/TensorFactory.hpp"
 #include "Fusion/common/Checks.hpp"
+#include "Fusion/core/Parallel.h"
 
 #include "ADTypes.h"
 #include "AutodiffMeta.hpp"
@@ -33,6 +39,8 @@ struct ShapeHash {
    }
 };
 
+template <typename T> class GraphExecutor;
+
 template <typename T> class Engine {
  public:
    Engine() = default;
@@ -50,6 +58,7 @@ template <typename T> class Engine {
       NodeID nid = create_node_and_bind_inputs<Op>(payload, vids);
 
       INode<T> &node = graph_.get_node(nid);
+      node.set_op_param(payload.op_param);
       AutodiffMeta<T> out = run_forward(node, payload);
 
       FUSION_CHECK(!out.empty(),
@@ -66,26 +75,14 @@ template <typename T> class Engine {
                               bool retain_graph = false) {
       prepare_grad_buffers();
 
-      std::vector<NodeID> order = topo_sort_for_backward();
       AutodiffMeta<T> seed = init_seed_grad(seed_vid);
 
       static_cast<void>(seed);
 
-      for (auto it = order.rbegin(); it != order.rend(); ++it) {
-         INode<T> &n = graph_.get_node(NodeID{it->idx});
-         FUSION_CHECK(n.has_outputs(), "node has no outputs in backward()");
-
-         const ValueID out_vid = n.get_output(0);
-         validate_forward_value_exists(n, out_vid);
-         ensure_output_grad_slot(out_vid);
-
-         AutodiffMeta<T> grad_in;
-         grad_in.push_back(grad_buff_[out_vid]);
-         AutodiffMeta<T> grad_out = safe_apply_backward(n, grad_in);
-
-         FUSION_CHECK(grad_out.size() == n.num_inputs(),
-                      "backward arity mismatch");
-         accum_input_grads(n, grad_out);
+      if (use_parallel_backward()) {
+         backward_parallel();
+      } else {
+         backward_sequential();
       }
 
       BackwardResult<T> result;
@@ -101,6 +98,17 @@ template <typename T> class Engine {
       return result;
    }
 
+   // Independent branches of the graph run backward concurrently on the
+   // shared thread pool when it has more than one thread and the graph has
+   // branches to overlap (a chain keeps the sequential walk). Gradients
+   // flowing into a value are summed in a fixed order, so parallel results
+   // do not depend on scheduling; they may differ from the sequential walk
+   // in the last bits.
+   void set_parallel_backward(bool enabled) noexcept {
+      parallel_backward_ = enabled;
+   }
+   bool parallel_backward() const noexcept { return parallel_backward_; }
+
    void maybe_mark_leaf(ValueID vid, const bool requires_grad) {
       if (graph_.get_produced_by(vid).nid == -1 && requires_grad) {
          requires_grad_set_.insert(vid);
@@ -190,11 +198,33 @@ template <typename T> class Engine {
    }
 
  private:
+   friend class GraphExecutor<T>;
+
    Graph<T> graph_{};
    std::vector<RawTensor<T>> val_buff_{};
    std::vector<RawTensor<T>> grad_buff_{};
    // TODO: make ValueID hashable so it can be used in the below unordered_set
    std::unordered_set<std::int64_t> requires_grad_set_{};
+   bool parallel_backward_{true};
+
+   // Bookkeeping for one parallel backward pass. pending[n] counts the
+   // consumer edges of node n's outputs that have not delivered a gradient
+   // yet; n becomes ready when it reaches zero. partials[v][k] holds the
+   // gradient from the k-th consumer of value v, written by exactly one task.
+   struct BackwardSchedule {
+      explicit BackwardSchedule(std::size_t num_nodes) : pending(num_nodes) {}
+
+      std::vector<std::atomic<std::size_t>> pending;
+      std::vector<std::vector<RawTensor<T>>> partials;
+      std::atomic<std::size_t> outstanding{0};
+      std::atomic<std::size_t> executed{0};
+      // Nodes running right now; they split threads between them.
+      std::atomic<std::size_t> running{0};
+      std::size_t threads = 1;
+      std::atomic<bool> failed{false};
+      std::mutex error_mutex;
+      std::exception_ptr error;
+   };
 
    void ensure_value_capacity(ValueID vid) {
       if (val_buff_.size() <= static_cast<size_t>(vid)) {
@@ -321,17 +351,224 @@ template <typename T> class Engine {
       }
    }
 
+   // A graph no wider than one node per level (a chain) has nothing to
+   // overlap, so it keeps the sequential walk.
+   bool use_parallel_backward() {
+      return parallel_backward_ && graph_.nodes_.size() > 1 &&
+             !fusion::parallel::in_parallel_region() &&
+             fusion::parallel::get_num_threads() > 1 && graph_width() > 1;
+   }
+
+   // Most nodes on one level of the graph: the most that can ever run at
+   // once.
+   std::size_t graph_width() {
+      const std::size_t num_nodes = graph_.nodes_.size();
+      std::vector<std::size_t> level(num_nodes, 0);
+      std::vector<std::size_t> width(num_nodes + 1, 0);
+      std::size_t widest = 0;
+      for (const NodeID nid : topo_sort_for_backward()) {
+         const auto i = static_cast<std::size_t>(nid);
+         for (const ValueID in : graph_.nodes_[i].inputs()) {
+            const NodeID src = graph_.produced_by_.at(in).nid;
+            if (src != kNoNode) {
+               level[i] = std::max(level[i], level[src] + 1);
+            }
+         }
+         widest = std::max(widest, ++width[level[i]]);
+      }
+      return widest;
+   }
+
+   void backward_sequential() {
+      std::vector<NodeID> order = topo_sort_for_backward();
+
+      for (auto it = order.rbegin(); it != order.rend(); ++it) {
+         INode<T> &n = graph_.get_node(NodeID{it->idx});
+         AutodiffMeta<T> grad_out = backward_node(n, false);
+         accum_input_grads(n, grad_out);
+      }
+   }
+
+   // The gradient buffer of vid when an op may add into it in place: it
+   // already holds a gradient, and no other tensor shares its storage.
+   RawTensor<T> *accumulation_target(ValueID vid) {
+      RawTensor<T> &dst = grad_buff_[vid];
+      if (!dst.is_initialised() || !dst.is_uniquely_owned() ||
+          !dst.is_contiguous()) {
+         return nullptr;
+      }
+      return &dst;
+   }
+
+   // The op may add input gradients straight into their buffers (see
+   // AutodiffMeta::accumulate_into). The parallel pass only offers values
+   // this node is the sole consumer of: nothing else writes them while it
+   // runs, and there is no summation order to keep.
+   AutodiffMeta<T> backward_node(INode<T> &n, const bool parallel) {
+      FUSION_CHECK(n.has_outputs(), "node has no outputs in backward()");
+
+      const ValueID out_vid = n.get_output(0);
+      validate_forward_value_exists(n, out_vid);
+      ensure_output_grad_slot(out_vid);
+
+      AutodiffMeta<T> grad_in;
+      grad_in.push_back(grad_buff_[out_vid]);
+      grad_in.accumulate_into.reserve(n.num_inputs());
+      for (std::size_t j = 0; j < n.num_inputs(); ++j) {
+         const ValueID in = n.get_input(j);
+         grad_in.accumulate_into.push_back(
+             !parallel || num_consumers(in) == 1 ? accumulation_target(in)
+                                                 : nullptr);
+      }
+      AutodiffMeta<T> grad_out = safe_apply_backward(n, grad_in);
+
+      FUSION_CHECK(grad_out.size() == n.num_inputs(),
+                   "backward arity mismatch");
+      return grad_out;
+   }
+
+   std::size_t num_consumers(ValueID vid) const {
+      const auto idx = static_cast<std::size_t>(vid);
+      return idx < graph_.consumed_by_.size() ? graph_.consumed_by_[idx].size()
+                                              : 0;
+   }
+
+   // Position of (nid, slot) in consumed_by[vid]; fixes the summation order.
+   std::size_t consumer_index(ValueID vid, NodeID nid, std::size_t slot) const {
+      const auto &consumers = graph_.consumed_by_.at(vid);
+      for (std::size_t k = 0; k < consumers.size(); ++k) {
+         if (consumers[k].nid == nid && consumers[k].in_slot == slot) {
+            return k;
+         }
+      }
+      throw std::runtime_error("Engine::backward: consumer table missing edge");
+   }
+
+   // Folds the per-consumer gradients of vid into grad_buff_[vid] in consumer
+   // order.
+   void reduce_partials(BackwardSchedule &s, ValueID vid) {
+      for (RawTensor<T> &src : s.partials[vid]) {
+         add_grad(vid, src);
+         src = RawTensor<T>{};
+      }
+   }
+
+   // grad_buff_[vid] += src. An uninitialised src was already added into
+   // the buffer by the op (accumulate_into).
+   void add_grad(ValueID vid, const RawTensor<T> &src) {
+      RawTensor<T> &dst = grad_buff_[vid];
+      if (!src.is_initialised()) {
+         return;
+      }
+      if (!dst.is_initialised()) {
+         dst = src;
+      } else {
+         dst = dst + src;
+      }
+   }
+
+   void backward_parallel() {
+      const std::size_t num_nodes = graph_.nodes_.size();
+      BackwardSchedule s(num_nodes);
+      s.partials.resize(grad_buff_.size());
+      for (std::size_t v = 0; v < grad_buff_.size(); ++v) {
+         s.partials[v].resize(num_consumers(ValueID{std::int64_t(v)}));
+      }
+
+      std::vector<NodeID> ready;
+      for (std::size_t i = 0; i < num_nodes; ++i) {
+         std::size_t count = 0;
+         for (const ValueID out : graph_.nodes_[i].outputs()) {
+            count += num_consumers(out);
+         }
+         s.pending[i].store(count, std::memory_order_relaxed);
+         if (count == 0) {
+            ready.push_back(NodeID{std::int64_t(i)});
+         }
+      }
+
+      const auto lease = fusion::parallel::shared_thread_pool();
+      ThreadPool &pool = *lease;
+      s.threads = fusion::parallel::get_num_threads();
+      {
+         fusion::parallel::ParallelRegionGuard region;
+         s.outstanding.store(ready.size());
+         for (const NodeID nid : ready) {
+            schedule_backward(s, nid);
+         }
+         while (s.outstanding.load(std::memory_order_acquire) != 0) {
+            if (!pool.run_pending_task()) {
+               std::this_thread::yield();
+            }
+         }
+      }
+
+      if (s.error) {
+         std::rethrow_exception(s.error);
+      }
+      FUSION_CHECK(s.executed.load() == num_nodes,
+                   "Engine::backward: graph contains cycles!");
+
+      const std::size_t num_values =
+          std::min(grad_buff_.size(), graph_.produced_by_.size());
+      for (std::size_t v = 0; v < num_values; ++v) {
+         if (graph_.produced_by_[v].nid == kNoNode) {
+            reduce_partials(s, ValueID{std::int64_t(v)});
+         }
+      }
+   }
+
+   void schedule_backward(BackwardSchedule &s, NodeID nid) {
+      fusion::parallel::thread_pool().submit(
+          [this, &s, nid] { run_backward_task(s, nid); });
+   }
+
+   void run_backward_task(BackwardSchedule &s, NodeID nid) {
+      INode<T> &n = graph_.get_node(nid);
+      if (!s.failed.load(std::memory_order_relaxed)) {
+         // A node running alone keeps every thread for its kernels; nodes
+         // running side by side split them.
+         const std::size_t running =
+             s.running.fetch_add(1, std::memory_order_acq_rel) + 1;
+         fusion::parallel::ParallelRegionGuard region(
+             std::max<std::size_t>(s.threads / running, 1));
+         struct Leave {
+            std::atomic<std::size_t> &running;
+            ~Leave() { running.fetch_sub(1, std::memory_order_acq_rel); }
+         } leave{s.running};
+         try {
+            reduce_partials(s, n.get_output(0));
+            AutodiffMeta<T> grad_out = backward_node(n, true);
+            for (std::size_t j = 0; j < n.num_inputs(); ++j) {
+               const ValueID in_vid = n.get_input(j);
+               s.partials[in_vid][consumer_index(in_vid, nid, j)] =
+                   std::move(grad_out[j]);
+            }
+         } catch (...) {
+            std::lock_guard<std::mutex> lock(s.error_mutex);
+            if (!s.error) {
+               s.error = std::current_exception();
+            }
+            s.failed = true;
+         }
+      }
+
+      // Release producers even after a failure so the pass drains.
+      for (std::size_t j = 0; j < n.num_inputs(); ++j) {
+         const NodeID src = graph_.produced_by_[n.get_input(j)].nid;
+         if (src != kNoNode &&
+             s.pending[src].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            s.outstanding.fetch_add(1, std::memory_order_relaxed);
+            schedule_backward(s, src);
+         }
+      }
+      s.executed.fetch_add(1, std::memory_order_relaxed);
+      s.outstanding.fetch_sub(1, std::memory_order_acq_rel);
+   }
+
    void accum_input_grads(const INode<T> &n, const AutodiffMeta<T> &gout) {
       for (size_t j = 0; j < n.num_inputs(); ++j) {
-         const ValueID in_vid = n.get_input(j);
-         RawTensor<T> &dst = grad_buff_[in_vid];
-         const RawTensor<T> &src = gout[j];
-
-         if (!dst.is_initialised()) {
-            dst = src;
-         } else {
-            dst = dst + src;
-         }
+         add_grad(n.get_input(j), gout[j]);
       }
    }
 };
@@ -0,0 +1,212 @@
+#ifndef EXECUTOR_HPP
+#define EXECUTOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Fusion/common/Checks.hpp"
+#include "Fusion/core/MPMCQueue.hpp"
+#include "Fusion/core/Parallel.h"
+
+#include "ADTypes.h"
+#include "AutodiffMeta.hpp"
+#include "Engine.hpp"
+
+// Thread budget for replaying a graph. 0 = derive from the graph and the
+// pool size.
+struct ExecutorOptions {
+   // Nodes that may run at the same time.
+   std::size_t inter_op_threads = 0;
+   // Threads each running node may use for its own kernels and BLAS.
+   std::size_t intra_op_threads = 0;
+};
+
+// Replays the forward graph captured by an Engine. Nodes whose inputs are
+// ready go on a ready queue drained by inter_op_threads runners (the caller
+// plus pool workers); each node runs with an intra-op budget, so a wide
+// graph of small ops spreads over the cores and a narrow graph of large ops
+// keeps its threads inside the kernels.
+//
+// Replay updates the engine's values and each node's saved context, so
+// Engine::backward after run() differentiates the replayed pass.
+template <typename T> class GraphExecutor {
+ public:
+   explicit GraphExecutor(Engine<T> &engine, ExecutorOptions options = {})
+       : engine_(engine), options_(options) {
+      analyse();
+   }
+
+   // Replaces the value of a captured graph input before the next run().
+   void feed(ValueID vid, const RawTensor<T> &value) {
+      FUSION_CHECK(engine_.graph_.get_produced_by(vid).nid == kNoNode,
+                   "GraphExecutor::feed: value is produced by a node");
+      engine_.val_buff_.at(vid) = value;
+   }
+
+   const RawTensor<T> &value(ValueID vid) const {
+      return engine_.val_buff_.at(vid);
+   }
+
+   std::size_t inter_op_threads() const noexcept { return inter_op_; }
+   std::size_t intra_op_threads() const noexcept { return intra_op_; }
+   std::size_t max_width() const noexcept { return max_width_; }
+
+   void run() {
+      const std::size_t num_nodes = engine_.graph_.nodes().size();
+      if (num_nodes == 0) {
+         return;
+      }
+
+      RunState s(num_nodes);
+      for (std::size_t i = 0; i < num_nodes; ++i) {
+         s.pending[i].store(in_degree_[i], std::memory_order_relaxed);
+         if (in_degree_[i] == 0) {
+            s.ready.push(NodeID{std::int64_t(i)});
+         }
+      }
+
+      fusion::parallel::BlasThreadScope blas(intra_op_);
+      const auto lease = fusion::parallel::shared_thread_pool();
+      ThreadPool &pool = *lease;
+      s.runners.store(inter_op_, std::memory_order_relaxed);
+      for (std::size_t r = 1; r < inter_op_; ++r) {
+         pool.submit([this, &s] { runner(s); });
+      }
+      runner(s);
+      // Runners hold a reference to s; wait until every one has left.
+      while (s.runners.load(std::memory_order_acquire) != 0) {
+         if (!pool.run_pending_task()) {
+            std::this_thread::yield();
+         }
+      }
+
+      if (s.error) {
+         std::rethrow_exception(s.error);
+      }
+   }
+
+ private:
+   struct RunState {
+      explicit RunState(std::size_t num_nodes)
+          : pending(num_nodes), ready(std::bit_ceil(std::max<std::size_t>(
+                                    num_nodes, 2))),
+            total(num_nodes) {}
+
+      std::vector<std::atomic<std::size_t>> pending;
+      MPMCQueue<NodeID> ready;
+      const std::size_t total;
+      std::atomic<std::size_t> finished{0};
+      std::atomic<std::size_t> runners{0};
+      std::atomic<bool> failed{false};
+      std::mutex error_mutex;
+      std::exception_ptr error;
+   };
+
+   Engine<T> &engine_;
+   ExecutorOptions options_;
+   std::vector<std::size_t> in_degree_;
+   std::size_t max_width_ = 1;
+   std::size_t inter_op_ = 1;
+   std::size_t intra_op_ = 1;
+
+   // In-degrees for the ready queue and the widest level of the graph, which
+   // bounds how many nodes can ever run at once.
+   void analyse() {
+      auto &graph = engine_.graph_;
+      const std::size_t num_nodes = graph.nodes().size();
+      in_degree_.assign(num_nodes, 0);
+      std::vector<std::size_t> level(num_nodes, 0);
+
+      // Levels are assigned in topological order (the sort throws on a
+      // cycle), so every producer's level is final before its consumers'.
+      for (const NodeID nid : engine_.topo_sort_for_backward()) {
+         const auto i = static_cast<std::size_t>(nid);
+         for (const ValueID in : graph.nodes()[i].inputs()) {
+            const NodeID src = graph.produced_by().at(in).nid;
+            if (src != kNoNode) {
+               ++in_degree_[i];
+               level[i] = std::max(level[i], level[src] + 1);
+            }
+         }
+      }
+      std::vector<std::size_t> width(num_nodes + 1, 0);
+      for (std::size_t l : level) {
+         max_width_ = std::max(max_width_, ++width[l]);
+      }
+
+      const std::size_t threads = fusion::parallel::get_num_threads();
+      inter_op_ = options_.inter_op_threads != 0
+                      ? options_.inter_op_threads
+                      : std::min(max_width_, threads);
+      inter_op_ = std::max<std::size_t>(inter_op_, 1);
+      intra_op_ = options_.intra_op_threads != 0
+                      ? options_.intra_op_threads
+                      : std::max<std::size_t>(threads / inter_op_, 1);
+   }
+
+   void runner(RunState &s) {
+      fusion::parallel::ParallelRegionGuard region(intra_op_);
+      ThreadPool &pool = fusion::parallel::thread_pool();
+      NodeID nid{-1};
+      while (s.finished.load(std::memory_order_acquire) < s.total) {
+         if (!s.ready.try_pop(nid)) {
+            // Help with the chunks running nodes queued on the pool rather
+            // than spin while they wait for helpers.
+            if (!pool.run_pending_task()) {
+               std::this_thread::yield();
+            }
+            continue;
+         }
+         run_node(s, nid);
+      }
+      s.runners.fetch_sub(1, std::memory_order_acq_rel);
+   }
+
+   void run_node(RunState &s, NodeID nid) {
+      auto &graph = engine_.graph_;
+      INode<T> &node = graph.get_node(nid);
+
+      if (!s.failed.load(std::memory_order_relaxed)) {
+         try {
+            AutodiffMeta<T> in(node.num_inputs());
+            for (std::size_t j = 0; j < node.num_inputs(); ++j) {
+               in.push_back(engine_.val_buff_[node.get_input(j)]);
+            }
+            in.op_param = node.op_param();
+            AutodiffMeta<T> out = node.apply_forward(in);
+            FUSION_CHECK(out.size() == node.num_outputs(),
+                         "GraphExecutor: node output size mismatch");
+            for (std::size_t i = 0; i < out.size(); ++i) {
+               engine_.val_buff_[node.get_output(i)] = out[i];
+            }
+         } catch (...) {
+            std::lock_guard<std::mutex> lock(s.error_mutex);
+            if (!s.error) {
+               s.error = std::current_exception();
+            }
+            s.failed = true;
+         }
+      }
+
+      // Release consumers even after a failure so the run drains.
+      for (const ValueID out : node.outputs()) {
+         if (static_cast<std::size_t>(out) >= graph.consumed_by().size()) {
+            continue;
+         }
+         for (const ConsumerInfo &c : graph.consumed_by()[out]) {
+            if (s.pending[c.nid].fetch_sub(1, std::memory_order_acq_rel) ==
+                1) {
+               s.ready.push(c.nid);
+            }
+         }
+      }
+      s.finished.fetch_add(1, std::memory_order_acq_rel);
+   }
+};
+
+#endif // EXECUTOR_HPP
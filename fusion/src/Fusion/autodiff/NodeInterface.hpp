@@ -1,6 +1,7 @@
 #ifndef INODE_HPP
 #define INODE_HPP
 
+#include <any>
 #include <memory>
 #include <utility>
 
@@ -34,6 +35,10 @@ template <typename T> class INode {
    ValueID get_input(std::size_t idx) const { return inputs_.at(idx); };
    ValueID get_output(std::size_t idx) const { return outputs_.at(idx); };
 
+   // Op parameters seen at capture time, kept so the node can be replayed.
+   const std::any &op_param() const { return op_param_; }
+   void set_op_param(std::any param) { op_param_ = std::move(param); }
+
    template <class Op>
    explicit INode(Op op)
        : self_(std::make_unique<NodeModel<Op>>(std::move(op))){};
@@ -78,6 +83,7 @@ template <typename T> class INode {
 
    std::vector<ValueID> inputs_;
    std::vector<ValueID> outputs_;
+   std::any op_param_;
 
    void set_input(std::size_t idx, ValueID vid) {
       resize_inputs(idx + 1);
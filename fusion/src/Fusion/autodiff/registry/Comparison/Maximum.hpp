@@ -42,8 +42,8 @@ template <typename T> struct Maximum {
       const RawTensor<T> &y = context.template load<RawTensor<T>>("y");
       const RawTensor<T> &g0 = grad_out.at(0);
       FUSION_CHECK(!g0.empty(), "Maximum::backward: upstream grad is empty");
-      RawTensor<T> gx = g0 * (x >= y);
-      RawTensor<T> gy = g0 * (y > x);
+      RawTensor<T> gx = fusion::math::sum_to_shape(g0 * (x >= y), x.shape());
+      RawTensor<T> gy = fusion::math::sum_to_shape(g0 * (y > x), y.shape());
       GradIn g;
       g.push_back(gx);
       g.push_back(gy);
@@ -23,6 +23,8 @@ template <typename T> struct Add {
       const RawTensor<T> &x = input.at(0);
       const RawTensor<T> &y = input.at(1);
       //      FUSION_ALLOW_SCALAR_BINARY(a, b);
+      context.save("x_shape", x.shape());
+      context.save("y_shape", y.shape());
       RawTensor<T> z = x + y;
       Out out;
       out.push_back(z);
@@ -38,8 +40,12 @@ template <typename T> struct Add {
       RawTensor<T> &g0 = grad_out.at(0);
       FUSION_CHECK(!g0.empty(), "Add::backward: upstream grad is empty");
       const autodiff::NoGradGuard _;
-      RawTensor<T> gx = g0;
-      RawTensor<T> gy = g0;
+      const auto &x_shape =
+          context.template load<std::vector<std::size_t>>("x_shape");
+      const auto &y_shape =
+          context.template load<std::vector<std::size_t>>("y_shape");
+      RawTensor<T> gx = fusion::math::sum_to_shape(g0, x_shape);
+      RawTensor<T> gy = fusion::math::sum_to_shape(g0, y_shape);
       GradIn g;
       g.push_back(gx);
       g.push_back(gy);
@@ -42,8 +42,9 @@ template <typename T> struct Divide {
       const RawTensor<T> &y = context.template load<RawTensor<T>>("y");
       const RawTensor<T> &g0 = grad_out.at(0);
       FUSION_CHECK(!g0.empty(), "Divide::backward: upstream grad is empty");
-      RawTensor<T> gx = g0 / y;
-      RawTensor<T> gy = ((zeros_like(g0) - g0) * x) / (y * y);
+      RawTensor<T> gx = fusion::math::sum_to_shape(g0 / y, x.shape());
+      RawTensor<T> gy = fusion::math::sum_to_shape(
+          ((zeros_like(g0) - g0) * x) / (y * y), y.shape());
       GradIn g;
       g.push_back(gx);
       g.push_back(gy);
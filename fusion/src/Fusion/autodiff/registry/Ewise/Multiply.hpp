@@ -41,8 +41,8 @@ template <typename T> struct Multiply {
       const RawTensor<T> &y = context.template load<RawTensor<T>>("y");
       RawTensor<T> g0 = std::move(grad_out.at(0));
       FUSION_CHECK(!g0.empty(), "Multiply::backward: upstream grad is empty");
-      RawTensor<T> gx = g0 * y;
-      RawTensor<T> gy = g0 * x;
+      RawTensor<T> gx = fusion::math::sum_to_shape(g0 * y, x.shape());
+      RawTensor<T> gy = fusion::math::sum_to_shape(g0 * x, y.shape());
       GradIn g;
       g.push_back(gx);
       g.push_back(gy);
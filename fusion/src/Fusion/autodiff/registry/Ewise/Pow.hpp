@@ -42,8 +42,10 @@ template <typename T> struct Pow {
       const RawTensor<T> &y = context.template load<RawTensor<T>>("y");
       const RawTensor<T> &g0 = grad_out.at(0);
       FUSION_CHECK(!g0.empty(), "Pow::backward: upstream grad is empty");
-      RawTensor<T> gx = (y * x.pow(y - 1)) * g0;
-      RawTensor<T> gy = (x.pow(y) * x.log()) * g0;
+      RawTensor<T> gx =
+          fusion::math::sum_to_shape((y * x.pow(y - 1)) * g0, x.shape());
+      RawTensor<T> gy =
+          fusion::math::sum_to_shape((x.pow(y) * x.log()) * g0, y.shape());
       GradIn g;
       g.push_back(gx);
       g.push_back(gy);
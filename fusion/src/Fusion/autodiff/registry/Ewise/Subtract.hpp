@@ -23,6 +23,8 @@ template <typename T> struct Subtract {
       const auto &y = input.at(1);
       //    FUSION_ALLOW_SCALAR_BINARY(a, b);
       const autodiff::NoGradGuard _;
+      context.save("x_shape", x.shape());
+      context.save("y_shape", y.shape());
       RawTensor<T> z = x - y;
       Out out;
       out.push_back(z);
@@ -38,10 +40,16 @@ template <typename T> struct Subtract {
       RawTensor<T> &g0 = grad_out.at(0);
       FUSION_CHECK(!g0.empty(), "Subtract::backward: upstream grad is empty");
       const autodiff::NoGradGuard _;
-      RawTensor<T> gx = zeros_like(g0) - g0;
+      const auto &x_shape =
+          context.template load<std::vector<std::size_t>>("x_shape");
+      const auto &y_shape =
+          context.template load<std::vector<std::size_t>>("y_shape");
+      RawTensor<T> gx = fusion::math::sum_to_shape(g0, x_shape);
+      RawTensor<T> gy =
+          fusion::math::sum_to_shape(zeros_like(g0) - g0, y_shape);
       GradIn g;
-      g.push_back(g0);
       g.push_back(gx);
+      g.push_back(gy);
       return g;
    }
 };
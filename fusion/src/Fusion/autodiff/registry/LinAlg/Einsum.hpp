@@ -0,0 +1,110 @@
+#ifndef EINSUM_HPP
+#define EINSUM_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Fusion/autodiff/AutodiffMeta.hpp"
+#include "Fusion/autodiff/AutodiffMode.hpp"
+#include "Fusion/autodiff/registry/Operation.hpp"
+#include "Fusion/common/Checks.hpp"
+#include "Fusion/core/RawTensor.hpp"
+#include "Fusion/ops/Einsum.hpp"
+#include "Fusion/ops/OpParams.hpp"
+
+// The gradient of one operand is itself an einsum: the upstream gradient
+// contracted with the other operand, written in the operand's labels.
+// "ij,jk->ik" gives dA = einsum("ik,jk->ij", g, B), dB = einsum("ik,ij->jk",
+// g, A). Labels the operand alone carried were summed out in the forward
+// pass, so its gradient is broadcast back along them.
+template <typename T> struct Einsum {
+   static constexpr std::string_view name = "Einsum";
+   using In = AutodiffMeta<T>;
+   using Out = AutodiffMeta<T>;
+   using GradIn = AutodiffMeta<T>;
+   using GradOut = AutodiffMeta<T>;
+
+   Out forward(Context<T> &context, In &input) {
+      FUSION_CHECK(input.size() == 2, "Einsum requires two inputs");
+      const autodiff::NoGradGuard _;
+      const RawTensor<T> &x = input.at(0);
+      const RawTensor<T> &y = input.at(1);
+      const EinsumParam &p = std::any_cast<const EinsumParam &>(input.op_param);
+      const fusion::math::linalg::EinsumSpec spec =
+          fusion::math::linalg::parse_einsum(p.subscripts, x.rank(), y.rank());
+      context.save("x", x);
+      context.save("y", y);
+      context.save("spec", spec.str());
+      RawTensor<T> z = x.einsum(spec.str(), y);
+      Out out;
+      out.push_back(z);
+      return out;
+   }
+
+   GradIn backward(Context<T> &context, GradOut &grad_out) {
+      if (grad_out.empty()) {
+         return {};
+      }
+      const RawTensor<T> &x = context.template load<RawTensor<T>>("x");
+      const RawTensor<T> &y = context.template load<RawTensor<T>>("y");
+      const std::string &s = context.template load<std::string>("spec");
+      const autodiff::NoGradGuard _;
+      const RawTensor<T> &g0 = grad_out.at(0);
+      FUSION_CHECK(!g0.empty(), "Einsum::backward: upstream grad is empty");
+      const fusion::math::linalg::EinsumSpec spec =
+          fusion::math::linalg::parse_einsum(s, x.rank(), y.rank());
+      RawTensor<T> gx = grad_for(x, spec.a, g0, spec.out, y, spec.b);
+      RawTensor<T> gy = grad_for(y, spec.b, g0, spec.out, x, spec.a);
+      GradIn g;
+      g.push_back(gx);
+      g.push_back(gy);
+      return g;
+   }
+
+ private:
+   static RawTensor<T> grad_for(const RawTensor<T> &t, const std::string &lt,
+                                const RawTensor<T> &g, const std::string &lg,
+                                const RawTensor<T> &p, const std::string &lp) {
+      std::string kept;
+      for (char c : lt) {
+         if (lg.find(c) != std::string::npos ||
+             lp.find(c) != std::string::npos) {
+            kept.push_back(c);
+         }
+      }
+      // A scalar output arrives as shape {1}: give it a spare label, which
+      // the contraction then sums out.
+      std::string lg1 = lg;
+      for (char c = 'a'; lg1.empty(); ++c) {
+         if (lt.find(c) == std::string::npos &&
+             lp.find(c) == std::string::npos) {
+            lg1.push_back(c);
+         }
+      }
+      RawTensor<T> r =
+          fusion::math::linalg::einsum(lg1 + "," + lp + "->" + kept, g, p);
+
+      // Back to t's rank: extent 1 where a label was dropped, and summed to 1
+      // where t was broadcast along a kept label.
+      const std::vector<std::size_t> &target = t.shape();
+      const std::vector<std::size_t> r_shape = r.shape();
+      std::vector<std::size_t> shape(lt.size(), 1);
+      std::vector<std::size_t> reduced(lt.size(), 1);
+      for (std::size_t d = 0, i = 0; d < lt.size(); ++d) {
+         if (i < kept.size() && kept[i] == lt[d]) {
+            shape[d] = r_shape[i++];
+            reduced[d] = (target[d] == 1) ? 1 : shape[d];
+         }
+      }
+      r = fusion::math::sum_to_shape(r.reshape(shape), reduced);
+      if (reduced == target) {
+         return r;
+      }
+      RawTensor<T> zeros(target, std::vector<T>(t.flat_size(), T(0)),
+                         t.dtype(), t.device());
+      return zeros + r;
+   }
+};
+
+#endif // EINSUM_HPP
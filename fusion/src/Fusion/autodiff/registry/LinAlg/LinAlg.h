@@ -1,6 +1,8 @@
 #ifndef LINALG_H
 #define LINALG_H
 
+#include "Einsum.hpp"
+#include "Linear.hpp"
 #include "MatMul.hpp"
 #include "SwapAxes.hpp"
 
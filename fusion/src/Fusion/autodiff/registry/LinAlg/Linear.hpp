@@ -0,0 +1,102 @@
+#ifndef LINEAR_HPP
+#define LINEAR_HPP
+
+#include <string_view>
+#include <vector>
+
+#include "Fusion/autodiff/AutodiffMeta.hpp"
+#include "Fusion/autodiff/AutodiffMode.hpp"
+#include "Fusion/autodiff/registry/Operation.hpp"
+#include "Fusion/common/Checks.hpp"
+#include "Fusion/core/RawTensor.hpp"
+#include "Fusion/cpu/blas/GemmEpilogue.hpp"
+#include "Fusion/ops/OpParams.hpp"
+
+#include "MatMul.hpp"
+
+// y = act(x W^T + b) with inputs {x, W} or {x, W, b}. Backward turns the
+// upstream gradient into dz = g * act'(z) in one pass, then
+//   dx = dz W,   dW = dz^T x,   db = sum of dz over the rows.
+template <typename T> struct Linear {
+   static constexpr std::string_view name = "Linear";
+   using In = AutodiffMeta<T>;
+   using Out = AutodiffMeta<T>;
+   using GradIn = AutodiffMeta<T>;
+   using GradOut = AutodiffMeta<T>;
+
+   Out forward(Context<T> &context, In &input) {
+      FUSION_CHECK(input.size() == 2 || input.size() == 3,
+                   "Linear requires inputs {x, W} or {x, W, b}");
+      const autodiff::NoGradGuard _;
+      const RawTensor<T> &x = input.at(0);
+      const RawTensor<T> &w = input.at(1);
+      const LinearParam &p = std::any_cast<const LinearParam &>(input.op_param);
+      const RawTensor<T> *b = input.size() == 3 ? &input.at(2) : nullptr;
+
+      RawTensor<T> pre;
+      const bool keep_pre =
+          fusion::blas::epilogue::needs_pre_activation(p.activation);
+      RawTensor<T> y = fusion::math::linalg::linear(
+          x, w, b, p.activation, keep_pre ? &pre : nullptr);
+
+      context.save("x", x);
+      context.save("w", w);
+      context.save("y", y);
+      if (keep_pre) {
+         context.save("pre", pre);
+      }
+      context.save("activation", static_cast<int>(p.activation));
+      // Empty without a bias.
+      context.save("b_shape",
+                   b != nullptr ? b->shape() : std::vector<std::size_t>{});
+      Out out;
+      out.push_back(y);
+      return out;
+   }
+
+   GradIn backward(Context<T> &context, GradOut &grad_out) {
+      if (grad_out.empty()) {
+         return {};
+      }
+      const RawTensor<T> &x = context.template load<RawTensor<T>>("x");
+      const RawTensor<T> &w = context.template load<RawTensor<T>>("w");
+      const RawTensor<T> &y = context.template load<RawTensor<T>>("y");
+      const auto act =
+          static_cast<Activation>(context.template load<int>("activation"));
+      const std::vector<std::size_t> &b_shape =
+          context.template load<std::vector<std::size_t>>("b_shape");
+      const RawTensor<T> *pre =
+          fusion::blas::epilogue::needs_pre_activation(act)
+              ? &context.template load<RawTensor<T>>("pre")
+              : nullptr;
+      const autodiff::NoGradGuard _;
+      const RawTensor<T> &g0 = grad_out.at(0);
+      FUSION_CHECK(!g0.empty(), "Linear::backward: upstream grad is empty");
+
+      const RawTensor<T> dz =
+          fusion::math::linalg::activation_backward(g0, y, pre, act);
+      const std::size_t units = w.shape()[0];
+      const std::size_t in = w.shape()[1];
+      const std::size_t rows = dz.flat_size() / units;
+      const RawTensor<T> dz2 = dz.reshape({rows, units});
+      const RawTensor<T> x2 = x.rank() == 2 ? x : x.reshape({rows, in});
+
+      // dx (for 2-D x) and dW may be added straight into their gradient
+      // buffers by the GEMM (matmul_grad).
+      RawTensor<T> gx = x.rank() == 2
+                            ? matmul_grad(grad_out, 0, dz2, w)
+                            : dz2.matmul(w).reshape(x.shape());
+      RawTensor<T> gw = matmul_grad(grad_out, 1, transpose_last2<T>(dz2), x2);
+      GradIn g;
+      g.push_back(gx);
+      g.push_back(gw);
+      if (!b_shape.empty()) {
+         RawTensor<T> gb =
+             dz2.sum(std::vector<std::size_t>{0}, false).reshape(b_shape);
+         g.push_back(gb);
+      }
+      return g;
+   }
+};
+
+#endif // LINEAR_HPP
@@ -1,6 +1,7 @@
 #ifndef MATMUL_HPP
 #define MATMUL_HPP
 
+#include <algorithm>
 #include <string_view>
 #include <vector>
 
@@ -10,14 +11,55 @@
 #include "Fusion/common/Checks.hpp"
 #include "Fusion/core/RawTensor.hpp"
 
+// A strided view, not a copy: matmul passes it to BLAS as op = Trans.
 template <typename T>
 auto transpose_last2(const RawTensor<T> &t) -> RawTensor<T> {
    if (t.rank() < 2) {
       return t;
    }
-   return t.swapaxes(t.rank() - 1, t.rank() - 2);
+   return t.swapaxes_view(-1, -2);
 };
 
+// Whether a @ b (batch dims broadcast) has exactly the shape of dst.
+template <typename T>
+bool matmul_fills(const RawTensor<T> &dst, const RawTensor<T> &a,
+                  const RawTensor<T> &b) {
+   const std::vector<std::size_t> &d = dst.shape();
+   const std::vector<std::size_t> &sa = a.shape();
+   const std::vector<std::size_t> &sb = b.shape();
+   if (d.size() != std::max(sa.size(), sb.size()) ||
+       d[d.size() - 2] != sa[sa.size() - 2] || d.back() != sb.back()) {
+      return false;
+   }
+   for (std::size_t i = 3; i <= d.size(); ++i) {
+      const std::size_t da = i <= sa.size() ? sa[sa.size() - i] : 1;
+      const std::size_t db = i <= sb.size() ? sb[sb.size() - i] : 1;
+      if (da != 1 && db != 1 && da != db) {
+         return false;
+      }
+      if ((da == 1 ? db : da) != d[d.size() - i]) {
+         return false;
+      }
+   }
+   return true;
+}
+
+// a @ b as the gradient of input j. When the engine offered input j's
+// gradient buffer and the product fills it, the GEMM adds the product there
+// (beta = 1) and an uninitialised tensor is returned; otherwise the product.
+template <typename T>
+RawTensor<T> matmul_grad(const AutodiffMeta<T> &grad_out, std::size_t j,
+                         const RawTensor<T> &a, const RawTensor<T> &b) {
+   RawTensor<T> *dst = j < grad_out.accumulate_into.size()
+                           ? grad_out.accumulate_into[j]
+                           : nullptr;
+   if (dst != nullptr && matmul_fills(*dst, a, b)) {
+      dst->addmm_(a, b);
+      return {};
+   }
+   return a.matmul(b);
+}
+
 template <typename T> struct MatMul {
    static constexpr std::string_view name = "MatMul";
    using In = AutodiffMeta<T>;
@@ -52,10 +94,28 @@ template <typename T> struct MatMul {
       const RawTensor<T> &g0 = grad_out.at(0);
       FUSION_CHECK(!g0.empty(), "MatMul::backward: upstream grad is empty");
       FUSION_CHECK(x.rank() >= 2 && y.rank() >= 2, "MatMul: rank must be >= 2");
+      // A gradient that already has its input's shape may be added straight
+      // into that input's gradient buffer (matmul_grad).
       RawTensor<T> yT = transpose_last2<T>(y);
-      RawTensor<T> xT = transpose_last2<T>(x);
-      RawTensor<T> gx = g0.matmul(yT);
-      RawTensor<T> gy = xT.matmul(g0);
+      RawTensor<T> gx = matmul_grad(grad_out, 0, g0, yT);
+      if (gx.is_initialised()) {
+         gx = fusion::math::sum_to_shape(gx, x.shape());
+      }
+      RawTensor<T> gy;
+      if (y.rank() == 2 && x.rank() > 2 && x.is_contiguous() &&
+          g0.is_contiguous()) {
+         // y was shared by every batch entry: its gradient sums over them,
+         // which is one GEMM with the batch folded into K.
+         const std::size_t rows = x.flat_size() / x.shape().back();
+         const RawTensor<T> x2 = x.reshape({rows, x.shape().back()});
+         const RawTensor<T> g2 = g0.reshape({rows, g0.shape().back()});
+         gy = matmul_grad(grad_out, 1, transpose_last2<T>(x2), g2);
+      } else {
+         gy = matmul_grad(grad_out, 1, transpose_last2<T>(x), g0);
+         if (gy.is_initialised()) {
+            gy = fusion::math::sum_to_shape(gy, y.shape());
+         }
+      }
       GradIn g;
       g.push_back(gx);
       g.push_back(gy);
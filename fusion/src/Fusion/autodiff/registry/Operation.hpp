@@ -4,6 +4,7 @@
 #include <any>
 #include <string>
 #include <unordered_map>
+#include <variant>
 #include <vector>
 
 #include "Fusion/common/Checks.hpp"
@@ -15,7 +16,8 @@ template <typename T, typename Enable = void>
 struct static_arity : std::integral_constant<std::size_t, 0> {};
 
 template <typename T> struct Context {
-   using CtxValueType = std::variant<RawTensor<T>, int>;
+   using CtxValueType =
+       std::variant<RawTensor<T>, int, std::vector<std::size_t>, std::string>;
    std::unordered_map<std::string, CtxValueType> saved_result;
 
    template <typename U> void save(std::string key, U &&data) {
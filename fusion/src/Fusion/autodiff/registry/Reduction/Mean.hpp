@@ -7,7 +7,9 @@
 #include "Fusion/autodiff/AutodiffMeta.hpp"
 #include "Fusion/autodiff/AutodiffMode.hpp"
 #include "Fusion/autodiff/registry/Operation.hpp"
+#include "Fusion/core/PlanMeta.hpp"
 #include "Fusion/core/RawTensor.hpp"
+#include "Fusion/ops/OpParams.hpp"
 
 template <typename T> struct Mean {
    static constexpr std::string_view name = "Mean";
@@ -23,9 +25,10 @@ template <typename T> struct Mean {
       context.save("x", x);
       const ReductionParam &p =
           std::any_cast<const ReductionParam &>(input.op_param);
-      RawTensor<T> y = x.mean(p.reduction_axis, p.keepdim);
+      context.save("grad_shape", keepdim_shape(x.shape(), p.reduction_axes));
+      RawTensor<T> y = x.mean(p.reduction_axes, p.keepdim);
       Out out;
-      out.push_back(x);
+      out.push_back(y);
       return out;
    };
 
@@ -40,13 +43,13 @@ template <typename T> struct Mean {
       FUSION_CHECK(!g0.empty(), "Mean::backward: upstream grad is empty");
       const RawTensor<T> &x = context.template load<RawTensor<T>>("x");
       RawTensor<T> gx;
-      if (g0.flat_size() == 1) {
-         gx = ones_like(x) * g0;
-      } else {
-
-         gx = g0;
-      }
-      RawTensor<T> gy = gx * (1.0 / x.size());
+      const auto &grad_shape =
+          context.template load<std::vector<std::size_t>>("grad_shape");
+      // Broadcast the upstream grad back over the reduced axes, scaled by the
+      // number of elements averaged into each output.
+      gx = ones_like(x) * g0.reshape(grad_shape);
+      const std::size_t reduce_len = x.flat_size() / g0.flat_size();
+      RawTensor<T> gy = gx * (T(1) / static_cast<T>(reduce_len));
       GradIn g;
       g.push_back(gy);
       return g;
@@ -3,5 +3,6 @@
 
 #include "Mean.hpp"
 #include "Sum.hpp"
+#include "Variance.hpp"
 
 #endif // REDUCTION_H
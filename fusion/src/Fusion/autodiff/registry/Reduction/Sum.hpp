@@ -7,7 +7,9 @@
 #include "Fusion/autodiff/AutodiffMeta.hpp"
 #include "Fusion/autodiff/AutodiffMode.hpp"
 #include "Fusion/autodiff/registry/Operation.hpp"
+#include "Fusion/core/PlanMeta.hpp"
 #include "Fusion/core/RawTensor.hpp"
+#include "Fusion/ops/OpParams.hpp"
 
 template <typename T> struct Sum {
    static constexpr std::string_view name = "Sum";
@@ -23,7 +25,8 @@ template <typename T> struct Sum {
       const ReductionParam &p =
           std::any_cast<const ReductionParam &>(input.op_param);
       context.save("x", x);
-      RawTensor<T> y = x.sum(p.reduction_axis, p.keepdim);
+      context.save("grad_shape", keepdim_shape(x.shape(), p.reduction_axes));
+      RawTensor<T> y = x.sum(p.reduction_axes, p.keepdim);
       Out out;
       out.push_back(y);
       return out;
@@ -40,11 +43,10 @@ template <typename T> struct Sum {
       FUSION_CHECK(!g0.empty(), "Sum::backward: upstream grad is empty");
       const RawTensor<T> &x = context.template load<RawTensor<T>>("x");
       RawTensor<T> gx;
-      if (g0.flat_size() == 1) {
-         gx = ones_like(x) * g0;
-      } else {
-         gx = g0;
-      }
+      const auto &grad_shape =
+          context.template load<std::vector<std::size_t>>("grad_shape");
+      // Broadcast the upstream grad back over the reduced axes.
+      gx = ones_like(x) * g0.reshape(grad_shape);
       GradIn g;
       g.push_back(gx);
       return g;
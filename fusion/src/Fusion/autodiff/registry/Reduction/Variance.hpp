@@ -0,0 +1,66 @@
+#ifndef VARIANCE_HPP
+#define VARIANCE_HPP
+
+#include <string_view>
+#include <vector>
+
+#include "Fusion/autodiff/AutodiffMeta.hpp"
+#include "Fusion/autodiff/AutodiffMode.hpp"
+#include "Fusion/autodiff/registry/Operation.hpp"
+#include "Fusion/core/PlanMeta.hpp"
+#include "Fusion/core/RawTensor.hpp"
+#include "Fusion/ops/OpParams.hpp"
+
+template <typename T> struct Variance {
+   static constexpr std::string_view name = "Variance";
+   using In = AutodiffMeta<T>;
+   using Out = AutodiffMeta<T>;
+   using GradIn = AutodiffMeta<T>;
+   using GradOut = AutodiffMeta<T>;
+
+   Out forward(Context<T> &context, const In &input) {
+      FUSION_CHECK(!input.empty(), "Variance requires one inputs");
+      const autodiff::NoGradGuard _;
+      const RawTensor<T> &x = input.at(0);
+      const VarianceParam &p =
+          std::any_cast<const VarianceParam &>(input.op_param);
+      context.save("x", x);
+      context.save("axes",
+                   normalise_reduction_axes(p.reduction_axes, x.rank()));
+      context.save("grad_shape", keepdim_shape(x.shape(), p.reduction_axes));
+      context.save("correction", static_cast<int>(p.correction));
+      RawTensor<T> y = x.var(p.reduction_axes, p.keepdim, p.correction);
+      Out out;
+      out.push_back(y);
+      return out;
+   };
+
+   // d var / dx = 2 (x - mean) / (n - correction), broadcast with the
+   // upstream grad over the reduced axes.
+   GradIn backward(Context<T> &context, GradOut &grad_out) {
+      if (grad_out.empty()) {
+         return {};
+      }
+      FUSION_CHECK(grad_out.size() == 1,
+                   "Variance::backward expects exactly 1 upstream grad tensor");
+      const autodiff::NoGradGuard _;
+      RawTensor<T> g0 = grad_out.at(0);
+      FUSION_CHECK(!g0.empty(), "Variance::backward: upstream grad is empty");
+      const RawTensor<T> &x = context.template load<RawTensor<T>>("x");
+      const auto &axes =
+          context.template load<std::vector<std::size_t>>("axes");
+      const auto &grad_shape =
+          context.template load<std::vector<std::size_t>>("grad_shape");
+      const int correction = context.template load<int>("correction");
+      const std::size_t reduce_len = x.flat_size() / g0.flat_size();
+      const T scale = T(2) / static_cast<T>(static_cast<int>(reduce_len) -
+                                            correction);
+      RawTensor<T> centred = x - x.mean(axes, true);
+      RawTensor<T> gx = centred * g0.reshape(grad_shape) * scale;
+      GradIn g;
+      g.push_back(gx);
+      return g;
+   }
+};
+
+#endif // VARIANCE_HPP
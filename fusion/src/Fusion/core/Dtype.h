@@ -2,6 +2,11 @@
 #define DTYPE_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Fusion/core/Float16.hpp"
 
 enum class DType {
    FLOAT32 = 0,
@@ -9,6 +14,9 @@ enum class DType {
    INT32 = 2,
    INT64 = 3,
    BOOL = 4,
+   BFLOAT16 = 5,
+   FLOAT16 = 6,
+   INT8 = 7,
 };
 
 constexpr DType kFloat32 = DType::FLOAT32;
@@ -16,6 +24,31 @@ constexpr DType kFloat64 = DType::FLOAT64;
 constexpr DType kInt32 = DType::INT32;
 constexpr DType kInt64 = DType::INT64;
 constexpr DType kBool = DType::BOOL;
+constexpr DType kBFloat16 = DType::BFLOAT16;
+constexpr DType kFloat16 = DType::FLOAT16;
+constexpr DType kInt8 = DType::INT8;
+
+// The DType tag of element type T; floating types without their own tag are
+// FLOAT32.
+template <typename T> constexpr DType dtype_of() {
+   if constexpr (std::is_same_v<T, double>) {
+      return DType::FLOAT64;
+   } else if constexpr (std::is_same_v<T, fusion::bfloat16>) {
+      return DType::BFLOAT16;
+   } else if constexpr (std::is_same_v<T, fusion::float16>) {
+      return DType::FLOAT16;
+   } else if constexpr (std::is_same_v<T, bool>) {
+      return DType::BOOL;
+   } else if constexpr (std::is_same_v<T, std::int8_t>) {
+      return DType::INT8;
+   } else if constexpr (std::is_same_v<T, std::int32_t>) {
+      return DType::INT32;
+   } else if constexpr (std::is_same_v<T, std::int64_t>) {
+      return DType::INT64;
+   } else {
+      return DType::FLOAT32;
+   }
+}
 
 inline std::size_t get_dtype_size(DType dtype) {
    switch (dtype) {
@@ -29,6 +62,12 @@ inline std::size_t get_dtype_size(DType dtype) {
       return sizeof(int64_t);
    case DType::BOOL:
       return sizeof(bool);
+   case DType::BFLOAT16:
+      return sizeof(fusion::bfloat16);
+   case DType::FLOAT16:
+      return sizeof(fusion::float16);
+   case DType::INT8:
+      return sizeof(std::int8_t);
    }
    throw std::runtime_error("Unknown DType");
 };
@@ -0,0 +1,322 @@
+#ifndef EXPR_HPP
+#define EXPR_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "Fusion/common/Checks.hpp"
+#include "Fusion/cpu/simd/SimdTags.hpp"
+
+#include "Parallel.h"
+#include "PlanMeta.hpp"
+#include "RawTensor.hpp"
+#include "TensorIter.hpp"
+#include "TensorPlan.h"
+
+// Compile-time elementwise fusion. ref(a) * b + c builds a nested expression
+// type whose load() composes the SimdTags functors inline, so assigning it to
+// a RawTensor runs a single loop with no temporaries and no runtime dispatch:
+//
+//    using namespace fusion::expr;
+//    auto e = ref(a) * b + exp(ref(c));
+//    RawTensor<float> r = e;
+//
+// Leaves hold a RawTensor (a shared handle, not a copy of the data), so an
+// expression may outlive the statement that built it. Broadcasting goes
+// through the same BroadcastPlan as the eager ops; when every leaf has the
+// result's shape the loop is one flat run that the compiler vectorises.
+//
+// Plain RawTensor arithmetic stays eager; an expression starts at ref().
+
+namespace fusion::expr {
+
+template <class Derived, typename T> struct Expr {
+   using value_type = T;
+
+   const Derived &self() const { return static_cast<const Derived &>(*this); }
+
+   RawTensor<T> eval() const;
+   operator RawTensor<T>() const { return eval(); }
+};
+
+template <class E>
+concept Expression = requires {
+   typename E::value_type;
+   E::kLeaves;
+} && std::is_base_of_v<Expr<E, typename E::value_type>, E>;
+
+template <typename T> struct TensorRef : Expr<TensorRef<T>, T> {
+   static constexpr std::size_t kLeaves = 1;
+   RawTensor<T> t;
+
+   explicit TensorRef(const RawTensor<T> &x) : t(x) {
+      FUSION_CHECK(x.is_initialised(), "expr: tensor is uninitialised");
+   }
+
+   template <std::size_t I, std::size_t N>
+   void bind(std::array<const RawTensor<T> *, N> &leaves) const {
+      leaves[I] = &t;
+   }
+
+   template <std::size_t I, std::size_t N>
+   T load(const std::array<const T *, N> &p, std::int64_t i) const {
+      return p[I][i];
+   }
+
+   template <std::size_t I, std::size_t N>
+   T load(const std::array<const T *, N> &p,
+          const std::array<std::int64_t, N> &s, std::int64_t i) const {
+      return p[I][i * s[I]];
+   }
+};
+
+template <typename T> struct ScalarRef : Expr<ScalarRef<T>, T> {
+   static constexpr std::size_t kLeaves = 0;
+   T v;
+
+   explicit ScalarRef(const T value) : v(value) {}
+
+   template <std::size_t I, std::size_t N>
+   void bind(std::array<const RawTensor<T> *, N> &) const {}
+
+   template <std::size_t I, std::size_t N>
+   T load(const std::array<const T *, N> &, std::int64_t) const {
+      return v;
+   }
+
+   template <std::size_t I, std::size_t N>
+   T load(const std::array<const T *, N> &,
+          const std::array<std::int64_t, N> &, std::int64_t) const {
+      return v;
+   }
+};
+
+template <class Tag, class L, class R>
+struct BinaryExpr : Expr<BinaryExpr<Tag, L, R>, typename L::value_type> {
+   using T = typename L::value_type;
+   static_assert(std::is_same_v<T, typename R::value_type>,
+                 "expr: operand value types differ");
+   static constexpr std::size_t kLeaves = L::kLeaves + R::kLeaves;
+   L l;
+   R r;
+
+   BinaryExpr(L lhs, R rhs) : l(std::move(lhs)), r(std::move(rhs)) {}
+
+   template <std::size_t I, std::size_t N>
+   void bind(std::array<const RawTensor<T> *, N> &leaves) const {
+      l.template bind<I>(leaves);
+      r.template bind<I + L::kLeaves>(leaves);
+   }
+
+   template <std::size_t I, std::size_t N>
+   T load(const std::array<const T *, N> &p, std::int64_t i) const {
+      return Tag{}(l.template load<I>(p, i),
+                   r.template load<I + L::kLeaves>(p, i));
+   }
+
+   template <std::size_t I, std::size_t N>
+   T load(const std::array<const T *, N> &p,
+          const std::array<std::int64_t, N> &s, std::int64_t i) const {
+      return Tag{}(l.template load<I>(p, s, i),
+                   r.template load<I + L::kLeaves>(p, s, i));
+   }
+};
+
+template <class Tag, class A>
+struct UnaryExpr : Expr<UnaryExpr<Tag, A>, typename A::value_type> {
+   using T = typename A::value_type;
+   static constexpr std::size_t kLeaves = A::kLeaves;
+   A a;
+
+   explicit UnaryExpr(A arg) : a(std::move(arg)) {}
+
+   template <std::size_t I, std::size_t N>
+   void bind(std::array<const RawTensor<T> *, N> &leaves) const {
+      a.template bind<I>(leaves);
+   }
+
+   template <std::size_t I, std::size_t N>
+   T load(const std::array<const T *, N> &p, std::int64_t i) const {
+      return Tag{}(a.template load<I>(p, i));
+   }
+
+   template <std::size_t I, std::size_t N>
+   T load(const std::array<const T *, N> &p,
+          const std::array<std::int64_t, N> &s, std::int64_t i) const {
+      return Tag{}(a.template load<I>(p, s, i));
+   }
+};
+
+// Flat runs of at least this many elements are split across threads.
+constexpr std::size_t kExprGrain = std::size_t{1} << 15;
+
+template <class Derived, typename T>
+RawTensor<T> Expr<Derived, T>::eval() const {
+   constexpr std::size_t N = Derived::kLeaves;
+   static_assert(N > 0, "expr: expression has no tensor operand");
+   const Derived &e = self();
+
+   std::array<const RawTensor<T> *, N> leaves{};
+   e.template bind<0>(leaves);
+   std::array<const T *, N> p{};
+   bool same = true;
+   for (std::size_t k = 0; k < N; ++k) {
+      FUSION_CHECK(leaves[k]->dtype() == leaves[0]->dtype(),
+                   "expr: dtypes do not match");
+      p[k] = leaves[k]->get_ptr();
+      same = same && leaves[k]->shape() == leaves[0]->shape() &&
+             leaves[k]->is_contiguous();
+   }
+
+   if (same) {
+      RawTensor<T> out(leaves[0]->shape(), leaves[0]->dtype(),
+                       leaves[0]->device());
+      T *o = out.get_ptr();
+      fusion::parallel::parallel_for(
+          0, out.flat_size(), kExprGrain, [&](std::size_t lo, std::size_t hi) {
+             for (std::size_t i = lo; i < hi; ++i) {
+                o[i] = e.template load<0>(p, static_cast<std::int64_t>(i));
+             }
+          });
+      return out;
+   }
+
+   // Leaves keep their own strides, so views (transposed, sliced) are read
+   // in place; only the output is built contiguous.
+   std::vector<TensorDescription> descs;
+   descs.reserve(N + 1);
+   for (std::size_t k = 0; k < N; ++k) {
+      descs.push_back(make_desc_from_tensor(*leaves[k]));
+   }
+   const std::vector<std::size_t> out_shape =
+       make_broadcast_plan(descs).out_shape;
+   descs.insert(descs.begin(), make_desc_from_shape<T>(out_shape, nullptr));
+   const BroadcastPlan plan = make_broadcast_plan(descs);
+
+   RawTensor<T> out(out_shape, leaves[0]->dtype(), leaves[0]->device());
+   std::array<std::uint8_t *, N + 1> base{};
+   base[0] = reinterpret_cast<std::uint8_t *>(out.get_ptr());
+   for (std::size_t k = 0; k < N; ++k) {
+      base[k + 1] = reinterpret_cast<std::uint8_t *>(const_cast<T *>(p[k]));
+   }
+
+   fusion::iter::for_each_outer_then_inner<BroadcastPlan, N + 1>(
+       plan, base,
+       [&](std::array<std::uint8_t *, N + 1> &ptr, std::int64_t len,
+           const std::vector<std::int64_t> &sbytes) {
+          const auto step = static_cast<std::int64_t>(sizeof(T));
+          T *o = reinterpret_cast<T *>(ptr[0]);
+          const std::int64_t so = sbytes[0] / step;
+          std::array<const T *, N> q{};
+          std::array<std::int64_t, N> s{};
+          bool unit = so == 1;
+          for (std::size_t k = 0; k < N; ++k) {
+             q[k] = reinterpret_cast<const T *>(ptr[k + 1]);
+             s[k] = sbytes[k + 1] / step;
+             unit = unit && s[k] == 1;
+          }
+          if (unit) {
+             for (std::int64_t i = 0; i < len; ++i) {
+                o[i] = e.template load<0>(q, i);
+             }
+          } else {
+             for (std::int64_t i = 0; i < len; ++i) {
+                o[i * so] = e.template load<0>(q, s, i);
+             }
+          }
+       });
+   return out;
+}
+
+template <class X> struct is_raw_tensor : std::false_type {};
+template <typename T> struct is_raw_tensor<RawTensor<T>> : std::true_type {};
+
+template <class X>
+concept Operand = Expression<X> || is_raw_tensor<X>::value ||
+                  std::is_arithmetic_v<X>;
+
+template <class L, class R> struct value_type_of {
+   using type = typename std::conditional_t<Expression<L> ||
+                                                is_raw_tensor<L>::value,
+                                            L, R>::value_type;
+};
+
+// Lifts an operand to an expression node of value type T.
+template <typename T, class X> auto wrap(const X &x) {
+   if constexpr (Expression<X>) {
+      return x;
+   } else if constexpr (is_raw_tensor<X>::value) {
+      return TensorRef<T>(x);
+   } else {
+      return ScalarRef<T>(static_cast<T>(x));
+   }
+}
+
+template <class Tag, class L, class R>
+auto make_binary(const L &l, const R &r) {
+   using T = typename value_type_of<L, R>::type;
+   auto lw = wrap<T>(l);
+   auto rw = wrap<T>(r);
+   return BinaryExpr<Tag, decltype(lw), decltype(rw)>(std::move(lw),
+                                                      std::move(rw));
+}
+
+// Starts an expression from a tensor.
+template <typename T> inline TensorRef<T> ref(const RawTensor<T> &x) {
+   return TensorRef<T>(x);
+}
+
+template <class L, class R>
+   requires(Expression<L> || Expression<R>) && Operand<L> && Operand<R>
+auto operator+(const L &l, const R &r) {
+   return make_binary<AddSIMD>(l, r);
+}
+
+template <class L, class R>
+   requires(Expression<L> || Expression<R>) && Operand<L> && Operand<R>
+auto operator-(const L &l, const R &r) {
+   return make_binary<SubtractSIMD>(l, r);
+}
+
+template <class L, class R>
+   requires(Expression<L> || Expression<R>) && Operand<L> && Operand<R>
+auto operator*(const L &l, const R &r) {
+   return make_binary<MultiplySIMD>(l, r);
+}
+
+template <class L, class R>
+   requires(Expression<L> || Expression<R>) && Operand<L> && Operand<R>
+auto operator/(const L &l, const R &r) {
+   return make_binary<DivideSIMD>(l, r);
+}
+
+template <class L, class R>
+   requires(Expression<L> || Expression<R>) && Operand<L> && Operand<R>
+auto maximum(const L &l, const R &r) {
+   return make_binary<MaximumSIMD>(l, r);
+}
+
+template <class L, class R>
+   requires(Expression<L> || Expression<R>) && Operand<L> && Operand<R>
+auto pow(const L &l, const R &r) {
+   return make_binary<PowerSIMD>(l, r);
+}
+
+template <Expression A> auto exp(const A &a) {
+   return UnaryExpr<ExponentialSIMD, A>(a);
+}
+
+template <Expression A> auto log(const A &a) {
+   return UnaryExpr<NaturalLogSIMD, A>(a);
+}
+
+template <Expression A> auto sqrt(const A &a) {
+   return UnaryExpr<SqrtSIMD, A>(a);
+}
+
+} // namespace fusion::expr
+
+#endif // EXPR_HPP
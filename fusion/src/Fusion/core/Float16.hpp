@@ -0,0 +1,217 @@
+#ifndef FUSION_CORE_FLOAT16_HPP
+#define FUSION_CORE_FLOAT16_HPP
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(__F16C__) || defined(__AVX512BF16__)
+#include <immintrin.h>
+#endif
+
+// 16-bit floating-point storage types. They hold the bits only: every
+// arithmetic expression converts to float, computes there and rounds back
+// (to nearest, ties to even) when the result is stored, so a 16-bit tensor
+// moves half the bytes of a float one and computes like it. Kernels that
+// accumulate (sums, dots, GEMM) keep the running value in accum_t<T>.
+namespace fusion {
+
+namespace detail {
+
+inline float bf16_bits_to_float(std::uint16_t h) noexcept {
+   return std::bit_cast<float>(static_cast<std::uint32_t>(h) << 16);
+}
+
+inline std::uint16_t float_to_bf16_bits(float f) noexcept {
+#if defined(__AVX512BF16__) && defined(__AVX512VL__)
+   return std::bit_cast<std::uint16_t>(_mm_cvtness_sbh(f));
+#else
+   const auto x = std::bit_cast<std::uint32_t>(f);
+   if ((x & 0x7fffffffu) > 0x7f800000u) {
+      return static_cast<std::uint16_t>((x >> 16) | 0x40u); // quiet NaN
+   }
+   const std::uint32_t rounding = 0x7fffu + ((x >> 16) & 1u);
+   return static_cast<std::uint16_t>((x + rounding) >> 16);
+#endif
+}
+
+inline float fp16_bits_to_float(std::uint16_t h) noexcept {
+#if defined(__F16C__)
+   return _cvtsh_ss(h);
+#else
+   const std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000u) << 16;
+   const std::uint32_t exp = (h >> 10) & 0x1fu;
+   const std::uint32_t mant = h & 0x3ffu;
+   if (exp == 0) {
+      // Zero or subnormal: mant * 2^-24.
+      const float v = static_cast<float>(mant) * 0x1p-24f;
+      return sign != 0 ? -v : v;
+   }
+   if (exp == 0x1fu) {
+      return std::bit_cast<float>(sign | 0x7f800000u | (mant << 13));
+   }
+   return std::bit_cast<float>(sign | ((exp + 112u) << 23) | (mant << 13));
+#endif
+}
+
+inline std::uint16_t float_to_fp16_bits(float f) noexcept {
+#if defined(__F16C__)
+   return _cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT);
+#else
+   std::uint32_t x = std::bit_cast<std::uint32_t>(f);
+   const auto sign = static_cast<std::uint16_t>((x >> 16) & 0x8000u);
+   x &= 0x7fffffffu;
+   if (x >= 0x7f800000u) { // inf or NaN
+      return static_cast<std::uint16_t>(sign |
+                                        (x > 0x7f800000u ? 0x7e00u : 0x7c00u));
+   }
+   if (x >= 0x477ff000u) { // rounds past 65504
+      return static_cast<std::uint16_t>(sign | 0x7c00u);
+   }
+   if (x < 0x38800000u) { // below 2^-14: subnormal or zero
+      if (x < 0x33000000u) {
+         return sign;
+      }
+      const std::uint32_t mant = (x & 0x7fffffu) | 0x800000u;
+      const std::uint32_t shift = 126u - (x >> 23);
+      std::uint32_t h = mant >> shift;
+      const std::uint32_t rest = mant & ((1u << shift) - 1u);
+      const std::uint32_t half = 1u << (shift - 1u);
+      if (rest > half || (rest == half && (h & 1u) != 0)) {
+         ++h;
+      }
+      return static_cast<std::uint16_t>(sign | h);
+   }
+   std::uint32_t h = (x - 0x38000000u) >> 13;
+   const std::uint32_t rest = x & 0x1fffu;
+   if (rest > 0x1000u || (rest == 0x1000u && (h & 1u) != 0)) {
+      ++h; // a carry out of the mantissa bumps the exponent, up to inf
+   }
+   return static_cast<std::uint16_t>(sign | h);
+#endif
+}
+
+// Shared by both formats; ToFloat and FromFloat convert the bits.
+template <class Derived, float (*ToFloat)(std::uint16_t),
+          std::uint16_t (*FromFloat)(float)>
+struct Float16Base {
+   std::uint16_t bits = 0;
+
+   Float16Base() = default;
+   Float16Base(float f) noexcept : bits(FromFloat(f)) {}
+
+   static Derived from_bits(std::uint16_t b) noexcept {
+      Derived d;
+      d.bits = b;
+      return d;
+   }
+
+   operator float() const noexcept { return ToFloat(bits); }
+
+   // Built-in compound assignment takes no user conversion on its left
+   // operand, so these go through float explicitly.
+   Derived &operator+=(float x) noexcept { return assign(float(*this) + x); }
+   Derived &operator-=(float x) noexcept { return assign(float(*this) - x); }
+   Derived &operator*=(float x) noexcept { return assign(float(*this) * x); }
+   Derived &operator/=(float x) noexcept { return assign(float(*this) / x); }
+
+ private:
+   Derived &assign(float f) noexcept {
+      bits = FromFloat(f);
+      return static_cast<Derived &>(*this);
+   }
+};
+
+} // namespace detail
+
+// bfloat16: float's 8-bit exponent, 7-bit mantissa.
+struct bfloat16
+    : detail::Float16Base<bfloat16, detail::bf16_bits_to_float,
+                          detail::float_to_bf16_bits> {
+   using Float16Base::Float16Base;
+};
+
+// IEEE 754 binary16: 5-bit exponent, 10-bit mantissa.
+struct float16
+    : detail::Float16Base<float16, detail::fp16_bits_to_float,
+                          detail::float_to_fp16_bits> {
+   using Float16Base::Float16Base;
+};
+
+static_assert(sizeof(bfloat16) == 2 && sizeof(float16) == 2);
+
+template <typename T>
+inline constexpr bool is_half_float_v =
+    std::is_same_v<T, bfloat16> || std::is_same_v<T, float16>;
+
+template <typename T>
+concept HalfFloat = is_half_float_v<T>;
+
+// Type a kernel accumulates T in: float for the 16-bit types, T otherwise.
+template <typename T>
+using accum_t = std::conditional_t<is_half_float_v<T>, float, T>;
+
+} // namespace fusion
+
+template <>
+struct std::numeric_limits<fusion::bfloat16> : std::numeric_limits<float> {
+   static constexpr int digits = 8;
+   static constexpr int digits10 = 2;
+   static constexpr int max_digits10 = 4;
+   static fusion::bfloat16 min() noexcept {
+      return fusion::bfloat16::from_bits(0x0080);
+   }
+   static fusion::bfloat16 denorm_min() noexcept {
+      return fusion::bfloat16::from_bits(0x0001);
+   }
+   static fusion::bfloat16 quiet_NaN() noexcept {
+      return fusion::bfloat16::from_bits(0x7fc0);
+   }
+   static fusion::bfloat16 infinity() noexcept {
+      return fusion::bfloat16::from_bits(0x7f80);
+   }
+   static fusion::bfloat16 lowest() noexcept {
+      return fusion::bfloat16::from_bits(0xff7f);
+   }
+   static fusion::bfloat16 max() noexcept {
+      return fusion::bfloat16::from_bits(0x7f7f);
+   }
+   static fusion::bfloat16 epsilon() noexcept {
+      return fusion::bfloat16::from_bits(0x3c00);
+   }
+};
+
+template <>
+struct std::numeric_limits<fusion::float16> : std::numeric_limits<float> {
+   static constexpr int digits = 11;
+   static constexpr int digits10 = 3;
+   static constexpr int max_digits10 = 5;
+   static constexpr int min_exponent = -13;
+   static constexpr int min_exponent10 = -4;
+   static constexpr int max_exponent = 16;
+   static constexpr int max_exponent10 = 4;
+   static fusion::float16 min() noexcept {
+      return fusion::float16::from_bits(0x0400);
+   }
+   static fusion::float16 denorm_min() noexcept {
+      return fusion::float16::from_bits(0x0001);
+   }
+   static fusion::float16 quiet_NaN() noexcept {
+      return fusion::float16::from_bits(0x7e00);
+   }
+   static fusion::float16 infinity() noexcept {
+      return fusion::float16::from_bits(0x7c00);
+   }
+   static fusion::float16 lowest() noexcept {
+      return fusion::float16::from_bits(0xfbff);
+   }
+   static fusion::float16 max() noexcept {
+      return fusion::float16::from_bits(0x7bff);
+   }
+   static fusion::float16 epsilon() noexcept {
+      return fusion::float16::from_bits(0x1400);
+   }
+};
+
+#endif // FUSION_CORE_FLOAT16_HPP
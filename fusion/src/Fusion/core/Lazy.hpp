@@ -0,0 +1,510 @@
+#ifndef LAZY_HPP
+#define LAZY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Fusion/common/Checks.hpp"
+#include "Fusion/cpu/simd/SimdTags.hpp"
+#include "Fusion/cpu/simd/SimdTraits.hpp"
+
+#include "Parallel.h"
+#include "RawTensor.hpp"
+#include "TreeReduce.hpp"
+
+// Deferred elementwise evaluation. Arithmetic on a LazyTensor records a small
+// expression DAG instead of running. materialize(), or a global sum/mean,
+// then evaluates the whole DAG in one pass over tiles of kLazyTile elements:
+// intermediates live in per-tile scratch that stays in L1, and every node
+// still runs through simd_traits, so the kernels are the same vectorised ones
+// the eager ops use. ((y - p) * (y - p)).mean() reads y and p once; beyond
+// the tile scratch it allocates only a partial sum per kTreeChunk chunk,
+// never a tensor-sized intermediate.
+//
+// Operands must match the node's shape or hold a single element; single
+// elements are evaluated once, outside the tile loop. Any other broadcast
+// evaluates that node eagerly and carries on lazily from its result.
+
+namespace fusion::lazy {
+
+// Elements per tile. A few dozen live intermediates of this size fit in L1.
+constexpr std::size_t kLazyTile = 1024;
+
+enum class LazyOp : std::uint8_t {
+   Leaf,
+   Constant,
+   Add,
+   Subtract,
+   Multiply,
+   Divide,
+   Pow,
+   Maximum,
+   Exp,
+   Log,
+   Sqrt,
+};
+
+template <typename T> struct LazyNode {
+   LazyOp op = LazyOp::Leaf;
+   std::vector<std::size_t> shape;
+   std::shared_ptr<const LazyNode> lhs;
+   std::shared_ptr<const LazyNode> rhs;
+   RawTensor<T> leaf;
+   T constant{0};
+   DType dtype = dtype_of<T>();
+   Device device{DeviceType::CPU, 0};
+};
+
+inline std::size_t flat_size(const std::vector<std::size_t> &shape) {
+   std::size_t n = 1;
+   for (auto d : shape) {
+      n *= d;
+   }
+   return n;
+}
+
+template <typename T> inline T apply_scalar(LazyOp op, T a, T b) {
+   switch (op) {
+   case LazyOp::Add:
+      return AddSIMD{}(a, b);
+   case LazyOp::Subtract:
+      return SubtractSIMD{}(a, b);
+   case LazyOp::Multiply:
+      return MultiplySIMD{}(a, b);
+   case LazyOp::Divide:
+      return DivideSIMD{}(a, b);
+   case LazyOp::Pow:
+      return PowerSIMD{}(a, b);
+   case LazyOp::Maximum:
+      return MaximumSIMD{}(a, b);
+   case LazyOp::Exp:
+      return ExponentialSIMD{}(a);
+   case LazyOp::Log:
+      return NaturalLogSIMD{}(a);
+   case LazyOp::Sqrt:
+      return SqrtSIMD{}(a);
+   default:
+      FUSION_CHECK(false, "lazy: not an arithmetic op");
+      return T(0);
+   }
+}
+
+template <typename T>
+inline void apply_contiguous(LazyOp op, const T *a, const T *b, T *out,
+                             std::size_t n, bool a_scalar, bool b_scalar) {
+   switch (op) {
+   case LazyOp::Add:
+      return simd_traits<AddSIMD, T>::execute_contiguous(a, b, out, n,
+                                                         a_scalar, b_scalar);
+   case LazyOp::Subtract:
+      return simd_traits<SubtractSIMD, T>::execute_contiguous(
+          a, b, out, n, a_scalar, b_scalar);
+   case LazyOp::Multiply:
+      return simd_traits<MultiplySIMD, T>::execute_contiguous(
+          a, b, out, n, a_scalar, b_scalar);
+   case LazyOp::Divide:
+      return simd_traits<DivideSIMD, T>::execute_contiguous(
+          a, b, out, n, a_scalar, b_scalar);
+   case LazyOp::Pow:
+      return simd_traits<PowerSIMD, T>::execute_contiguous(a, b, out, n,
+                                                           a_scalar, b_scalar);
+   case LazyOp::Maximum:
+      return simd_traits<MaximumSIMD, T>::execute_contiguous(
+          a, b, out, n, a_scalar, b_scalar);
+   case LazyOp::Exp:
+      return simd_traits<ExponentialSIMD, T>::execute_contiguous(a, out, n,
+                                                                 false);
+   case LazyOp::Log:
+      return simd_traits<NaturalLogSIMD, T>::execute_contiguous(a, out, n,
+                                                                false);
+   case LazyOp::Sqrt:
+      return simd_traits<SqrtSIMD, T>::execute_contiguous(a, out, n, false);
+   default:
+      FUSION_CHECK(false, "lazy: not an arithmetic op");
+   }
+}
+
+// The eager op for a node whose operands need a general broadcast.
+template <typename T>
+inline RawTensor<T> apply_eager(LazyOp op, const RawTensor<T> &a,
+                                const RawTensor<T> &b) {
+   switch (op) {
+   case LazyOp::Add:
+      return fusion::math::add(a, b);
+   case LazyOp::Subtract:
+      return fusion::math::sub(a, b);
+   case LazyOp::Multiply:
+      return fusion::math::mul(a, b);
+   case LazyOp::Divide:
+      return fusion::math::div(a, b);
+   case LazyOp::Pow:
+      return fusion::math::pow(a, b);
+   case LazyOp::Maximum:
+      return fusion::math::maximum(a, b);
+   default:
+      FUSION_CHECK(false, "lazy: not a binary op");
+      return a;
+   }
+}
+
+// A DAG flattened into topological order. Shared subexpressions appear once.
+// Single-element nodes are folded to values up front ("hoisted"); every
+// other op node gets a scratch slot, reused once its last consumer has run.
+template <typename T> class LazyProgram {
+ public:
+   explicit LazyProgram(const std::shared_ptr<const LazyNode<T>> &root) {
+      std::unordered_map<const LazyNode<T> *, int> index;
+      emit(root, index);
+      allocate_slots();
+   }
+
+   std::size_t size() const noexcept { return code_.size(); }
+   std::size_t num_slots() const noexcept { return num_slots_; }
+   bool hoisted_root() const { return code_.back().hoisted; }
+   T root_value() const { return code_.back().value; }
+
+   // Evaluates elements [begin, begin + len) of the root into out. scratch
+   // holds num_slots() tiles; src holds size() pointers.
+   void run_tile(std::size_t begin, std::size_t len, T *out, T *scratch,
+                 const T **src) const {
+      const std::size_t root = code_.size() - 1;
+      for (std::size_t i = 0; i < code_.size(); ++i) {
+         const Instr &ins = code_[i];
+         if (ins.hoisted) {
+            src[i] = &ins.value;
+            continue;
+         }
+         if (ins.op == LazyOp::Leaf) {
+            src[i] = ins.data + begin;
+            if (i == root) {
+               std::copy(src[i], src[i] + len, out);
+            }
+            continue;
+         }
+         T *dst = (i == root) ? out : scratch + ins.slot * kLazyTile;
+         const T *b = ins.b >= 0 ? src[ins.b] : nullptr;
+         const bool b_scalar = ins.b >= 0 && code_[ins.b].hoisted;
+         apply_contiguous(ins.op, src[ins.a], b, dst, len,
+                          code_[ins.a].hoisted, b_scalar);
+         src[i] = dst;
+      }
+   }
+
+ private:
+   struct Instr {
+      LazyOp op = LazyOp::Leaf;
+      int a = -1;
+      int b = -1;
+      const T *data = nullptr;
+      T value{0};
+      bool hoisted = false;
+      std::size_t slot = 0;
+   };
+
+   std::vector<Instr> code_;
+   std::size_t num_slots_ = 0;
+
+   int emit(const std::shared_ptr<const LazyNode<T>> &node,
+            std::unordered_map<const LazyNode<T> *, int> &index) {
+      if (auto it = index.find(node.get()); it != index.end()) {
+         return it->second;
+      }
+      Instr ins;
+      ins.op = node->op;
+      if (node->lhs) {
+         ins.a = emit(node->lhs, index);
+      }
+      if (node->rhs) {
+         ins.b = emit(node->rhs, index);
+      }
+      if (node->op == LazyOp::Constant) {
+         ins.hoisted = true;
+         ins.value = node->constant;
+      } else if (node->op == LazyOp::Leaf) {
+         ins.data = node->leaf.get_ptr();
+         if (node->leaf.flat_size() == 1) {
+            ins.hoisted = true;
+            ins.value = *ins.data;
+         }
+      } else if (flat_size(node->shape) == 1) {
+         ins.hoisted = true;
+         const T a = code_[ins.a].value;
+         const T b = ins.b >= 0 ? code_[ins.b].value : T(0);
+         ins.value = apply_scalar(node->op, a, b);
+      }
+      code_.push_back(ins);
+      const int id = static_cast<int>(code_.size() - 1);
+      index.emplace(node.get(), id);
+      return id;
+   }
+
+   void allocate_slots() {
+      std::vector<std::size_t> last_use(code_.size(), 0);
+      for (std::size_t i = 0; i < code_.size(); ++i) {
+         if (code_[i].a >= 0) {
+            last_use[code_[i].a] = i;
+         }
+         if (code_[i].b >= 0) {
+            last_use[code_[i].b] = i;
+         }
+      }
+      std::vector<std::size_t> free_slots;
+      auto needs_slot = [&](std::size_t i) {
+         return !code_[i].hoisted && code_[i].op != LazyOp::Leaf &&
+                i + 1 != code_.size();
+      };
+      for (std::size_t i = 0; i < code_.size(); ++i) {
+         // The result never shares a slot with an operand: the kernels take
+         // __restrict pointers.
+         if (needs_slot(i)) {
+            if (free_slots.empty()) {
+               code_[i].slot = num_slots_++;
+            } else {
+               code_[i].slot = free_slots.back();
+               free_slots.pop_back();
+            }
+         }
+         // t * t reads one operand twice; its slot is freed once.
+         const int a = code_[i].a;
+         const int b = code_[i].b != a ? code_[i].b : -1;
+         for (const int in : {a, b}) {
+            if (in >= 0 && last_use[in] == i && needs_slot(in)) {
+               free_slots.push_back(code_[in].slot);
+            }
+         }
+      }
+   }
+};
+
+template <typename T> class LazyTensor {
+ public:
+   using Node = LazyNode<T>;
+
+   // Implicit, so RawTensors and scalars mix freely with lazy operands.
+   LazyTensor(const RawTensor<T> &x) {
+      FUSION_CHECK(x.is_initialised(), "lazy: tensor is uninitialised");
+      FUSION_CHECK(x.is_contiguous(), "lazy: tensor must be contiguous");
+      auto n = std::make_shared<Node>();
+      n->op = LazyOp::Leaf;
+      n->shape = x.shape();
+      n->leaf = x;
+      n->dtype = x.dtype();
+      n->device = x.device();
+      node_ = std::move(n);
+   }
+
+   LazyTensor(const T value) {
+      auto n = std::make_shared<Node>();
+      n->op = LazyOp::Constant;
+      n->shape = {1};
+      n->constant = value;
+      node_ = std::move(n);
+   }
+
+   const std::vector<std::size_t> &shape() const { return node_->shape; }
+   const std::shared_ptr<const Node> &node() const { return node_; }
+
+   friend LazyTensor operator+(const LazyTensor &a, const LazyTensor &b) {
+      return binary(LazyOp::Add, a, b);
+   }
+   friend LazyTensor operator-(const LazyTensor &a, const LazyTensor &b) {
+      return binary(LazyOp::Subtract, a, b);
+   }
+   friend LazyTensor operator*(const LazyTensor &a, const LazyTensor &b) {
+      return binary(LazyOp::Multiply, a, b);
+   }
+   friend LazyTensor operator/(const LazyTensor &a, const LazyTensor &b) {
+      return binary(LazyOp::Divide, a, b);
+   }
+
+   LazyTensor pow(const LazyTensor &e) const {
+      return binary(LazyOp::Pow, *this, e);
+   }
+   LazyTensor maximum(const LazyTensor &o) const {
+      return binary(LazyOp::Maximum, *this, o);
+   }
+   LazyTensor exp() const { return unary(LazyOp::Exp, *this); }
+   LazyTensor log() const { return unary(LazyOp::Log, *this); }
+   LazyTensor sqrt() const { return unary(LazyOp::Sqrt, *this); }
+
+   // Runs the DAG once, tile by tile, into a new tensor.
+   RawTensor<T> materialize() const {
+      LazyProgram<T> prog(node_);
+      RawTensor<T> out(node_->shape, node_->dtype, node_->device);
+      T *o = out.get_ptr();
+      const std::size_t n = out.flat_size();
+      if (prog.hoisted_root()) {
+         std::fill(o, o + n, prog.root_value());
+         return out;
+      }
+      const std::size_t tiles = (n + kLazyTile - 1) / kLazyTile;
+      fusion::parallel::parallel_for(
+          0, tiles, kTilesPerTask, [&](std::size_t lo, std::size_t hi) {
+             std::vector<T> scratch(prog.num_slots() * kLazyTile);
+             std::vector<const T *> src(prog.size());
+             for (std::size_t t = lo; t < hi; ++t) {
+                const std::size_t begin = t * kLazyTile;
+                const std::size_t len = std::min(kLazyTile, n - begin);
+                prog.run_tile(begin, len, o + begin, scratch.data(),
+                              src.data());
+             }
+          });
+      return out;
+   }
+
+   // Sum over every element without materialising. Tiles are grouped into
+   // fixed kTreeChunk-sized leaves and folded pairwise, so the bits do not
+   // depend on the thread count.
+   T sum() const {
+      LazyProgram<T> prog(node_);
+      const std::size_t n = flat_size(node_->shape);
+      if (n == 0) {
+         return T(0);
+      }
+      if (prog.hoisted_root()) {
+         return prog.root_value() * static_cast<T>(n);
+      }
+      const std::size_t chunks =
+          (n + fusion::reduce::kTreeChunk - 1) / fusion::reduce::kTreeChunk;
+      // Tiles, chunks and the combine accumulate in accum_t<T>.
+      using A = fusion::accum_t<T>;
+      std::vector<A> partial(chunks, A(0));
+      fusion::parallel::parallel_for(
+          0, chunks, 1, [&](std::size_t lo, std::size_t hi) {
+             std::vector<T> scratch((prog.num_slots() + 1) * kLazyTile);
+             std::vector<const T *> src(prog.size());
+             T *tile = scratch.data() + prog.num_slots() * kLazyTile;
+             for (std::size_t c = lo; c < hi; ++c) {
+                const std::size_t end =
+                    std::min(n, (c + 1) * fusion::reduce::kTreeChunk);
+                A acc = A(0);
+                for (std::size_t begin = c * fusion::reduce::kTreeChunk;
+                     begin < end; begin += kLazyTile) {
+                   const std::size_t len = std::min(kLazyTile, end - begin);
+                   prog.run_tile(begin, len, tile, scratch.data(), src.data());
+                   acc += simd_traits<SumSIMD, T>::reduce_contiguous(tile, len);
+                }
+                partial[c] = acc;
+             }
+          });
+      for (std::size_t w = 1; w < chunks; w *= 2) {
+         for (std::size_t i = 0; i + w < chunks; i += 2 * w) {
+            partial[i] += partial[i + w];
+         }
+      }
+      return T(partial[0]);
+   }
+
+   T mean() const {
+      return sum() / static_cast<T>(flat_size(node_->shape));
+   }
+
+   // Reductions and matmul consume the DAG: a global sum/mean is fused into
+   // the tile loop; anything else materialises first.
+   RawTensor<T> sum(const std::vector<std::size_t> &axes,
+                    const bool keepdim) const {
+      if (axes.empty()) {
+         return scalar_result(sum(), keepdim);
+      }
+      return materialize().sum(axes, keepdim);
+   }
+
+   RawTensor<T> mean(const std::vector<std::size_t> &axes,
+                     const bool keepdim) const {
+      if (axes.empty()) {
+         return scalar_result(mean(), keepdim);
+      }
+      return materialize().mean(axes, keepdim);
+   }
+
+   RawTensor<T> matmul(const RawTensor<T> &other) const {
+      return materialize().matmul(other);
+   }
+
+ private:
+   static constexpr std::size_t kTilesPerTask = 16;
+
+   std::shared_ptr<const Node> node_;
+
+   explicit LazyTensor(std::shared_ptr<const Node> node)
+       : node_(std::move(node)) {}
+
+   RawTensor<T> scalar_result(const T value, const bool keepdim) const {
+      std::vector<std::size_t> shape =
+          keepdim ? std::vector<std::size_t>(node_->shape.size(), 1)
+                  : std::vector<std::size_t>{1};
+      return RawTensor<T>(shape, std::vector<T>{value}, node_->dtype,
+                          node_->device);
+   }
+
+   // Shape of a op b when no general broadcast is needed: equal shapes, or
+   // one side a single element. Empty when the eager path must run.
+   static std::vector<std::size_t> fused_shape(const Node &a, const Node &b) {
+      if (a.shape == b.shape) {
+         return a.shape;
+      }
+      const bool a_one = flat_size(a.shape) == 1;
+      const bool b_one = flat_size(b.shape) == 1;
+      if (!a_one && !b_one) {
+         return {};
+      }
+      const auto &big = a_one ? b.shape : a.shape;
+      const auto &one = a_one ? a.shape : b.shape;
+      if (one.size() <= big.size()) {
+         return big;
+      }
+      std::vector<std::size_t> shape(one.size() - big.size(), 1);
+      shape.insert(shape.end(), big.begin(), big.end());
+      return shape;
+   }
+
+   static LazyTensor binary(LazyOp op, const LazyTensor &a,
+                            const LazyTensor &b) {
+      const Node &na = *a.node_;
+      const Node &nb = *b.node_;
+      if (na.op == LazyOp::Constant && nb.op == LazyOp::Constant) {
+         return LazyTensor(apply_scalar(op, na.constant, nb.constant));
+      }
+      const Node &typed = na.op == LazyOp::Constant ? nb : na;
+      std::vector<std::size_t> shape = fused_shape(na, nb);
+      if (shape.empty()) {
+         return LazyTensor(apply_eager(op, a.materialize(), b.materialize()));
+      }
+      auto n = std::make_shared<Node>();
+      n->op = op;
+      n->shape = std::move(shape);
+      n->lhs = a.node_;
+      n->rhs = b.node_;
+      n->dtype = typed.dtype;
+      n->device = typed.device;
+      return LazyTensor(std::shared_ptr<const Node>(std::move(n)));
+   }
+
+   static LazyTensor unary(LazyOp op, const LazyTensor &a) {
+      const Node &na = *a.node_;
+      if (na.op == LazyOp::Constant) {
+         return LazyTensor(apply_scalar(op, na.constant, T(0)));
+      }
+      auto n = std::make_shared<Node>();
+      n->op = op;
+      n->shape = na.shape;
+      n->lhs = a.node_;
+      n->dtype = na.dtype;
+      n->device = na.device;
+      return LazyTensor(std::shared_ptr<const Node>(std::move(n)));
+   }
+};
+
+// Enters deferred mode: ops on the result build a DAG until it is
+// materialised or reduced.
+template <typename T> inline LazyTensor<T> defer(const RawTensor<T> &x) {
+   return LazyTensor<T>(x);
+}
+
+} // namespace fusion::lazy
+
+#endif // LAZY_HPP
@@ -0,0 +1,137 @@
+#ifndef MPMC_QUEUE_HPP
+#define MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+// Bounded lock-free multi-producer/multi-consumer queue (D. Vyukov's ring
+// buffer). Every cell carries a sequence number: a producer owns cell `pos`
+// once its sequence equals pos, a consumer once it equals pos + 1, so the only
+// shared writes are one CAS on the head or tail index per operation.
+//
+// Same interface as ThreadSafeQueue. push() spins while the queue is full;
+// use try_push() to handle back-pressure yourself. The shared_ptr overloads
+// are kept for compatibility but allocate; prefer try_pop(T &).
+template <typename T> class MPMCQueue {
+   static constexpr std::size_t kCacheLine = 64;
+
+   struct Cell {
+      std::atomic<std::size_t> sequence;
+      T data;
+   };
+
+ public:
+   explicit MPMCQueue(std::size_t capacity = 1024)
+       : buffer_(new Cell[capacity]), mask_(capacity - 1) {
+      if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+         throw std::invalid_argument(
+             "MPMCQueue: capacity must be a power of two >= 2");
+      }
+      for (std::size_t i = 0; i < capacity; ++i) {
+         buffer_[i].sequence.store(i, std::memory_order_relaxed);
+      }
+      enqueue_pos_.store(0, std::memory_order_relaxed);
+      dequeue_pos_.store(0, std::memory_order_relaxed);
+   }
+
+   MPMCQueue(const MPMCQueue &) = delete;
+   MPMCQueue &operator=(const MPMCQueue &) = delete;
+
+   std::size_t capacity() const noexcept { return mask_ + 1; }
+
+   // Leaves `value` untouched when the queue is full.
+   template <typename U> bool try_push(U &&value) {
+      Cell *cell;
+      std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+      for (;;) {
+         cell = &buffer_[pos & mask_];
+         const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+         const auto diff = static_cast<std::ptrdiff_t>(seq) -
+                           static_cast<std::ptrdiff_t>(pos);
+         if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                   std::memory_order_relaxed)) {
+               break;
+            }
+         } else if (diff < 0) {
+            return false; // full
+         } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+         }
+      }
+      cell->data = std::forward<U>(value);
+      cell->sequence.store(pos + 1, std::memory_order_release);
+      return true;
+   }
+
+   void push(const T &value) {
+      while (!try_push(value)) {
+         std::this_thread::yield();
+      }
+   }
+
+   void push(T &&value) {
+      while (!try_push(std::move(value))) {
+         std::this_thread::yield();
+      }
+   }
+
+   bool try_pop(T &value) {
+      Cell *cell;
+      std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+      for (;;) {
+         cell = &buffer_[pos & mask_];
+         const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+         const auto diff = static_cast<std::ptrdiff_t>(seq) -
+                           static_cast<std::ptrdiff_t>(pos + 1);
+         if (diff == 0) {
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                   std::memory_order_relaxed)) {
+               break;
+            }
+         } else if (diff < 0) {
+            return false; // empty
+         } else {
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+         }
+      }
+      value = std::move(cell->data);
+      cell->data = T{};
+      cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+      return true;
+   }
+
+   std::shared_ptr<T> try_pop() {
+      T value;
+      if (!try_pop(value)) {
+         return std::shared_ptr<T>();
+      }
+      return std::make_shared<T>(std::move(value));
+   }
+
+   std::shared_ptr<T> wait_and_pop() {
+      T value;
+      while (!try_pop(value)) {
+         std::this_thread::yield();
+      }
+      return std::make_shared<T>(std::move(value));
+   }
+
+   // Snapshot; may be stale by the time the caller acts on it.
+   bool empty() const {
+      return dequeue_pos_.load(std::memory_order_acquire) >=
+             enqueue_pos_.load(std::memory_order_acquire);
+   }
+
+ private:
+   std::unique_ptr<Cell[]> buffer_;
+   const std::size_t mask_;
+   alignas(kCacheLine) std::atomic<std::size_t> enqueue_pos_;
+   alignas(kCacheLine) std::atomic<std::size_t> dequeue_pos_;
+};
+
+#endif // MPMC_QUEUE_HPP
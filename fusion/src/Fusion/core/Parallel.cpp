@@ -0,0 +1,342 @@
+#include "Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#if !defined(__APPLE__)
+#include <cblas.h>
+#endif
+
+#include "Fusion/common/Log.hpp"
+
+namespace fusion::parallel {
+
+namespace {
+
+std::size_t affinity_cpu_count() {
+#if defined(__linux__)
+   cpu_set_t set;
+   CPU_ZERO(&set);
+   if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+      const int n = CPU_COUNT(&set);
+      if (n > 0) {
+         return static_cast<std::size_t>(n);
+      }
+   }
+#endif
+   return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// "0-3,8,10-11" -> {0,1,2,3,8,10,11}. Returns an empty list on parse errors.
+std::vector<int> parse_cpu_list(const std::string &spec) {
+   std::vector<int> cpus;
+   std::stringstream ss(spec);
+   std::string item;
+   while (std::getline(ss, item, ',')) {
+      if (item.empty()) {
+         continue;
+      }
+      try {
+         const auto dash = item.find('-');
+         const int lo = std::stoi(item.substr(0, dash));
+         const int hi =
+             dash == std::string::npos ? lo : std::stoi(item.substr(dash + 1));
+         if (lo < 0 || hi < lo) {
+            return {};
+         }
+         for (int c = lo; c <= hi; ++c) {
+            cpus.push_back(c);
+         }
+      } catch (const std::exception &) {
+         return {};
+      }
+   }
+   return cpus;
+}
+
+struct PoolState {
+   std::mutex mutex;
+   std::atomic<std::size_t> num_threads{0};
+   std::vector<int> cpu_affinity = default_cpu_affinity();
+   // Every user of the pool (parallel_for, the executors) holds a copy for
+   // as long as it has work queued, so use_count() > 1 means work in flight.
+   std::shared_ptr<ThreadPool> pool;
+};
+
+PoolState &pool_state() {
+   static PoolState state;
+   return state;
+}
+
+// 0 = not inside a region, use the configured thread count.
+thread_local std::size_t t_region_budget = 0;
+
+// The BLAS thread count is process-global, so overlapping BlasThreadScopes
+// (from different threads, or nested) share it: the smallest active request
+// wins, and the count from before the first scope comes back when the last
+// one closes.
+struct BlasScopeState {
+   std::mutex mutex;
+   std::multiset<std::size_t> active;
+   std::size_t outer = 0;
+};
+
+BlasScopeState &blas_scope_state() {
+   static BlasScopeState state;
+   return state;
+}
+
+// Called with the pool mutex held. Tearing the pool down under running work
+// would strand its queued chunks and leave the waiters on a dead pool.
+void reset_pool(PoolState &s, const char *what) {
+   if (s.pool && s.pool.use_count() > 1) {
+      throw std::runtime_error(std::string(what) +
+                               ": the thread pool still has work in flight");
+   }
+   s.pool.reset();
+}
+
+void apply_blas_num_threads(std::size_t num_threads) {
+#if defined(OPENBLAS_VERSION)
+   openblas_set_num_threads(
+       static_cast<int>(std::max<std::size_t>(num_threads, 1)));
+#else
+   (void)num_threads;
+#endif
+}
+
+bool blas_threads_from_env() {
+   return std::getenv("OPENBLAS_NUM_THREADS") != nullptr ||
+          std::getenv("GOTO_NUM_THREADS") != nullptr;
+}
+
+void set_pool_threads(std::size_t num_threads) {
+   auto &s = pool_state();
+   std::lock_guard<std::mutex> lock(s.mutex);
+   if (s.num_threads.load() != num_threads) {
+      reset_pool(s, "set_num_threads");
+      s.num_threads = num_threads;
+   }
+}
+
+} // namespace
+
+std::size_t default_num_threads() {
+   static std::size_t cached = [] {
+      if (const char *e = std::getenv("FUSION_NUM_THREADS")) {
+         const int v = std::atoi(e);
+         if (v > 0) {
+            return static_cast<std::size_t>(v);
+         }
+         FUSION_LOGW("FUSION_NUM_THREADS='", e, "' ignored, expected > 0");
+      }
+      // More threads than pinned CPUs would only oversubscribe them.
+      const std::size_t pinned = default_cpu_affinity().size();
+      const std::size_t cpus = affinity_cpu_count();
+      return pinned > 0 ? std::min(cpus, pinned) : cpus;
+   }();
+   return cached;
+}
+
+std::vector<int> default_cpu_affinity() {
+   static std::vector<int> cached = [] {
+      const char *e = std::getenv("FUSION_CPU_AFFINITY");
+      if (!e) {
+         return std::vector<int>{};
+      }
+      auto cpus = parse_cpu_list(e);
+      if (cpus.empty()) {
+         FUSION_LOGW("FUSION_CPU_AFFINITY='", e,
+                     "' ignored, expected e.g. 0-3,8");
+      }
+      return cpus;
+   }();
+   return cached;
+}
+
+void set_num_threads(std::size_t num_threads) {
+   num_threads = std::max<std::size_t>(num_threads, 1);
+   set_pool_threads(num_threads);
+   set_blas_num_threads(num_threads);
+}
+
+std::size_t get_num_threads() {
+   auto &s = pool_state();
+   std::size_t n = s.num_threads.load(std::memory_order_relaxed);
+   if (n == 0) {
+      // Implicit configuration leaves an explicit OPENBLAS_NUM_THREADS alone.
+      n = default_num_threads();
+      set_pool_threads(n);
+      if (!blas_threads_from_env()) {
+         set_blas_num_threads(n);
+      }
+      n = s.num_threads.load();
+   }
+   return n;
+}
+
+void set_cpu_affinity(std::vector<int> cpus) {
+   auto &s = pool_state();
+   std::lock_guard<std::mutex> lock(s.mutex);
+   reset_pool(s, "set_cpu_affinity");
+   s.cpu_affinity = std::move(cpus);
+}
+
+std::vector<int> get_cpu_affinity() {
+   auto &s = pool_state();
+   std::lock_guard<std::mutex> lock(s.mutex);
+   return s.cpu_affinity;
+}
+
+std::shared_ptr<ThreadPool> shared_thread_pool() {
+   const std::size_t n = get_num_threads();
+   auto &s = pool_state();
+   std::lock_guard<std::mutex> lock(s.mutex);
+   if (!s.pool) {
+      s.pool = std::make_shared<ThreadPool>(n - 1, s.cpu_affinity);
+   }
+   return s.pool;
+}
+
+ThreadPool &thread_pool() { return *shared_thread_pool(); }
+
+void set_blas_num_threads(std::size_t num_threads) {
+   // Inside open BlasThreadScopes the new count takes effect when the last
+   // one closes, instead of being overwritten by it.
+   auto &s = blas_scope_state();
+   std::lock_guard<std::mutex> lock(s.mutex);
+   if (!s.active.empty()) {
+      s.outer = std::max<std::size_t>(num_threads, 1);
+      return;
+   }
+   apply_blas_num_threads(num_threads);
+}
+
+std::size_t get_blas_num_threads() {
+#if defined(OPENBLAS_VERSION)
+   return static_cast<std::size_t>(openblas_get_num_threads());
+#else
+   return 1;
+#endif
+}
+
+BlasThreadScope::BlasThreadScope(std::size_t num_threads)
+    : num_threads_(std::max<std::size_t>(num_threads, 1)) {
+   auto &s = blas_scope_state();
+   std::lock_guard<std::mutex> lock(s.mutex);
+   if (s.active.empty()) {
+      s.outer = get_blas_num_threads();
+   }
+   s.active.insert(num_threads_);
+   if (get_blas_num_threads() != *s.active.begin()) {
+      apply_blas_num_threads(*s.active.begin());
+   }
+}
+
+BlasThreadScope::~BlasThreadScope() {
+   auto &s = blas_scope_state();
+   std::lock_guard<std::mutex> lock(s.mutex);
+   s.active.erase(s.active.find(num_threads_));
+   const std::size_t want = s.active.empty() ? s.outer : *s.active.begin();
+   if (get_blas_num_threads() != want) {
+      apply_blas_num_threads(want);
+   }
+}
+
+std::size_t max_concurrency() {
+   if (t_region_budget != 0) {
+      return t_region_budget;
+   }
+   return ThreadPool::on_worker_thread() ? 1 : get_num_threads();
+}
+
+bool in_parallel_region() {
+   return t_region_budget != 0 || ThreadPool::on_worker_thread();
+}
+
+ParallelRegionGuard::ParallelRegionGuard(std::size_t budget)
+    : previous_(t_region_budget) {
+   t_region_budget = std::max<std::size_t>(budget, 1);
+}
+
+ParallelRegionGuard::~ParallelRegionGuard() { t_region_budget = previous_; }
+
+void parallel_for(std::size_t begin, std::size_t end, std::size_t grain,
+                  const std::function<void(std::size_t, std::size_t)> &fn) {
+   if (begin >= end) {
+      return;
+   }
+   const std::size_t n = end - begin;
+   grain = std::max<std::size_t>(grain, 1);
+   const std::size_t workers =
+       std::min(max_concurrency(), (n + grain - 1) / grain);
+   if (workers <= 1) {
+      fn(begin, end);
+      return;
+   }
+
+   const std::size_t chunk = (n + workers - 1) / workers;
+   const std::size_t chunks = (n + chunk - 1) / chunk;
+   // Helpers may be popped after the caller has returned, so the shared
+   // bookkeeping outlives this frame. fn is only touched while a chunk is
+   // still unclaimed, i.e. before the caller can return.
+   struct State {
+      std::atomic<std::size_t> next{0};
+      std::atomic<std::size_t> remaining{0};
+      std::mutex error_mutex;
+      std::exception_ptr error;
+   };
+   auto state = std::make_shared<State>();
+   state->remaining = chunks;
+
+   auto run_chunks = [state, &fn, begin, end, chunk, chunks] {
+      ParallelRegionGuard region;
+      for (;;) {
+         const std::size_t c = state->next.fetch_add(1);
+         if (c >= chunks) {
+            return;
+         }
+         const std::size_t lo = begin + c * chunk;
+         const std::size_t hi = std::min(end, lo + chunk);
+         try {
+            fn(lo, hi);
+         } catch (...) {
+            std::lock_guard<std::mutex> lock(state->error_mutex);
+            if (!state->error) {
+               state->error = std::current_exception();
+            }
+         }
+         state->remaining.fetch_sub(1, std::memory_order_acq_rel);
+      }
+   };
+
+   const std::shared_ptr<ThreadPool> lease = shared_thread_pool();
+   ThreadPool &pool = *lease;
+   for (std::size_t i = 1; i < chunks; ++i) {
+      pool.submit(run_chunks);
+   }
+   run_chunks();
+   while (state->remaining.load(std::memory_order_acquire) != 0) {
+      if (!pool.run_pending_task()) {
+         std::this_thread::yield();
+      }
+   }
+   if (state->error) {
+      std::rethrow_exception(state->error);
+   }
+}
+
+} // namespace fusion::parallel
@@ -0,0 +1,91 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ThreadPool.h"
+
+// Process-wide threading configuration.
+//
+// Fusion owns one ThreadPool shared by every parallel kernel. It is sized from
+// FUSION_NUM_THREADS (falling back to the CPUs in the process affinity mask,
+// capped at the FUSION_CPU_AFFINITY list when one is given) and its workers
+// can be pinned with FUSION_CPU_AFFINITY, e.g. "0-3,8".
+// The thread count counts the calling thread: parallel_for runs one chunk on
+// the caller, so the pool itself holds num_threads - 1 workers. The caller is
+// not pinned: it belongs to the application, whose own affinity is left as
+// it set it (restrict the process with taskset to confine it as well).
+//
+// BLAS keeps its own thread pool; set_num_threads() forwards the same count to
+// it (OpenBLAS only) so the two pools do not oversubscribe the machine. The
+// implicit setup on first use skips that when OPENBLAS_NUM_THREADS is set.
+namespace fusion::parallel {
+
+std::size_t default_num_threads();
+std::vector<int> default_cpu_affinity();
+
+// Rebuilds the shared pool. Throws std::runtime_error while work is still
+// running on it (from inside a parallel_for, or alongside one).
+void set_num_threads(std::size_t num_threads);
+std::size_t get_num_threads();
+
+void set_cpu_affinity(std::vector<int> cpus);
+std::vector<int> get_cpu_affinity();
+
+ThreadPool &thread_pool();
+// The pool plus a reference that keeps set_num_threads/set_cpu_affinity from
+// replacing it; hold one for as long as work is queued on it.
+std::shared_ptr<ThreadPool> shared_thread_pool();
+
+// Thread count used by the BLAS library (1 when it cannot be controlled).
+// While BlasThreadScopes are open a new count is applied when they close.
+void set_blas_num_threads(std::size_t num_threads);
+std::size_t get_blas_num_threads();
+
+// RAII: run BLAS with num_threads inside the scope, restore on exit. Scopes
+// may overlap across threads; while several are open BLAS runs with the
+// smallest count any of them asked for.
+class BlasThreadScope {
+ public:
+   explicit BlasThreadScope(std::size_t num_threads);
+   ~BlasThreadScope();
+
+   BlasThreadScope(const BlasThreadScope &) = delete;
+   BlasThreadScope &operator=(const BlasThreadScope &) = delete;
+
+ private:
+   std::size_t num_threads_;
+};
+
+// Threads a parallel_for issued from this thread may use. Top-level code gets
+// get_num_threads(); pool workers and code inside a ParallelRegionGuard get
+// the guard's budget (1 by default), so nested regions run serially instead
+// of fanning out again.
+std::size_t max_concurrency();
+bool in_parallel_region();
+
+class ParallelRegionGuard {
+ public:
+   explicit ParallelRegionGuard(std::size_t budget = 1);
+   ~ParallelRegionGuard();
+
+   ParallelRegionGuard(const ParallelRegionGuard &) = delete;
+   ParallelRegionGuard &operator=(const ParallelRegionGuard &) = delete;
+
+ private:
+   std::size_t previous_;
+};
+
+// Splits [begin, end) into at most max_concurrency() chunks of at least
+// `grain` iterations and calls fn(chunk_begin, chunk_end) on each. The caller
+// takes part and returns once every chunk has finished; the first exception
+// thrown by fn is rethrown here.
+void parallel_for(std::size_t begin, std::size_t end, std::size_t grain,
+                  const std::function<void(std::size_t, std::size_t)> &fn);
+
+} // namespace fusion::parallel
+
+#endif // PARALLEL_H
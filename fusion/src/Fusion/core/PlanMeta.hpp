@@ -1,8 +1,11 @@
 #ifndef EWISE_META_HPP
 #define EWISE_META_HPP
 
+#include <algorithm>
 #include <vector>
 
+#include "Fusion/common/Checks.hpp"
+
 #include "TensorPlan.h"
 
 #include "RawTensor.hpp"
@@ -35,9 +38,9 @@ struct ReductionMeta {
    std::size_t fast_len;
    std::vector<std::size_t> out_shape;
    ReductionPlan plan;
-   bool keepdim;               // TODO: Remove this it's also in the plan
-   std::size_t reduction_axis; // TODO: This is also in the plan
-   std::size_t reduce_len;
+   bool keepdim; // TODO: Remove this it's also in the plan
+   std::vector<std::size_t> reduction_axes; // sorted, unique
+   std::size_t reduce_len; // elements folded into each output
    TensorDescription dA, dOut;
 };
 
@@ -106,9 +109,9 @@ inline BinaryEwiseMeta make_binary_meta(const RawTensor<T> &A,
       meta.fast_len = A.flat_size();
       return meta;
    }
-   // TODO: We are lying about strides here
-   auto dA = make_desc_from_shape<T>(A.shape(), nullptr);
-   auto dB = make_desc_from_shape<T>(B.shape(), nullptr);
+   // Real strides: operands may be views (swapaxes_view).
+   auto dA = make_desc_from_tensor<T>(A);
+   auto dB = make_desc_from_tensor<T>(B);
    auto plan_in = make_broadcast_plan({dA, dB});
 
    meta.fastpath = false;
@@ -131,8 +134,7 @@ inline UnaryEwiseMeta make_unary_meta(const RawTensor<T> &A) {
       meta.fast_len = A.flat_size();
       return meta;
    }
-   // TODO: We are lying about strides here
-   auto dA = make_desc_from_shape<T>(A.shape(), nullptr);
+   auto dA = make_desc_from_tensor<T>(A);
    auto plan_in = make_broadcast_plan({dA});
 
    meta.fastpath = false;
@@ -145,42 +147,80 @@ inline UnaryEwiseMeta make_unary_meta(const RawTensor<T> &A) {
 
 constexpr std::size_t kGlobalReduceAxis = -1;
 
+// Shape of a keepdim reduction of `shape` over `axes`: the reduced extents
+// become 1. Used to broadcast an upstream grad back over the input.
+inline std::vector<std::size_t>
+keepdim_shape(std::vector<std::size_t> shape,
+              const std::vector<std::size_t> &axes) {
+   for (const std::size_t ax : normalise_reduction_axes(axes, shape.size()))
+      shape[ax] = 1;
+   return shape;
+}
+
 template <typename T>
 inline ReductionMeta make_reduction_meta(const RawTensor<T> &A,
-                                         const std::size_t axis, bool keepdim) {
+                                         const std::vector<std::size_t> &axes,
+                                         bool keepdim) {
    ReductionMeta meta{};
-   if (axis == kGlobalReduceAxis && keepdim == false) {
+   const std::vector<std::size_t> shape = A.shape();
+   meta.reduction_axes = normalise_reduction_axes(axes, shape.size());
+   meta.keepdim = keepdim;
+
+   if (meta.reduction_axes.size() == shape.size() && A.is_contiguous()) {
       meta.fastpath = true;
-      meta.out_shape = std::vector<std::size_t>{1};
+      meta.out_shape = keepdim ? std::vector<std::size_t>(shape.size(), 1)
+                               : std::vector<std::size_t>{1};
       meta.fast_len = A.flat_size();
       meta.reduce_len = meta.fast_len;
       return meta;
    }
 
-   const TensorDescription dA = make_desc_from_shape<T>(A.shape(), nullptr);
+   const TensorDescription dA = make_desc_from_tensor<T>(A);
 
    std::vector<std::size_t> out_shape;
+   meta.reduce_len = 1;
+   std::size_t next = 0;
    for (std::size_t d = 0; d < dA.ndims; ++d) {
-      if (d == axis) {
+      const bool reduced = next < meta.reduction_axes.size() &&
+                           meta.reduction_axes[next] == d;
+      if (reduced) {
+         ++next;
+         meta.reduce_len *= dA.shape[d];
          if (keepdim)
             out_shape.push_back(1);
       } else {
          out_shape.push_back(dA.shape[d]);
       }
    }
-   meta.out_shape = out_shape;
-   meta.dOut = make_desc_from_shape<T>(meta.out_shape, nullptr);
+   // A full reduction of a strided view: the plan keeps the reduced axes
+   // as ones (it has no rank-0 output), the result is still {1}.
+   const bool plan_keepdim = keepdim || out_shape.empty();
+   meta.out_shape =
+       out_shape.empty() ? std::vector<std::size_t>{1} : out_shape;
+   meta.dOut = make_desc_from_shape<T>(
+       plan_keepdim ? keepdim_shape(shape, meta.reduction_axes) : out_shape,
+       nullptr);
    meta.dA = dA;
 
-   meta.plan = make_reduction_plan({meta.dOut, meta.dA}, axis, keepdim);
+   meta.plan = make_reduction_plan({meta.dOut, meta.dA}, meta.reduction_axes,
+                                   plan_keepdim);
    meta.fastpath = false;
-   meta.keepdim = keepdim;
-   meta.reduction_axis = axis;
-   meta.reduce_len = dA.shape[axis];
 
    return meta;
 }
 
+// Single-axis form; kGlobalReduceAxis reduces everything. With keepdim the
+// result keeps the input's rank as all ones (before axis sets it reduced
+// only the last axis there).
+template <typename T>
+inline ReductionMeta make_reduction_meta(const RawTensor<T> &A,
+                                         const std::size_t axis, bool keepdim) {
+   if (axis == kGlobalReduceAxis) {
+      return make_reduction_meta(A, std::vector<std::size_t>{}, keepdim);
+   }
+   return make_reduction_meta(A, std::vector<std::size_t>{axis}, keepdim);
+}
+
 template <typename T>
 inline ContractionMeta
 make_contraction_meta_einsum(const RawTensor<T> &A, const RawTensor<T> &B,
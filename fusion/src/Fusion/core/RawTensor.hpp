@@ -1,10 +1,12 @@
 #ifndef TENSOR_BASE_HPP
 #define TENSOR_BASE_HPP
 
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <ostream>
 #include <stdexcept>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -12,13 +14,16 @@
 #include "Fusion/common/Checks.hpp"
 #include "Fusion/core/Dtype.h"
 #include "Fusion/core/Layout.h"
+#include "Fusion/cpu/simd/Convert.hpp"
 #include "Fusion/device/Device.h"
 #include "Fusion/kernels/Serial.hpp"
 #include "Fusion/ops/Comparison.hpp"
+#include "Fusion/ops/Einsum.hpp"
 #include "Fusion/ops/Ewise.hpp"
 #include "Fusion/ops/Helpers.hpp"
 #include "Fusion/ops/Linalg.hpp"
 #include "Fusion/ops/OpParams.hpp"
+#include "Fusion/ops/PackedWeight.hpp"
 #include "Fusion/ops/Reduce.hpp"
 #include "Fusion/ops/Transcendental.hpp"
 #include "Fusion/storage/DenseStorage.hpp"
@@ -28,7 +33,7 @@
 #include "Fusion/common/Log.hpp"
 
 template <typename T> // TODO: need to either pass in device somehow?
-inline RawTensor<T> scalar_t(const T scalar, const DType dtype = DType::FLOAT32,
+inline RawTensor<T> scalar_t(const T scalar, const DType dtype = dtype_of<T>(),
                              Device device = Device{DeviceType::CPU, 0}) {
    return RawTensor<T>{{1}, {scalar}, dtype, device};
 }
@@ -109,6 +114,17 @@ template <typename T> class RawTensor {
    T *get_ptr() { return storage_->data_ptr(); }
    const T *get_ptr() const { return storage_->data_ptr(); }
 
+   // Write count of the shared buffer; see TensorBuffer::version. Callers
+   // that write through get_ptr() bump it themselves.
+   std::uint64_t version() const noexcept {
+      return storage_ ? storage_->data().version() : 0;
+   }
+   void bump_version() noexcept {
+      if (storage_) {
+         storage_->data().bump_version();
+      }
+   }
+
    TensorView<T>
    view() { // TODO: need to eventuall pass into metadata for views
       return TensorView<T>(storage_->data().template data<T>(), this->shape(),
@@ -146,6 +162,7 @@ template <typename T> class RawTensor {
          return;
       }
       std::memset(buf.data(), 0, buf.size_bytes());
+      buf.bump_version();
    }
 
    void assign(const RawTensor &other) {
@@ -153,52 +170,110 @@ template <typename T> class RawTensor {
          *this = other;
       } else {
          storage_->data().assign(other.begin(), other.end());
+         storage_->data().bump_version();
       }
    };
 
-   RawTensor operator+(const T scalar) const {
+   // Operators on tensors that are about to die (temporaries, std::move)
+   // write the result into that operand's buffer when it is uniquely owned
+   // and has the result's shape, instead of allocating a new output.
+   RawTensor operator+(const T scalar) const & {
       return fusion::math::add(*this, scalar_t(scalar, dtype(), device()));
    }
+   RawTensor operator+(const T scalar) && {
+      return donate<AddSIMD>(scalar_t(scalar, dtype(), device()), this);
+   }
 
-   RawTensor operator-(const T scalar) const {
+   RawTensor operator-(const T scalar) const & {
       return fusion::math::sub(*this, scalar_t(scalar, dtype(), device()));
    }
+   RawTensor operator-(const T scalar) && {
+      return donate<SubtractSIMD>(scalar_t(scalar, dtype(), device()), this);
+   }
 
-   RawTensor operator*(const T scalar) const {
+   RawTensor operator*(const T scalar) const & {
       return fusion::math::mul(*this, scalar_t(scalar, dtype(), device()));
    }
+   RawTensor operator*(const T scalar) && {
+      return donate<MultiplySIMD>(scalar_t(scalar, dtype(), device()), this);
+   }
 
-   RawTensor operator/(const T scalar) const {
+   RawTensor operator/(const T scalar) const & {
       return fusion::math::div(*this, scalar_t(scalar, dtype(), device()));
    }
+   RawTensor operator/(const T scalar) && {
+      return donate<DivideSIMD>(scalar_t(scalar, dtype(), device()), this);
+   }
 
    RawTensor operator>=(const T scalar) const {
       return fusion::math::greater(*this, scalar_t(scalar, dtype(), device()));
    }
 
-   RawTensor maximum(const T scalar) const {
+   RawTensor maximum(const T scalar) const & {
       return fusion::math::maximum(*this, scalar_t(scalar, dtype(), device()));
    }
+   RawTensor maximum(const T scalar) && {
+      return donate<MaximumSIMD>(scalar_t(scalar, dtype(), device()), this);
+   }
 
-   RawTensor pow(const T scalar) const {
+   RawTensor pow(const T scalar) const & {
       return fusion::math::pow(*this, scalar_t(scalar, dtype(), device()));
    }
+   RawTensor pow(const T scalar) && {
+      return donate<PowerSIMD>(scalar_t(scalar, dtype(), device()), this);
+   }
 
-   RawTensor operator+(const RawTensor &other) const {
+   RawTensor operator+(const RawTensor &other) const & {
       return fusion::math::add(*this, other);
    }
+   RawTensor operator+(const RawTensor &other) && {
+      return donate<AddSIMD>(other, this);
+   }
+   RawTensor operator+(RawTensor &&other) const & {
+      return donate<AddSIMD>(other, nullptr, &other);
+   }
+   RawTensor operator+(RawTensor &&other) && {
+      return donate<AddSIMD>(other, this, &other);
+   }
 
-   RawTensor operator-(const RawTensor &other) const {
+   RawTensor operator-(const RawTensor &other) const & {
       return fusion::math::sub(*this, other);
    }
+   RawTensor operator-(const RawTensor &other) && {
+      return donate<SubtractSIMD>(other, this);
+   }
+   RawTensor operator-(RawTensor &&other) const & {
+      return donate<SubtractSIMD>(other, nullptr, &other);
+   }
+   RawTensor operator-(RawTensor &&other) && {
+      return donate<SubtractSIMD>(other, this, &other);
+   }
 
-   RawTensor operator*(const RawTensor &other) const {
+   RawTensor operator*(const RawTensor &other) const & {
       return fusion::math::mul(*this, other);
    }
+   RawTensor operator*(const RawTensor &other) && {
+      return donate<MultiplySIMD>(other, this);
+   }
+   RawTensor operator*(RawTensor &&other) const & {
+      return donate<MultiplySIMD>(other, nullptr, &other);
+   }
+   RawTensor operator*(RawTensor &&other) && {
+      return donate<MultiplySIMD>(other, this, &other);
+   }
 
-   RawTensor operator/(const RawTensor &other) const {
+   RawTensor operator/(const RawTensor &other) const & {
       return fusion::math::div(*this, other);
    }
+   RawTensor operator/(const RawTensor &other) && {
+      return donate<DivideSIMD>(other, this);
+   }
+   RawTensor operator/(RawTensor &&other) const & {
+      return donate<DivideSIMD>(other, nullptr, &other);
+   }
+   RawTensor operator/(RawTensor &&other) && {
+      return donate<DivideSIMD>(other, this, &other);
+   }
 
    RawTensor operator>(const RawTensor &other) const {
       return fusion::math::greater(*this, other);
@@ -212,17 +287,69 @@ template <typename T> class RawTensor {
       return fusion::math::linalg::matmul(*this, other);
    }
 
-   RawTensor maximum(const RawTensor &other) const {
+   // act(this W^T + b) with bias and activation fused into the GEMM.
+   RawTensor linear(const RawTensor &W, const RawTensor &b,
+                    const Activation act = Activation::None) const {
+      return fusion::math::linalg::linear(*this, W, b, act);
+   }
+   RawTensor linear(const RawTensor &W,
+                    const Activation act = Activation::None) const {
+      return fusion::math::linalg::linear(*this, W, act);
+   }
+
+   // The same against a weight kept packed for repeated calls.
+   RawTensor matmul(const fusion::math::linalg::PackedWeight<T> &W) const {
+      return fusion::math::linalg::matmul(*this, W);
+   }
+   RawTensor linear(const fusion::math::linalg::PackedWeight<T> &W,
+                    const RawTensor &b,
+                    const Activation act = Activation::None) const {
+      return fusion::math::linalg::linear(*this, W, b, act);
+   }
+   RawTensor linear(const fusion::math::linalg::PackedWeight<T> &W,
+                    const Activation act = Activation::None) const {
+      return fusion::math::linalg::linear(*this, W, act);
+   }
+
+   // Two-operand einsum with this tensor first: a.einsum("ij,jk->ik", b).
+   RawTensor einsum(std::string_view subscripts,
+                    const RawTensor &other) const {
+      return fusion::math::linalg::einsum(subscripts, *this, other);
+   }
+
+   RawTensor maximum(const RawTensor &other) const & {
       return fusion::math::maximum(*this, other);
    }
+   RawTensor maximum(const RawTensor &other) && {
+      return donate<MaximumSIMD>(other, this);
+   }
 
-   RawTensor pow(const RawTensor &other) const {
+   RawTensor pow(const RawTensor &other) const & {
       return fusion::math::pow(*this, other);
    }
+   RawTensor pow(const RawTensor &other) && {
+      return donate<PowerSIMD>(other, this);
+   }
+
+   RawTensor sqrt() const & { return fusion::math::sqrt(*this); }
+   RawTensor sqrt() && {
+      return fusion::math::unary_donating<T, SqrtSIMD>(std::move(*this));
+   }
+   RawTensor log() const & { return fusion::math::log(*this); }
+   RawTensor log() && {
+      return fusion::math::unary_donating<T, NaturalLogSIMD>(std::move(*this));
+   }
+   RawTensor exp() const & { return fusion::math::exp(*this); }
+   RawTensor exp() && {
+      return fusion::math::unary_donating<T, ExponentialSIMD>(std::move(*this));
+   }
 
-   RawTensor sqrt() const { return fusion::math::sqrt(*this); }
-   RawTensor log() const { return fusion::math::log(*this); }
-   RawTensor exp() const { return fusion::math::exp(*this); }
+   // Sole owner of its storage and buffer, so it may be overwritten in place
+   // without any other tensor observing the change.
+   bool is_uniquely_owned() const noexcept {
+      return storage_ && storage_.use_count() == 1 &&
+             storage_->data().use_count() == 1;
+   }
 
    RawTensor sum(const std::size_t axis, const bool keepdim) const {
       return fusion::math::sum(*this, axis, keepdim);
@@ -231,15 +358,110 @@ template <typename T> class RawTensor {
       return fusion::math::mean(*this, axis, keepdim);
    }
 
+   // Reduces all of `axes` in one pass; an empty list reduces every axis.
+   // Global and row sums are tree-reduced and bit-reproducible for any
+   // thread count; SumMode::Compensated adds Neumaier compensation.
+   RawTensor sum(const std::vector<std::size_t> &axes, const bool keepdim,
+                 const SumMode mode = SumMode::Pairwise) const {
+      return fusion::math::sum(*this, axes, keepdim, mode);
+   }
+   RawTensor mean(const std::vector<std::size_t> &axes, const bool keepdim,
+                  const SumMode mode = SumMode::Pairwise) const {
+      return fusion::math::mean(*this, axes, keepdim, mode);
+   }
+
+   // correction = 1 for the unbiased sample estimate.
+   RawTensor var(const std::vector<std::size_t> &axes, const bool keepdim,
+                 const std::size_t correction = 0) const {
+      return fusion::math::var(*this, axes, keepdim, correction);
+   }
+   RawTensor stddev(const std::vector<std::size_t> &axes, const bool keepdim,
+                    const std::size_t correction = 0) const {
+      return fusion::math::stddev(*this, axes, keepdim, correction);
+   }
+
+   // Same storage, new shape. Only valid for contiguous tensors.
+   RawTensor reshape(std::vector<std::size_t> shape) const {
+      FUSION_CHECK(is_contiguous(), "reshape: tensor is not contiguous");
+      RawTensor out(*this);
+      out.shape_ = std::move(shape);
+      FUSION_CHECK(out.set_contiguous_strides() == flat_size(),
+                   "reshape: size mismatch");
+      return out;
+   }
+
+   // Element-wise copy as U, e.g. float <-> bfloat16/float16 through the
+   // vector conversion kernels. Only valid for contiguous tensors.
+   template <typename U> RawTensor<U> astype() const {
+      FUSION_CHECK(is_contiguous(), "astype: tensor is not contiguous");
+      RawTensor<U> out(shape_, dtype_of<U>(), device_);
+      simd::convert(get_ptr(), out.get_ptr(), flat_size());
+      return out;
+   }
+
    RawTensor swapaxes(const int axis1, const int axis2) const {
       return fusion::math::linalg::swapaxes(*this, axis1, axis2);
    }
 
-   RawTensor &operator-=(const RawTensor &other) {
-      fusion::math::sub_inplace(*this, other);
-      return *this;
+   // Same storage with two axes exchanged in shape and strides: no copy, but
+   // the result is not contiguous. matmul maps it onto a transposed BLAS
+   // operand; element-wise ops and reductions read it through its strides.
+   // Ops that need contiguous input (astype, lazy leaves) check for it.
+   RawTensor swapaxes_view(const int axis1, const int axis2) const {
+      RawTensor out(*this);
+      if (rank() < 2) {
+         return out;
+      }
+      const std::size_t a = serial::normalise_axis(axis1, rank());
+      const std::size_t b = serial::normalise_axis(axis2, rank());
+      std::swap(out.shape_[a], out.shape_[b]);
+      std::swap(out.strides_[a], out.strides_[b]);
+      return out;
+   }
+
+   // In place: other is broadcast to this tensor's shape, never the reverse.
+   RawTensor &add_(const RawTensor &other) {
+      return fusion::math::add_(*this, other);
+   }
+   RawTensor &sub_(const RawTensor &other) {
+      return fusion::math::sub_(*this, other);
+   }
+   RawTensor &mul_(const RawTensor &other) {
+      return fusion::math::mul_(*this, other);
+   }
+   RawTensor &div_(const RawTensor &other) {
+      return fusion::math::div_(*this, other);
    }
 
+   RawTensor &add_(const T scalar) { return fusion::math::add_(*this, scalar); }
+   RawTensor &sub_(const T scalar) { return fusion::math::sub_(*this, scalar); }
+   RawTensor &mul_(const T scalar) { return fusion::math::mul_(*this, scalar); }
+   RawTensor &div_(const T scalar) { return fusion::math::div_(*this, scalar); }
+
+   // this += value * t1 * t2 and this += value * t1 / t2.
+   RawTensor &addcmul_(const RawTensor &t1, const RawTensor &t2,
+                       const T value = T(1)) {
+      return fusion::math::addcmul_(*this, t1, t2, value);
+   }
+   RawTensor &addcdiv_(const RawTensor &t1, const RawTensor &t2,
+                       const T value = T(1)) {
+      return fusion::math::addcdiv_(*this, t1, t2, value);
+   }
+   // this += A @ B, accumulated by the GEMM (beta = 1).
+   RawTensor &addmm_(const RawTensor &A, const RawTensor &B) {
+      return fusion::math::linalg::addmm_(*this, A, B);
+   }
+
+   RawTensor &operator+=(const RawTensor &other) { return add_(other); }
+   RawTensor &operator-=(const RawTensor &other) { return sub_(other); }
+   RawTensor &operator*=(const RawTensor &other) { return mul_(other); }
+   RawTensor &operator/=(const RawTensor &other) { return div_(other); }
+
+   RawTensor &operator+=(const T scalar) { return add_(scalar); }
+   RawTensor &operator-=(const T scalar) { return sub_(scalar); }
+   RawTensor &operator*=(const T scalar) { return mul_(scalar); }
+   RawTensor &operator/=(const T scalar) { return div_(scalar); }
+
    friend std::ostream &operator<<(std::ostream &os, const RawTensor &tensor) {
       const auto *cpuStorage =
           dynamic_cast<const NDTensorStorage<T> *>(tensor.get_storage());
@@ -283,6 +505,13 @@ template <typename T> class RawTensor {
    Device device_;
    IAllocator *allocator_ = nullptr;
 
+   template <class Tag>
+   RawTensor donate(const RawTensor &other, RawTensor *self_donor,
+                    RawTensor *other_donor = nullptr) const {
+      return fusion::math::binary_donating<T, Tag>(*this, other, self_donor,
+                                                   other_donor);
+   }
+
    void replace_from(RawTensor &&tmp) {
       storage_.swap(tmp.storage());
       shape_.swap(tmp.shape_);
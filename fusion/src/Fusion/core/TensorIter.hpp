@@ -1,18 +1,25 @@
 #ifndef EWISE_ITER_HPP
 #define EWISE_ITER_HPP
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstdint>
 #include <functional>
 #include <numeric>
+#include <type_traits>
 #include <vector>
 
 #include "Fusion/common/Checks.hpp"
 #include "Fusion/cpu/blas/BlasTraits.hpp"
+#include "Fusion/cpu/blas/SmallGemm.hpp"
+#include "Fusion/cpu/blas/VectorKernels.hpp"
 #include "Fusion/cpu/simd/SimdTraits.hpp"
 #include "Fusion/cpu/simd/VecNeon128.hpp"
 
 #include "PlanMeta.hpp"
 #include "TensorPlan.h"
+#include "TreeReduce.hpp"
 
 namespace fusion {
 
@@ -248,8 +255,30 @@ void unary_ewise_tag(const TensorT &A, UnaryEwiseMeta &meta,
        });
 }
 
+// True when the innermost loop reduces over rows of stride > 1 and the loop
+// outside it walks a contiguous output together with contiguous input, e.g.
+// sum(axis=0) of a row-major [B, F]. Such blocks are reduced a row at a time
+// so the kernel vectorises across the output instead of striding down
+// columns.
+template <typename T> inline bool is_column_reduction(const ReductionPlan &p) {
+   if (p.loop.size() < 2) {
+      return false;
+   }
+   const auto step = static_cast<int64_t>(sizeof(T));
+   const LoopDim &rows = p.loop.back();
+   const LoopDim &cols = p.loop[p.loop.size() - 2];
+   return rows.kind == LoopKind::Reduction &&
+          cols.kind == LoopKind::Independent && rows.stride_bytes[0] == 0 &&
+          rows.stride_bytes[1] > step && rows.stride_bytes[1] % step == 0 &&
+          cols.stride_bytes[0] == step && cols.stride_bytes[1] == step;
+}
+
+// `scale` multiplies every output (1/n for a mean) as the sums are stored,
+// so no second pass runs over the result. Sums are linear, so a run that
+// adds into an output several times scales each partial sum it adds.
 template <typename T, class Tag, class TensorT>
-void reduction_tag(const TensorT &A, ReductionMeta &meta, TensorT &out_data) {
+void reduction_tag(const TensorT &A, ReductionMeta &meta, TensorT &out_data,
+                   SumMode mode = SumMode::Pairwise, T scale = T(1)) {
 
    auto *out = reinterpret_cast<T *>(out_data.get_ptr());
    std::fill(out, out + out_data.flat_size(), T{0});
@@ -257,12 +286,16 @@ void reduction_tag(const TensorT &A, ReductionMeta &meta, TensorT &out_data) {
        reinterpret_cast<uint8_t *>(const_cast<T *>(out)),
        reinterpret_cast<uint8_t *>(const_cast<T *>(A.get_ptr())),
    };
+   FUSION_CHECK((std::is_same_v<Tag, SumSIMD>) || scale == T(1),
+                "reduction_tag: only sums can be scaled");
 
    if (meta.fastpath) {
       auto *o = reinterpret_cast<T *>(base[0]);
       const auto *a = reinterpret_cast<const T *>(base[1]);
       const size_t len = meta.fast_len;
-      if constexpr (simd_traits<Tag, T>::available) {
+      if constexpr (std::is_same_v<Tag, SumSIMD>) {
+         *o = scale * fusion::reduce::tree_sum(a, len, mode);
+      } else if constexpr (simd_traits<Tag, T>::available) {
          *o += simd_traits<Tag, T>::reduce_contiguous(a, len);
       } else {
          tag_fallback_reduction<T, Tag>(o, a, 1, 1, len);
@@ -270,6 +303,41 @@ void reduction_tag(const TensorT &A, ReductionMeta &meta, TensorT &out_data) {
       return;
    }
 
+   if constexpr (requires {
+                    simd_traits<Tag, T>::reduce_columns(out, out, 1, 1, 1);
+                 }) {
+      // The column kernel folds rows straight into out, uncompensated. A
+      // scaled sum takes it only when each output is finished by one call,
+      // so the block can be scaled while it is still in cache.
+      const auto reductions = std::count_if(
+          meta.plan.loop.begin(), meta.plan.loop.end(),
+          [](const LoopDim &d) { return d.kind == LoopKind::Reduction; });
+      if (mode != SumMode::Compensated && is_column_reduction<T>(meta.plan) &&
+          (scale == T(1) || reductions == 1)) {
+         // Walk everything but the last two loops; each call reduces a
+         // [rows, cols] block with the reduced axis outside the contiguous
+         // output axis.
+         const auto &rows = meta.plan.loop.back();
+         const int inn = static_cast<int>(meta.plan.loop.size()) - 2;
+         const auto row_stride = static_cast<std::size_t>(
+             rows.stride_bytes[1] / static_cast<int64_t>(sizeof(T)));
+         walk(0, inn, meta.plan, base,
+              [&](std::array<uint8_t *, 2> &p, int64_t cols,
+                  const std::vector<int64_t> &) {
+                 auto *o = reinterpret_cast<T *>(p[0]);
+                 simd_traits<Tag, T>::reduce_columns(
+                     o, reinterpret_cast<const T *>(p[1]), rows.size,
+                     static_cast<std::size_t>(cols), row_stride);
+                 if (scale != T(1)) {
+                    for (int64_t j = 0; j < cols; ++j) {
+                       o[j] *= scale;
+                    }
+                 }
+              });
+         return;
+      }
+   }
+
    for_each_outer_then_inner<ReductionPlan, 2>(
        meta.plan, base,
        [&](std::array<uint8_t *, 2> &p, int64_t len,
@@ -281,7 +349,13 @@ void reduction_tag(const TensorT &A, ReductionMeta &meta, TensorT &out_data) {
           auto *o = reinterpret_cast<T *>(p[0]);
           const auto *a = reinterpret_cast<const T *>(p[1]);
 
-          if constexpr (simd_traits<Tag, T>::available) {
+          if constexpr (std::is_same_v<Tag, SumSIMD>) {
+             if (sbytes[0] == 0 && sbytes[1] == step && len > 0) {
+                *o += scale * fusion::reduce::tree_sum(
+                                  a, static_cast<size_t>(len), mode);
+                return;
+             }
+          } else if constexpr (simd_traits<Tag, T>::available) {
              if (sbytes[0] == 0 && sbytes[1] == step && len > 0) {
                 *o += simd_traits<Tag, T>::reduce_contiguous(
                     a, static_cast<size_t>(len));
@@ -291,23 +365,142 @@ void reduction_tag(const TensorT &A, ReductionMeta &meta, TensorT &out_data) {
 
           const std::int64_t so = sbytes[0] / step;
           const std::int64_t sa = (sbytes[1] == 0) ? 0 : sbytes[1] / step;
+          if (scale != T(1)) {
+             if (so == 0) {
+                T acc{0};
+                tag_fallback_reduction<T, Tag>(&acc, a, 0, sa, len);
+                *o += scale * acc;
+             } else {
+                for (int64_t i = 0; i < len; ++i) {
+                   o[i * so] += scale * a[i * sa];
+                }
+             }
+             return;
+          }
           Tag tag{};
           tag_fallback_reduction<T, Tag>(o, a, so, sa, len);
        });
 }
 
+// Variance (or standard deviation when take_sqrt) over the reduced axes of
+// `meta`, written to out. Each output keeps a Welford state: contiguous runs
+// are folded in as exact two-pass leaf moments and merged with Chan's update,
+// strided runs element by element, so the input is read once.
+template <typename T, class TensorT>
+void variance_tag(const TensorT &A, ReductionMeta &meta, TensorT &out_data,
+                  std::size_t correction, bool take_sqrt) {
+   using State = fusion::reduce::WelfordState<fusion::accum_t<T>>;
+
+   auto *out = reinterpret_cast<T *>(out_data.get_ptr());
+   const std::size_t out_n = out_data.flat_size();
+   auto finish = [&](const State &st) {
+      const auto v = st.variance(correction);
+      return T(take_sqrt ? std::sqrt(v) : v);
+   };
+
+   if (meta.fastpath) {
+      out[0] = finish(fusion::reduce::tree_moments(A.get_ptr(), meta.fast_len));
+      return;
+   }
+
+   std::vector<State> state(out_n);
+   std::array<uint8_t *, 2> base = {
+       reinterpret_cast<uint8_t *>(out),
+       reinterpret_cast<uint8_t *>(const_cast<T *>(A.get_ptr())),
+   };
+
+   for_each_outer_then_inner<ReductionPlan, 2>(
+       meta.plan, base,
+       [&](std::array<uint8_t *, 2> &p, int64_t len,
+           const std::vector<int64_t> &sbytes) {
+          const auto step = static_cast<int64_t>(sizeof(T));
+          const std::int64_t so = sbytes[0] / step;
+          const std::int64_t sa = sbytes[1] / step;
+          const auto idx = static_cast<std::size_t>(
+              reinterpret_cast<T *>(p[0]) - out);
+          const auto *a = reinterpret_cast<const T *>(p[1]);
+
+          if (so == 0 && sa == 1) {
+             state[idx].merge(fusion::reduce::leaf_moments(
+                 a, static_cast<std::size_t>(len)));
+          } else if (so == 0) {
+             for (int64_t i = 0; i < len; ++i) {
+                state[idx].add(a[i * sa]);
+             }
+          } else {
+             for (int64_t i = 0; i < len; ++i) {
+                state[idx + static_cast<std::size_t>(i * so)].add(a[i * sa]);
+             }
+          }
+       });
+
+   for (std::size_t i = 0; i < out_n; ++i) {
+      out[i] = finish(state[i]);
+   }
+}
+
+// Runs a level-1/2 plan through BLAS when the library takes it, else
+// through the native SIMD kernel. `scale` is (alpha, beta), or alpha alone
+// for axpy, which accumulates.
+template <typename T, class Tag, class Desc, class... Scale>
+inline void level12_tag(const T *A, const T *B, T *C, const Desc &d,
+                        Scale... scale) {
+   if constexpr (fusion::blas::blas_traits<Tag, T>::available) {
+      if (fusion::blas::blas_traits<Tag, T>::can_execute(d)) {
+         fusion::blas::blas_traits<Tag, T>::execute(A, B, C, d, scale...);
+         return;
+      }
+   }
+   fusion::blas::native::execute<T>(A, B, C, d, scale...);
+}
+
+// out = A . B, or out += A . B (beta = 1 on every path) when accumulate is
+// set, so a caller summing products into a live buffer needs no temporary.
 template <typename T, class BlasTag, class ScalarTag, class TensorT>
 void contraction_tag(const TensorT &A, const TensorT &B, ContractionMeta &meta,
-                     TensorT &out_data) {
+                     TensorT &out_data, const bool accumulate = false) {
 
    auto *out = reinterpret_cast<T *>(out_data.get_ptr());
-   std::fill(out, out + out_data.flat_size(), T{0});
+   // The axpy and walker paths add into out, so it starts at zero unless
+   // accumulating; the other paths take beta instead.
+   if (!accumulate) {
+      std::fill(out, out + out_data.flat_size(), T{0});
+   }
+   const T beta = accumulate ? T(1) : T(0);
 
    // “fast path” for contraction = “whole plan matches BLAS contract”
    //    std::cout << "Meta fastpath trigger " << meta.fastpath << std::endl;
    //    std::cout << "availible trigger " << fusion::blas::blas_traits<BlasTag,
    //    T>::available << std::endl; std::cout << "Gemm Like trigger " <<
    //    meta.plan.gemm_like << std::endl;
+   // Tiny GEMMs cost less than a BLAS call's setup: run them inline.
+   if (meta.plan.gemm_like &&
+       fusion::blas::small::can_execute(meta.plan.gemm)) {
+      fusion::blas::small::execute(reinterpret_cast<const T *>(A.get_ptr()),
+                                   reinterpret_cast<const T *>(B.get_ptr()),
+                                   out, meta.plan.gemm, accumulate);
+      return;
+   }
+
+   // Matrix-vector, dot and scaled-add shapes skip the GEMM machinery.
+   if (meta.plan.gemm_like && meta.plan.kind != ContractionKind::Gemm) {
+      const T *a = reinterpret_cast<const T *>(A.get_ptr());
+      const T *b = reinterpret_cast<const T *>(B.get_ptr());
+      switch (meta.plan.kind) {
+      case ContractionKind::Gemv:
+         level12_tag<T, GemvBLAS>(a, b, out, meta.plan.gemv, T(1), beta);
+         return;
+      case ContractionKind::Dot:
+         level12_tag<T, DotBLAS>(a, b, out, meta.plan.dot, T(1), beta);
+         return;
+      case ContractionKind::Axpy:
+         level12_tag<T, AxpyBLAS>(a, b, out, meta.plan.axpy, T(1));
+         return;
+      case ContractionKind::Gemm:
+         break;
+      }
+   }
+
    if constexpr (fusion::blas::blas_traits<BlasTag, T>::available) {
       if (meta.plan.gemm_like) {
          const auto &g = meta.plan.gemm;
@@ -315,9 +508,43 @@ void contraction_tag(const TensorT &A, const TensorT &B, ContractionMeta &meta,
             const T *baseA = reinterpret_cast<const T *>(A.get_ptr());
             const T *baseB = reinterpret_cast<const T *>(B.get_ptr());
             T *baseC = reinterpret_cast<T *>(out_data.get_ptr());
-            fusion::blas::blas_traits<BlasTag, T>::execute(baseA, baseB, baseC,
-                                                           g, T(1), T(0));
-            return;
+            if (g.outer_batch.empty()) {
+               fusion::blas::blas_traits<BlasTag, T>::execute(
+                   baseA, baseB, baseC, g, T(1), beta);
+               return;
+            }
+            // Batch loops outside the strided run: one call per index.
+            const std::size_t nd = g.outer_batch.size();
+            std::vector<std::size_t> idx(nd, 0);
+            std::array<std::int64_t, 3> off{0, 0, 0};
+            while (true) {
+               fusion::blas::blas_traits<BlasTag, T>::execute(
+                   reinterpret_cast<const T *>(
+                       reinterpret_cast<const uint8_t *>(baseA) + off[1]),
+                   reinterpret_cast<const T *>(
+                       reinterpret_cast<const uint8_t *>(baseB) + off[2]),
+                   reinterpret_cast<T *>(reinterpret_cast<uint8_t *>(baseC) +
+                                         off[0]),
+                   g, T(1), beta);
+               std::size_t d = nd;
+               while (d-- > 0) {
+                  const LoopDim &ld = g.outer_batch[d];
+                  for (std::size_t q = 0; q < 3; ++q) {
+                     off[q] += ld.stride_bytes[q];
+                  }
+                  if (++idx[d] < ld.size) {
+                     break;
+                  }
+                  for (std::size_t q = 0; q < 3; ++q) {
+                     off[q] -= ld.stride_bytes[q] *
+                               static_cast<std::int64_t>(ld.size);
+                  }
+                  idx[d] = 0;
+               }
+               if (d == static_cast<std::size_t>(-1)) {
+                  return;
+               }
+            }
          }
       }
    }
@@ -342,8 +569,24 @@ void contraction_tag(const TensorT &A, const TensorT &B, ContractionMeta &meta,
           const int64_t sa = (sbytes[1] == 0) ? 0 : (sbytes[1] / step);
           const int64_t sb = (sbytes[2] == 0) ? 0 : (sbytes[2] / step);
 
-          tag_fallback_contraction<T, ScalarTag>(o, a, b, so, sa, sb,
-                                                 (std::size_t)len);
+          const auto n = static_cast<std::size_t>(len);
+          if constexpr (std::is_same_v<ScalarTag, MultiplySIMD>) {
+             // The innermost loop is a reduction (a dot) or scales one
+             // operand by a fixed element of the other (an axpy).
+             if (so == 0) {
+                *o += fusion::blas::native::dot<T>(n, a, sa, b, sb);
+                return;
+             }
+             if (sb == 0) {
+                fusion::blas::native::axpy<T>(n, *b, a, sa, o, so);
+                return;
+             }
+             if (sa == 0) {
+                fusion::blas::native::axpy<T>(n, *a, b, sb, o, so);
+                return;
+             }
+          }
+          tag_fallback_contraction<T, ScalarTag>(o, a, b, so, sa, sb, n);
        });
 }
 
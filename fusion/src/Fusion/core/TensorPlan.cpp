@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
@@ -125,9 +126,27 @@ build_broadcast_ir_right_aligned(const std::vector<TensorDescription> &descs) {
    return ir;
 }
 
+std::vector<std::size_t>
+normalise_reduction_axes(const std::vector<std::size_t> &axes,
+                         std::size_t ndims) {
+   std::vector<std::size_t> out;
+   if (axes.empty()) {
+      out.resize(ndims);
+      for (std::size_t d = 0; d < ndims; ++d)
+         out[d] = d;
+      return out;
+   }
+   out.reserve(axes.size());
+   for (std::size_t ax : axes)
+      out.push_back(norm_axis(static_cast<std::int64_t>(ax), ndims));
+   std::sort(out.begin(), out.end());
+   out.erase(std::unique(out.begin(), out.end()), out.end());
+   return out;
+}
+
 inline IndexSpaceIR
 build_reduction_ir(const std::vector<TensorDescription> &descs,
-                   std::size_t axis, bool keepdim) {
+                   const std::vector<std::size_t> &axes, bool keepdim) {
    validate_descs_same_itemsize(descs);
    if (descs.size() < 2)
       throw std::runtime_error("reduction: expected at least {out, in}");
@@ -141,19 +160,32 @@ build_reduction_ir(const std::vector<TensorDescription> &descs,
          throw std::runtime_error("reduction: input operand rank mismatch");
    }
 
+   std::vector<bool> reduced(in_nd, false);
+   for (std::size_t ax : axes) {
+      if (ax >= in_nd)
+         throw std::runtime_error("reduction: axis out of range");
+      reduced[ax] = true;
+   }
+
    if (keepdim) {
       if (out_desc.ndims != in_nd)
          throw std::runtime_error(
              "reduction: keepdim expects out_ndims == in_ndims");
-      if (out_desc.shape[axis] != 1)
-         throw std::runtime_error(
-             "reduction: keepdim expects out.shape[axis] == 1");
+      for (std::size_t ax : axes) {
+         if (out_desc.shape[ax] != 1)
+            throw std::runtime_error(
+                "reduction: keepdim expects out.shape[axis] == 1");
+      }
    } else {
       if (in_nd == 0)
          throw std::runtime_error(
              "reduction: cannot reduce scalar with keepdim=false");
-      if (out_desc.ndims != in_nd - 1)
-         throw std::runtime_error("reduction: out_ndims must be in_ndims-1");
+      // Reducing every axis still yields a {1} tensor.
+      const std::size_t expect =
+          (axes.size() == in_nd) ? 1 : in_nd - axes.size();
+      if (out_desc.ndims != expect)
+         throw std::runtime_error(
+             "reduction: out_ndims must be in_ndims - len(axes)");
    }
 
    IndexSpaceIR ir;
@@ -163,28 +195,21 @@ build_reduction_ir(const std::vector<TensorDescription> &descs,
    ir.indices.resize(in_nd);
 
    ir.out_indices.clear();
-   ir.out_indices.reserve(keepdim ? (in_nd - 1) : (in_nd - 1));
-
-   auto out_axis_for_in_axis = [&](std::size_t in_ax) -> std::int32_t {
-      if (keepdim) {
-         return static_cast<std::int32_t>(in_ax);
-      } else {
-         if (in_ax == axis)
-            return -1;
-         if (in_ax < axis)
-            return static_cast<std::int32_t>(in_ax);
-         return static_cast<std::int32_t>(in_ax - 1);
-      }
-   };
+   ir.out_indices.reserve(in_nd - axes.size());
 
+   std::int32_t next_out_axis = 0;
    for (std::size_t in_ax = 0; in_ax < in_nd; ++in_ax) {
       IndexDef idx;
       idx.extent = in_desc.shape[in_ax];
       idx.kind =
-          (in_ax == axis) ? IndexKind::Reduction : IndexKind::Independent;
+          reduced[in_ax] ? IndexKind::Reduction : IndexKind::Independent;
       idx.axis_of_operand.assign(ir.num_operands, -1);
 
-      idx.axis_of_operand[0] = out_axis_for_in_axis(in_ax);
+      if (keepdim) {
+         idx.axis_of_operand[0] = static_cast<std::int32_t>(in_ax);
+      } else if (!reduced[in_ax]) {
+         idx.axis_of_operand[0] = next_out_axis++;
+      }
 
       for (std::size_t op = 1; op < ir.num_operands; ++op) {
          idx.axis_of_operand[op] = static_cast<std::int32_t>(in_ax);
@@ -192,7 +217,7 @@ build_reduction_ir(const std::vector<TensorDescription> &descs,
 
       ir.indices[in_ax] = std::move(idx);
 
-      if (in_ax != axis) {
+      if (!reduced[in_ax]) {
          ir.out_indices.push_back(static_cast<std::uint32_t>(in_ax));
       }
    }
@@ -373,35 +398,76 @@ BroadcastPlan make_broadcast_plan(const std::vector<TensorDescription> &descs) {
    return plan;
 }
 
+// Merges loop i into loop i+1 when stepping loop i is the same as running
+// loop i+1 to its end for every operand (and both are the same kind).
+static void coalesce_loops(std::vector<LoopDim> &loops,
+                           std::size_t num_operands) {
+   std::vector<LoopDim> merged;
+   merged.reserve(loops.size());
+   for (LoopDim &ld : loops) {
+      if (ld.size == 1 && !merged.empty())
+         continue;
+      if (!merged.empty()) {
+         LoopDim &outer = merged.back();
+         bool fuse = outer.kind == ld.kind || outer.size == 1;
+         for (std::size_t op = 0; fuse && op < num_operands; ++op) {
+            fuse = outer.size == 1 ||
+                   outer.stride_bytes[op] ==
+                       ld.stride_bytes[op] * static_cast<std::int64_t>(ld.size);
+         }
+         if (fuse) {
+            ld.size *= outer.size;
+            merged.back() = std::move(ld);
+            continue;
+         }
+      }
+      merged.push_back(std::move(ld));
+   }
+   loops = std::move(merged);
+}
+
 ReductionPlan make_reduction_plan(const std::vector<TensorDescription> &descs,
                                   std::size_t axis, bool keepdim) {
    if (descs.size() < 2)
       throw std::runtime_error("reduction: expected at least {out, in}");
+   return make_reduction_plan(descs, std::vector<std::size_t>{axis}, keepdim);
+}
+
+ReductionPlan make_reduction_plan(const std::vector<TensorDescription> &descs,
+                                  const std::vector<std::size_t> &axes,
+                                  bool keepdim) {
+   if (descs.size() < 2)
+      throw std::runtime_error("reduction: expected at least {out, in}");
 
    const TensorDescription &in_desc = descs.back();
    const std::size_t in_nd = in_desc.ndims;
-   const std::size_t ax = norm_axis(static_cast<std::int64_t>(axis), in_nd);
+   std::vector<std::size_t> red_axes = normalise_reduction_axes(axes, in_nd);
 
-   IndexSpaceIR ir = build_reduction_ir(descs, ax, keepdim);
+   IndexSpaceIR ir = build_reduction_ir(descs, red_axes, keepdim);
 
    ReductionPlan plan;
    plan.num_operands = descs.size();
    plan.itemsize = ir.itemsize;
    plan.keep_dim = keepdim;
-   plan.reduction_axis = ax;
 
    plan.out_ndim = descs[0].ndims;
    plan.out_shape = descs[0].shape;
 
+   // Independent axes outermost, reduced axes innermost: each output element
+   // is then finished by one contiguous run over the input when the reduced
+   // axes are trailing.
    std::vector<std::uint32_t> loop_order;
    loop_order.reserve(ir.indices.size());
 
    for (std::uint32_t id : ir.out_indices)
       loop_order.push_back(id);
 
-   loop_order.push_back(static_cast<std::uint32_t>(ax));
+   for (std::size_t ax : red_axes)
+      loop_order.push_back(static_cast<std::uint32_t>(ax));
 
    plan.loop = lower_to_loops(ir, descs, loop_order);
+   coalesce_loops(plan.loop, plan.num_operands);
+   plan.reduction_axes = std::move(red_axes);
 
    return plan;
 }
@@ -548,6 +614,177 @@ contig_elem_strides_local(const std::vector<std::size_t> &shape) {
    return st;
 }
 
+// How a (rows x cols) operand with element strides (rs, cs) can be handed to
+// a row-major GEMM: as-is with leading dimension rs, or, when it is laid out
+// column-major (a transposed view), with op = Trans and leading dimension cs.
+// Extent-1 axes may carry any stride.
+static bool gemm_operand_layout(const std::int64_t rs, const std::int64_t cs,
+                                const std::size_t rows, const std::size_t cols,
+                                bool &transpose, std::int64_t &ld) {
+   const auto r = static_cast<std::int64_t>(rows);
+   const auto c = static_cast<std::int64_t>(cols);
+   if ((cs == 1 || c == 1) && (r == 1 || rs >= c)) {
+      transpose = false;
+      ld = (r == 1) ? std::max<std::int64_t>(c, 1) : rs;
+      return true;
+   }
+   if ((rs == 1 || r == 1) && (c == 1 || cs >= r)) {
+      transpose = true;
+      ld = (c == 1) ? std::max<std::int64_t>(r, 1) : cs;
+      return true;
+   }
+   return false;
+}
+
+// Folds every loop of `role` into the innermost one where operands p and q
+// (the two that carry the axis) address it as one longer strided axis, e.g.
+// the batch and row axes of a [B, T, K] operand whose weight has no batch
+// become a single M of B * T. A loop that cannot be folded is handed to the
+// batch unless it is a K loop, which has no other home.
+static bool fold_gemm_axis(std::vector<LoopDim> &loops, const LoopRole role,
+                           const std::size_t p, const std::size_t q) {
+   LoopDim *inner = nullptr;
+   std::size_t extent = 1;
+   for (auto it = loops.rbegin(); it != loops.rend(); ++it) {
+      if (it->role != role) {
+         continue;
+      }
+      if (inner == nullptr) {
+         inner = &*it;
+         extent = it->size;
+         continue;
+      }
+      if (it->size == 1) {
+         it->role = LoopRole::Batch;
+         continue;
+      }
+      const auto e = static_cast<std::int64_t>(extent);
+      const bool folds =
+          it->stride_bytes[p] == inner->stride_bytes[p] * e &&
+          it->stride_bytes[q] == inner->stride_bytes[q] * e;
+      if (folds) {
+         extent *= it->size;
+         it->size = 1;
+         it->role = LoopRole::Batch;
+      } else if (role == LoopRole::K) {
+         return false;
+      } else {
+         it->role = LoopRole::Batch;
+      }
+   }
+   if (inner != nullptr) {
+      inner->size = extent;
+   }
+   return true;
+}
+
+// Splits the batch loops of a GEMM-like plan into an inner run that a single
+// strided batched call covers (each operand's entries a fixed element stride
+// apart; a broadcast operand has stride 0) and the outer loops left over.
+static void collapse_batch_loops(const std::vector<LoopDim> &loop,
+                                 const std::size_t itemsize,
+                                 GemmLikeDesc &g) {
+   const auto item = static_cast<std::int64_t>(itemsize);
+   std::array<std::int64_t, 3> stride{0, 0, 0};
+   std::array<std::int64_t, 3> next{0, 0, 0};
+   g.batch = 1;
+   g.outer_batch.clear();
+   bool collapsing = true;
+   for (auto it = loop.rbegin(); it != loop.rend(); ++it) {
+      if (it->role != LoopRole::Batch || it->size == 1) {
+         continue;
+      }
+      if (collapsing && g.batch > 1) {
+         for (std::size_t q = 0; q < 3; ++q) {
+            collapsing = collapsing && it->stride_bytes[q] / item == next[q];
+         }
+      }
+      if (!collapsing) {
+         g.outer_batch.insert(g.outer_batch.begin(), *it);
+         continue;
+      }
+      for (std::size_t q = 0; q < 3; ++q) {
+         if (g.batch == 1) {
+            stride[q] = it->stride_bytes[q] / item;
+         }
+         next[q] = stride[q] * static_cast<std::int64_t>(g.batch * it->size);
+      }
+      g.batch *= it->size;
+   }
+   g.out_bs = stride[0];
+   g.a_bs = stride[1];
+   g.b_bs = stride[2];
+}
+
+// Picks the level-1/2 call a GEMM-like plan degenerates to, if any:
+//   M = N = 1           dot of the two K vectors
+//   K = 1, M or N = 1   axpy of a vector by the other operand's one element
+//   M or N = 1          gemv with whichever operand is the matrix
+// Only plans whose batch is one strided run qualify.
+static void classify_contraction(ContractionPlan &plan) {
+   const GemmLikeDesc &g = plan.gemm;
+   plan.kind = ContractionKind::Gemm;
+   if (!g.outer_batch.empty() || (g.M > 1 && g.N > 1)) {
+      return;
+   }
+
+   if (g.M == 1 && g.N == 1) {
+      if (g.K == 1) {
+         return;
+      }
+      DotLikeDesc &d = plan.dot;
+      d.batch = g.batch;
+      d.n = g.K;
+      d.a_inc = g.a_cs;
+      d.b_inc = g.b_rs;
+      d.a_bs = g.a_bs;
+      d.b_bs = g.b_bs;
+      d.out_bs = g.out_bs;
+      plan.kind = ContractionKind::Dot;
+      return;
+   }
+
+   if (g.K == 1) {
+      AxpyLikeDesc &d = plan.axpy;
+      d.batch = g.batch;
+      d.x_is_a = g.N == 1;
+      d.n = d.x_is_a ? g.M : g.N;
+      d.x_inc = d.x_is_a ? g.a_rs : g.b_cs;
+      d.y_inc = d.x_is_a ? g.out_rs : g.out_cs;
+      d.x_bs = d.x_is_a ? g.a_bs : g.b_bs;
+      d.alpha_bs = d.x_is_a ? g.b_bs : g.a_bs;
+      d.y_bs = g.out_bs;
+      plan.kind = ContractionKind::Axpy;
+      return;
+   }
+
+   // out[M] = A[M x K] b[K], or out[N] = a[K] B[K x N] = B^T a.
+   GemvLikeDesc &d = plan.gemv;
+   d.batch = g.batch;
+   d.mat_is_a = g.N == 1;
+   if (d.mat_is_a) {
+      d.rows = g.a_transpose ? g.K : g.M;
+      d.cols = g.a_transpose ? g.M : g.K;
+      d.ld = g.lda;
+      d.transpose = g.a_transpose;
+      d.x_inc = g.b_rs;
+      d.y_inc = g.out_rs;
+      d.mat_bs = g.a_bs;
+      d.x_bs = g.b_bs;
+   } else {
+      d.rows = g.b_transpose ? g.N : g.K;
+      d.cols = g.b_transpose ? g.K : g.N;
+      d.ld = g.ldb;
+      d.transpose = !g.b_transpose;
+      d.x_inc = g.a_cs;
+      d.y_inc = g.out_cs;
+      d.mat_bs = g.b_bs;
+      d.x_bs = g.a_bs;
+   }
+   d.y_bs = g.out_bs;
+   plan.kind = ContractionKind::Gemv;
+}
+
 ContractionPlan
 make_contraction_plan_einsum_out(const std::vector<TensorDescription> &descs,
                                  const EinsumBinding &binding) {
@@ -594,13 +831,22 @@ make_contraction_plan_einsum_out(const std::vector<TensorDescription> &descs,
    plan.gemm_like = true;
    plan.gemm = GemmLikeDesc{};
 
-   std::size_t batch = 1, M = 1, N = 1, K = 1;
+   // Folding rewrites sizes and roles, so it works on a copy; the generic
+   // walker keeps the plan's own loops.
+   std::vector<LoopDim> loops = plan.loop;
+   if (!fold_gemm_axis(loops, LoopRole::M, 0, 1) ||
+       !fold_gemm_axis(loops, LoopRole::N, 0, 2) ||
+       !fold_gemm_axis(loops, LoopRole::K, 1, 2)) {
+      plan.gemm_like = false;
+      return plan;
+   }
+
+   std::size_t M = 1, N = 1, K = 1;
    int m_count = 0, n_count = 0, k_count = 0;
 
-   for (const auto &ld : plan.loop) {
+   for (const auto &ld : loops) {
       switch (ld.role) {
       case LoopRole::Batch:
-         batch *= ld.size;
          break;
       case LoopRole::M:
          M = ld.size;
@@ -617,12 +863,13 @@ make_contraction_plan_einsum_out(const std::vector<TensorDescription> &descs,
       }
    }
 
-   if (!(m_count == 1 && n_count == 1 && k_count == 1)) {
+   // A role with no loop is an extent-1 axis: "ik,k->i" is a GEMM with
+   // N = 1, "i,j->ij" one with K = 1.
+   if (m_count > 1 || n_count > 1 || k_count > 1) {
       plan.gemm_like = false;
       return plan;
    }
 
-   plan.gemm.batch = batch;
    plan.gemm.M = M;
    plan.gemm.N = N;
    plan.gemm.K = K;
@@ -633,7 +880,7 @@ make_contraction_plan_einsum_out(const std::vector<TensorDescription> &descs,
    std::int64_t a_m = 0, a_k = 0;
    std::int64_t b_k = 0, b_n = 0;
 
-   for (const auto &ld : plan.loop) {
+   for (const auto &ld : loops) {
       if (ld.role == LoopRole::M) {
          out_m = static_cast<std::int64_t>(ld.stride_bytes[0]) / item;
          a_m = static_cast<std::int64_t>(ld.stride_bytes[1]) / item;
@@ -655,12 +902,37 @@ make_contraction_plan_einsum_out(const std::vector<TensorDescription> &descs,
    plan.gemm.b_rs = b_k;
    plan.gemm.b_cs = b_n;
 
-   if (plan.gemm.out_rs == 0 || plan.gemm.out_cs == 0 || plan.gemm.a_rs == 0 ||
-       plan.gemm.a_cs == 0 || plan.gemm.b_rs == 0 || plan.gemm.b_cs == 0) {
+   bool out_trans = false;
+   const bool layout_ok =
+       gemm_operand_layout(out_m, out_n, M, N, out_trans, plan.gemm.ldc) &&
+       !out_trans &&
+       gemm_operand_layout(a_m, a_k, M, K, plan.gemm.a_transpose,
+                           plan.gemm.lda) &&
+       gemm_operand_layout(b_k, b_n, K, N, plan.gemm.b_transpose,
+                           plan.gemm.ldb);
+   if (!layout_ok) {
       plan.gemm_like = false;
       return plan;
    }
 
+   plan.gemm.out_is_contig_mn = plan.gemm.ldc == static_cast<std::int64_t>(N);
+   plan.gemm.a_is_contig_mk =
+       !plan.gemm.a_transpose && plan.gemm.lda == static_cast<std::int64_t>(K);
+   plan.gemm.b_is_contig_kn =
+       !plan.gemm.b_transpose && plan.gemm.ldb == static_cast<std::int64_t>(N);
+
+   // A batch loop the output does not index would need the calls to
+   // accumulate; leave that to the walker.
+   for (const auto &ld : loops) {
+      if (ld.role == LoopRole::Batch && ld.size > 1 &&
+          ld.stride_bytes[0] == 0) {
+         plan.gemm_like = false;
+         return plan;
+      }
+   }
+   collapse_batch_loops(loops, plan.itemsize, plan.gemm);
+   classify_contraction(plan);
+
    return plan;
 }
 
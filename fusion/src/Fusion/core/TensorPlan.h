@@ -75,6 +75,18 @@ struct GemmLikeDesc {
    std::int64_t a_rs{0}, a_cs{0};
    std::int64_t b_rs{0}, b_cs{0};
 
+   // Leading dimensions as BLAS sees them after any transpose, and the
+   // element stride between consecutive batch entries of each operand.
+   std::int64_t lda{0}, ldb{0}, ldc{0};
+   std::int64_t a_bs{0}, b_bs{0}, out_bs{0};
+
+   // Batch loops that do not fold into the strided run above (e.g. a batch
+   // axis broadcast in one operand between two that are not); the executor
+   // walks them and issues one batched call per outer index.
+   std::vector<LoopDim> outer_batch;
+
+   // Operand is stored column-major in its (rows, cols) pair, e.g. a
+   // swapaxes view of a row-major matrix: passed to BLAS as op = Trans.
    bool a_transpose{false};
    bool b_transpose{false};
    bool out_is_contig_mn{false};
@@ -82,11 +94,44 @@ struct GemmLikeDesc {
    bool b_is_contig_kn{false};
 };
 
+// GEMM-like plans with a degenerate M, N or K; BLAS serves these with
+// level-1/2 calls instead of a GEMM that would have a single row or column.
+enum class ContractionKind { Gemm, Gemv, Dot, Axpy };
+
+// y = op(mat) x, mat stored row-major as rows x cols with leading dimension
+// ld; mat_is_a says which operand it is, the other one is x.
+struct GemvLikeDesc {
+   std::size_t batch{1};
+   std::size_t rows{0}, cols{0};
+   std::int64_t ld{0};
+   bool transpose{false};
+   bool mat_is_a{true};
+   std::int64_t x_inc{0}, y_inc{0};
+   std::int64_t mat_bs{0}, x_bs{0}, y_bs{0};
+};
+
+// out = sum_i a[i] b[i].
+struct DotLikeDesc {
+   std::size_t batch{1};
+   std::size_t n{0};
+   std::int64_t a_inc{0}, b_inc{0};
+   std::int64_t a_bs{0}, b_bs{0}, out_bs{0};
+};
+
+// y += alpha x, alpha being the single element of the other operand.
+struct AxpyLikeDesc {
+   std::size_t batch{1};
+   std::size_t n{0};
+   bool x_is_a{true};
+   std::int64_t x_inc{0}, y_inc{0};
+   std::int64_t x_bs{0}, alpha_bs{0}, y_bs{0};
+};
+
 struct ReductionPlan {
    std::size_t num_operands;
    std::size_t out_ndim;
    std::vector<std::size_t> out_shape;
-   std::size_t reduction_axis;
+   std::vector<std::size_t> reduction_axes; // sorted, unique
    std::vector<LoopDim> loop;
 
    bool keep_dim{false};
@@ -106,14 +151,35 @@ struct ContractionPlan {
    bool gemm_like{false};
    GemmLikeDesc gemm;
 
+   // Set when gemm_like; the desc of the matching kind is filled in.
+   ContractionKind kind{ContractionKind::Gemm};
+   GemvLikeDesc gemv;
+   DotLikeDesc dot;
+   AxpyLikeDesc axpy;
+
    std::size_t itemsize{0};
 };
 
 BroadcastPlan make_broadcast_plan(const std::vector<TensorDescription> &descs);
 
+// Normalises reduction axes against `ndims`: negative values (passed through
+// size_t) count from the back, duplicates are dropped and the result is
+// sorted. An empty list means every axis.
+std::vector<std::size_t>
+normalise_reduction_axes(const std::vector<std::size_t> &axes,
+                         std::size_t ndims);
+
 ReductionPlan make_reduction_plan(const std::vector<TensorDescription> &desc,
                                   const std::size_t axis, const bool keepdim);
 
+// Reduces every axis in `axes` in one pass. Independent axes are walked
+// outermost and reduced axes innermost (in input order), then adjacent loops
+// that are contiguous in every operand are merged, so e.g. a sum over the
+// trailing (H, W) of a contiguous tensor becomes one SIMD-friendly loop.
+ReductionPlan make_reduction_plan(const std::vector<TensorDescription> &desc,
+                                  const std::vector<std::size_t> &axes,
+                                  const bool keepdim);
+
 ContractionPlan
 make_contraction_plan_einsum(const std::vector<TensorDescription> &inputs,
                              const EinsumBinding &binding);
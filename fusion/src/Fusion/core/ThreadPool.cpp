@@ -2,6 +2,17 @@
 
 #include <stdexcept>
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "Fusion/common/Log.hpp"
+
+namespace {
+thread_local bool t_on_worker_thread = false;
+} // namespace
+
 JoinThreads::JoinThreads(std::vector<std::thread> &threads)
     : threads_(threads) {}
 
@@ -13,13 +24,15 @@ JoinThreads::~JoinThreads() {
    }
 }
 
-ThreadPool::ThreadPool() : done_(false), join_threads_(threads_) {
+ThreadPool::ThreadPool() : ThreadPool(std::thread::hardware_concurrency()) {}
 
-   const unsigned thread_count = std::thread::hardware_concurrency();
+ThreadPool::ThreadPool(std::size_t thread_count, std::vector<int> cpu_affinity)
+    : done_(false), cpu_affinity_(std::move(cpu_affinity)),
+      join_threads_(threads_) {
 
    try {
-      for (unsigned i = 0; i < thread_count; ++i) {
-         threads_.emplace_back(&ThreadPool::worker_thread, this);
+      for (std::size_t i = 0; i < thread_count; ++i) {
+         threads_.emplace_back(&ThreadPool::worker_thread, this, i);
       }
    } catch (...) {
       done_ = true;
@@ -30,10 +43,42 @@ ThreadPool::ThreadPool() : done_(false), join_threads_(threads_) {
 ThreadPool::~ThreadPool() { done_ = true; }
 
 void ThreadPool::submit(std::function<void()> task) {
-   queue_.push(std::move(task));
+   if (threads_.empty() || !queue_.try_push(std::move(task))) {
+      task();
+   }
+}
+
+bool ThreadPool::run_pending_task() {
+   std::function<void()> task;
+   if (!queue_.try_pop(task)) {
+      return false;
+   }
+   task();
+   return true;
+}
+
+bool ThreadPool::on_worker_thread() noexcept { return t_on_worker_thread; }
+
+void ThreadPool::pin_worker(std::size_t index) const {
+   if (cpu_affinity_.empty()) {
+      return;
+   }
+   const int cpu = cpu_affinity_[index % cpu_affinity_.size()];
+#if defined(__linux__)
+   cpu_set_t set;
+   CPU_ZERO(&set);
+   CPU_SET(cpu, &set);
+   if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+      FUSION_LOGW("ThreadPool: failed to pin worker ", index, " to cpu ", cpu);
+   }
+#else
+   (void)cpu;
+#endif
 }
 
-void ThreadPool::worker_thread() {
+void ThreadPool::worker_thread(std::size_t index) {
+   t_on_worker_thread = true;
+   pin_worker(index);
    while (!done_) {
       std::function<void()> task;
       if (queue_.try_pop(task)) {
@@ -2,11 +2,12 @@
 #define THREAD_POOL_H
 
 #include <atomic>
+#include <cstddef>
 #include <functional>
 #include <thread>
 #include <vector>
 
-#include "ThreadSafeQueue.hpp"
+#include "MPMCQueue.hpp"
 
 // RAII helper: joins all threads on destruction
 class JoinThreads {
@@ -24,19 +25,39 @@ class JoinThreads {
 class ThreadPool {
  public:
    ThreadPool();
+   // thread_count workers; worker i is pinned to
+   // cpu_affinity[i % cpu_affinity.size()] when the list is non-empty
+   // (Linux only, ignored elsewhere).
+   explicit ThreadPool(std::size_t thread_count,
+                       std::vector<int> cpu_affinity = {});
    ~ThreadPool();
 
    ThreadPool(const ThreadPool &) = delete;
    ThreadPool &operator=(const ThreadPool &) = delete;
 
    // Non-templated public API
+   // Runs the task inline on the caller when the pool has no workers or its
+   // queue is full, so submitting never blocks.
    void submit(std::function<void()> task);
 
+   // Pops and runs one queued task on the calling thread. Lets a thread that
+   // waits on pool work help drain the queue instead of idling.
+   bool run_pending_task();
+
+   std::size_t size() const noexcept { return threads_.size(); }
+
+   // True when called from any ThreadPool worker.
+   static bool on_worker_thread() noexcept;
+
  private:
-   void worker_thread();
+   void worker_thread(std::size_t index);
+   void pin_worker(std::size_t index) const;
+
+   static constexpr std::size_t kQueueCapacity = 4096;
 
    std::atomic_bool done_{false};
-   ThreadSafeQueue<std::function<void()>> queue_;
+   MPMCQueue<std::function<void()>> queue_{kQueueCapacity};
+   std::vector<int> cpu_affinity_;
    std::vector<std::thread> threads_;
    JoinThreads join_threads_;
 };
@@ -0,0 +1,198 @@
+#ifndef TREE_REDUCE_HPP
+#define TREE_REDUCE_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "Fusion/core/Float16.hpp"
+#include "Fusion/cpu/simd/SimdTags.hpp"
+#include "Fusion/cpu/simd/SimdTraits.hpp"
+
+#include "Parallel.h"
+
+// How a global sum accumulates.
+//   Pairwise:    SIMD leaf sums combined pairwise. Error grows with log(n)
+//                instead of n.
+//   Compensated: Neumaier-compensated leaves and combine; roughly 2x the work
+//                for an error independent of n.
+enum class SumMode { Pairwise, Compensated };
+
+namespace fusion::reduce {
+
+// Leaf size of the reduction tree. Fixed, so the chunk boundaries and the
+// combine order - and therefore the bits of the result - do not depend on
+// how many threads run the leaves.
+constexpr std::size_t kTreeChunk = 16384;
+
+// Leaves, partial states and the combine all run in accum_t<T>, so 16-bit
+// inputs are only rounded once, when the caller stores the result.
+
+template <typename T> struct CompensatedSum {
+   T sum{0};
+   T comp{0};
+
+   // Neumaier's variant of Kahan summation: also correct when the addend is
+   // larger than the running sum.
+   void add(T x) {
+      const T t = sum + x;
+      if (std::abs(sum) >= std::abs(x)) {
+         comp += (sum - t) + x;
+      } else {
+         comp += (x - t) + sum;
+      }
+      sum = t;
+   }
+
+   void merge(const CompensatedSum &other) {
+      add(other.sum);
+      comp += other.comp;
+   }
+
+   T value() const { return sum + comp; }
+};
+
+// One leaf of the tree, reduced serially on the calling thread.
+template <typename T>
+inline CompensatedSum<accum_t<T>> leaf_sum(const T *a, std::size_t n,
+                                           SumMode mode) {
+   CompensatedSum<accum_t<T>> acc;
+   if (mode == SumMode::Compensated) {
+      for (std::size_t i = 0; i < n; ++i) {
+         acc.add(a[i]);
+      }
+   } else {
+      acc.sum = simd_traits<SumSIMD, T>::reduce_contiguous(a, n);
+   }
+   return acc;
+}
+
+// Sum of a[0..n). Leaves of kTreeChunk elements are reduced in parallel into
+// fixed slots, then folded pairwise (slot i += slot i + w for w = 1, 2, 4..)
+// on the caller: the same input always gives the same bits.
+template <typename T>
+inline accum_t<T> tree_sum(const T *a, std::size_t n,
+                           SumMode mode = SumMode::Pairwise) {
+   if (n <= kTreeChunk) {
+      return leaf_sum(a, n, mode).value();
+   }
+
+   const std::size_t chunks = (n + kTreeChunk - 1) / kTreeChunk;
+   std::vector<CompensatedSum<accum_t<T>>> partial(chunks);
+   fusion::parallel::parallel_for(
+       0, chunks, 1, [&](std::size_t lo, std::size_t hi) {
+          for (std::size_t c = lo; c < hi; ++c) {
+             const std::size_t begin = c * kTreeChunk;
+             const std::size_t len =
+                 (n - begin < kTreeChunk) ? n - begin : kTreeChunk;
+             partial[c] = leaf_sum(a + begin, len, mode);
+          }
+       });
+
+   for (std::size_t w = 1; w < chunks; w *= 2) {
+      for (std::size_t i = 0; i + w < chunks; i += 2 * w) {
+         if (mode == SumMode::Compensated) {
+            partial[i].merge(partial[i + w]);
+         } else {
+            partial[i].sum += partial[i + w].sum;
+         }
+      }
+   }
+   return partial[0].value();
+}
+
+// Running count/mean/sum of squared deviations (Welford). Partial states
+// combine with Chan's parallel update, so chunks can be reduced
+// independently and merged without a second pass over the data.
+template <typename T> struct WelfordState {
+   std::size_t count{0};
+   T mean{0};
+   T m2{0};
+
+   void add(T x) {
+      ++count;
+      const T d = x - mean;
+      mean += d / static_cast<T>(count);
+      m2 += d * (x - mean);
+   }
+
+   void merge(const WelfordState &other) {
+      if (other.count == 0) {
+         return;
+      }
+      if (count == 0) {
+         *this = other;
+         return;
+      }
+      const std::size_t n = count + other.count;
+      const T na = static_cast<T>(count);
+      const T nb = static_cast<T>(other.count);
+      const T d = other.mean - mean;
+      mean += d * (nb / static_cast<T>(n));
+      m2 += other.m2 + d * d * (na * nb / static_cast<T>(n));
+      count = n;
+   }
+
+   // Population variance for correction 0, sample variance for 1.
+   T variance(std::size_t correction) const {
+      if (count <= correction) {
+         return std::numeric_limits<T>::quiet_NaN();
+      }
+      return m2 / static_cast<T>(count - correction);
+   }
+};
+
+// Moments of a contiguous run. The run is small enough to stay in cache, so
+// an exact two-pass (SIMD sum, then squared deviations) is cheaper than a
+// per-element Welford update with its division.
+template <typename T>
+inline WelfordState<accum_t<T>> leaf_moments(const T *a, std::size_t n) {
+   using A = accum_t<T>;
+   WelfordState<A> st;
+   if (n == 0) {
+      return st;
+   }
+   st.count = n;
+   st.mean = simd_traits<SumSIMD, T>::reduce_contiguous(a, n) /
+             static_cast<A>(n);
+   A m2 = A(0);
+   for (std::size_t i = 0; i < n; ++i) {
+      const A d = static_cast<A>(a[i]) - st.mean;
+      m2 += d * d;
+   }
+   st.m2 = m2;
+   return st;
+}
+
+// Moments of a[0..n) with the same fixed leaves and combine order as
+// tree_sum, so the result does not depend on the thread count.
+template <typename T>
+inline WelfordState<accum_t<T>> tree_moments(const T *a, std::size_t n) {
+   if (n <= kTreeChunk) {
+      return leaf_moments(a, n);
+   }
+
+   const std::size_t chunks = (n + kTreeChunk - 1) / kTreeChunk;
+   std::vector<WelfordState<accum_t<T>>> partial(chunks);
+   fusion::parallel::parallel_for(
+       0, chunks, 1, [&](std::size_t lo, std::size_t hi) {
+          for (std::size_t c = lo; c < hi; ++c) {
+             const std::size_t begin = c * kTreeChunk;
+             const std::size_t len =
+                 (n - begin < kTreeChunk) ? n - begin : kTreeChunk;
+             partial[c] = leaf_moments(a + begin, len);
+          }
+       });
+
+   for (std::size_t w = 1; w < chunks; w *= 2) {
+      for (std::size_t i = 0; i + w < chunks; i += 2 * w) {
+         partial[i].merge(partial[i + w]);
+      }
+   }
+   return partial[0];
+}
+
+} // namespace fusion::reduce
+
+#endif // TREE_REDUCE_HPP
@@ -2,25 +2,61 @@
 #define FUSION_CPU_BLAS_FALLBACK_HPP
 
 #include <cstddef>
+#include <cstdint>
+
+#include "PackedGemm.hpp"
+#include "VectorKernels.hpp"
 
 namespace fusion::blas::backend {
 
+// Native GEMM used when no BLAS library backs the build: packed, cache
+// blocked and register blocked (PackedGemm.hpp).
+template <typename T>
+inline void gemm_rowmajor(bool trans_a, bool trans_b, int m, int n, int k,
+                          T alpha, const T *A, int lda, const T *B, int ldb,
+                          T beta, T *C, int ldc) {
+   packed::gemm<T>(trans_a, trans_b, m, n, k, alpha, A, lda, B, ldb, beta, C,
+                   ldc);
+}
+
 template <typename T>
 inline void gemm_rowmajor_nn(const T *A, const T *B, T *C, int m, int n, int k,
                              T alpha, T beta) {
-   for (int i = 0; i < m; ++i) {
-      for (int j = 0; j < n; ++j) {
-         T acc = T(0);
-         const T *arow = A + i * k;
-         const T *bcol = B + j; // stride n
-         for (int p = 0; p < k; ++p) {
-            acc += arow[p] * bcol[p * n];
-         }
-         C[i * n + j] = alpha * acc + beta * C[i * n + j];
-      }
+   gemm_rowmajor(false, false, m, n, k, alpha, A, k, B, n, beta, C, n);
+}
+
+template <typename T>
+inline void batched_gemm_rowmajor(bool trans_a, bool trans_b, int m, int n,
+                                  int k, T alpha, const T *baseA, int lda,
+                                  std::int64_t a_bs, const T *baseB, int ldb,
+                                  std::int64_t b_bs, T beta, T *baseC, int ldc,
+                                  std::int64_t c_bs, std::size_t batch) {
+   for (std::size_t b = 0; b < batch; ++b) {
+      const auto i = static_cast<std::int64_t>(b);
+      gemm_rowmajor(trans_a, trans_b, m, n, k, alpha, baseA + i * a_bs, lda,
+                    baseB + i * b_bs, ldb, beta, baseC + i * c_bs, ldc);
    }
 }
 
+template <typename T>
+inline void gemv_rowmajor(bool trans, int rows, int cols, T alpha, const T *A,
+                          int lda, const T *x, int incx, T beta, T *y,
+                          int incy) {
+   native::gemv<T>(trans, static_cast<std::size_t>(rows),
+                   static_cast<std::size_t>(cols), alpha, A, lda, x, incx,
+                   beta, y, incy);
+}
+
+template <typename T>
+inline T dot(int n, const T *x, int incx, const T *y, int incy) {
+   return native::dot<T>(static_cast<std::size_t>(n), x, incx, y, incy);
+}
+
+template <typename T>
+inline void axpy(int n, T alpha, const T *x, int incx, T *y, int incy) {
+   native::axpy<T>(static_cast<std::size_t>(n), alpha, x, incx, y, incy);
+}
+
 template <typename T>
 inline void batched_gemm_rowmajor_nn(const T *baseA, const T *baseB, T *baseC,
                                      int m, int n, int k, std::size_t batch,
@@ -7,5 +7,6 @@ struct BatchedGemmBLAS {};
 struct GemmBLAS {};
 struct GemvBLAS {};
 struct DotBLAS {};
+struct AxpyBLAS {};
 
 #endif
@@ -1,11 +1,17 @@
 #ifndef FUSION_CPU_BLAS_TRAITS_HPP
 #define FUSION_CPU_BLAS_TRAITS_HPP
 
-#include <iostream>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <type_traits>
 
+#include "Fusion/core/Float16.hpp"
+#include "Fusion/core/Parallel.h"
 #include "Fusion/core/TensorPlan.h" // GemmLikeDesc
 #include "Fusion/cpu/blas/BlasTags.hpp"
+#include "Fusion/cpu/blas/PackedGemm.hpp"
 #include "Fusion/cpu/blas/backend/Gemm.hpp"
 
 namespace fusion::blas {
@@ -20,51 +26,163 @@ template <class Tag, typename T> struct blas_traits {
    }
 };
 
-// ------------------- Batched GEMM (row-major NN contiguous)
-// -------------------
+// ------------------- Batched GEMM (row-major, op(A) op(B)) -----------------
 template <typename T> struct blas_traits<BatchedGemmBLAS, T> {
-   static constexpr bool available = std::is_same_v<T, float>;
+   static constexpr bool available = blas_precision<T>;
 
    static bool can_execute(const GemmLikeDesc &g) {
       if constexpr (!available)
          return false;
 
-      const bool no_trans = (!g.a_transpose && !g.b_transpose);
+      // The planner only leaves gemm_like set when every operand maps onto
+      // (op, leading dimension); what is left is the int range of the API.
+      // EXPECTING ELEMENT STRIDES (not bytes).
+      constexpr auto kMax =
+          static_cast<std::int64_t>(std::numeric_limits<int>::max());
+      const bool fits = static_cast<std::int64_t>(g.M) <= kMax &&
+                        static_cast<std::int64_t>(g.N) <= kMax &&
+                        static_cast<std::int64_t>(g.K) <= kMax &&
+                        g.lda <= kMax && g.ldb <= kMax && g.ldc <= kMax;
+      return fits && g.lda > 0 && g.ldb > 0 && g.ldc > 0;
+   }
 
-      // EXPECTING ELEMENT STRIDES (not bytes):
-      // Row-major contiguous:
-      //   C[M,N]: cs=1, rs=N
-      //   A[M,K]: cs=1, rs=K
-      //   B[K,N]: cs=1, rs=N
-      const bool out_rowmajor_contig =
-          (g.out_cs == 1) && (g.out_rs == static_cast<std::int64_t>(g.N));
+   static void execute(const T *A, const T *B, T *C, const GemmLikeDesc &g,
+                       T alpha, T beta) {
+      // Assumes can_execute(g) was true.
+      batched_gemm_rowmajor<T>(
+          g.a_transpose, g.b_transpose, static_cast<int>(g.M),
+          static_cast<int>(g.N), static_cast<int>(g.K), alpha, A,
+          static_cast<int>(g.lda), g.a_bs, B, static_cast<int>(g.ldb), g.b_bs,
+          beta, C, static_cast<int>(g.ldc), g.out_bs,
+          static_cast<std::size_t>(g.batch));
+   }
+};
 
-      const bool a_rowmajor_contig =
-          (g.a_cs == 1) && (g.a_rs == static_cast<std::int64_t>(g.K));
+// 16-bit operands go through the native kernel, which widens A and B as it
+// packs them: products and sums are fp32, C is only read when beta != 0 and
+// is rounded once. Batches are spread as batched_gemm_rowmajor spreads them.
+template <HalfFloat H> struct blas_traits<BatchedGemmBLAS, H> {
+   using F = blas_traits<BatchedGemmBLAS, float>;
+
+   static constexpr bool available = F::available;
+
+   static bool can_execute(const GemmLikeDesc &g) { return F::can_execute(g); }
+
+   static void execute(const H *A, const H *B, H *C, const GemmLikeDesc &g,
+                       H alpha, H beta) {
+      const auto m = static_cast<int>(g.M);
+      const auto n = static_cast<int>(g.N);
+      const auto k = static_cast<int>(g.K);
+      auto run = [&](std::size_t lo, std::size_t hi) {
+         for (std::size_t b = lo; b < hi; ++b) {
+            const auto i = static_cast<std::int64_t>(b);
+            packed::gemm_widened<float>(
+                g.a_transpose, g.b_transpose, m, n, k, float(alpha),
+                A + i * g.a_bs, static_cast<int>(g.lda), B + i * g.b_bs,
+                static_cast<int>(g.ldb), float(beta), C + i * g.out_bs,
+                static_cast<int>(g.ldc));
+         }
+      };
+      const auto batch = static_cast<std::size_t>(g.batch);
+      if (choose_batched_gemm_strategy(m, n, k, batch,
+                                       fusion::parallel::max_concurrency()) ==
+          BatchedGemmStrategy::Sequential) {
+         run(0, batch);
+         return;
+      }
+      const std::size_t volume =
+          std::max<std::size_t>(g.M * g.N * g.K, 1);
+      fusion::parallel::parallel_for(
+          0, batch,
+          std::max<std::size_t>(kBatchTaskVolume / volume, 1), run);
+   }
+};
 
-      const bool b_rowmajor_contig =
-          (g.b_cs == 1) && (g.b_rs == static_cast<std::int64_t>(g.N));
+// Level-1/2 calls take int sizes and, for vectors, positive increments
+// (a negative one would walk the vector from its far end).
+inline bool blas_int_range(std::size_t n) {
+   return n <= static_cast<std::size_t>(std::numeric_limits<int>::max());
+}
 
-      const bool ok = no_trans && out_rowmajor_contig && a_rowmajor_contig &&
-                      b_rowmajor_contig;
+inline bool blas_increment(std::int64_t inc) {
+   return inc > 0 && inc <= std::numeric_limits<int>::max();
+}
 
-      //      std::cout << "can_execute=" << ok << " no_trans=" << no_trans
-      //                << " out(cs,rs)=(" << g.out_cs << "," << g.out_rs << ")"
-      //                << " a(cs,rs)=(" << g.a_cs << "," << g.a_rs << ")"
-      //                << " b(cs,rs)=(" << g.b_cs << "," << g.b_rs << ")"
-      //                << " (elem strides)"
-      //                << " N=" << g.N << " K=" << g.K << "\n";
+// ------------------- GEMV (row-major, op(A) x) -----------------------------
+template <typename T> struct blas_traits<GemvBLAS, T> {
+   static constexpr bool available = blas_precision<T>;
 
-      return ok;
+   static bool can_execute(const GemvLikeDesc &d) {
+      if constexpr (!available)
+         return false;
+      const auto min_ld =
+          static_cast<std::int64_t>(std::max<std::size_t>(d.cols, 1));
+      return blas_int_range(d.rows) && blas_int_range(d.cols) &&
+             d.ld >= min_ld && d.ld <= std::numeric_limits<int>::max() &&
+             blas_increment(d.x_inc) && blas_increment(d.y_inc);
    }
 
-   static void execute(const T *A, const T *B, T *C, const GemmLikeDesc &g,
+   static void execute(const T *A, const T *B, T *C, const GemvLikeDesc &d,
                        T alpha, T beta) {
-      // Assumes can_execute(g) was true.
-      batched_gemm_rowmajor_nn<T>(A, B, C, static_cast<int>(g.M),
-                                  static_cast<int>(g.N), static_cast<int>(g.K),
-                                  static_cast<std::size_t>(g.batch), alpha,
-                                  beta);
+      const T *mat = d.mat_is_a ? A : B;
+      const T *x = d.mat_is_a ? B : A;
+      for (std::size_t b = 0; b < d.batch; ++b) {
+         const auto i = static_cast<std::int64_t>(b);
+         backend::gemv_rowmajor(
+             d.transpose, static_cast<int>(d.rows), static_cast<int>(d.cols),
+             alpha, mat + i * d.mat_bs, static_cast<int>(d.ld), x + i * d.x_bs,
+             static_cast<int>(d.x_inc), beta, C + i * d.y_bs,
+             static_cast<int>(d.y_inc));
+      }
+   }
+};
+
+// ------------------- DOT ---------------------------------------------------
+template <typename T> struct blas_traits<DotBLAS, T> {
+   static constexpr bool available = blas_precision<T>;
+
+   static bool can_execute(const DotLikeDesc &d) {
+      if constexpr (!available)
+         return false;
+      return blas_int_range(d.n) && blas_increment(d.a_inc) &&
+             blas_increment(d.b_inc);
+   }
+
+   static void execute(const T *A, const T *B, T *C, const DotLikeDesc &d,
+                       T alpha, T beta) {
+      for (std::size_t b = 0; b < d.batch; ++b) {
+         const auto i = static_cast<std::int64_t>(b);
+         T &out = C[i * d.out_bs];
+         const T v = alpha * backend::dot(static_cast<int>(d.n), A + i * d.a_bs,
+                                          static_cast<int>(d.a_inc),
+                                          B + i * d.b_bs,
+                                          static_cast<int>(d.b_inc));
+         out = (beta == T(0)) ? v : v + beta * out;
+      }
+   }
+};
+
+// ------------------- AXPY (accumulates into C) -----------------------------
+template <typename T> struct blas_traits<AxpyBLAS, T> {
+   static constexpr bool available = blas_precision<T>;
+
+   static bool can_execute(const AxpyLikeDesc &d) {
+      if constexpr (!available)
+         return false;
+      return blas_int_range(d.n) && blas_increment(d.x_inc) &&
+             blas_increment(d.y_inc);
+   }
+
+   static void execute(const T *A, const T *B, T *C, const AxpyLikeDesc &d,
+                       T alpha) {
+      const T *x = d.x_is_a ? A : B;
+      const T *s = d.x_is_a ? B : A;
+      for (std::size_t b = 0; b < d.batch; ++b) {
+         const auto i = static_cast<std::int64_t>(b);
+         backend::axpy(static_cast<int>(d.n), alpha * s[i * d.alpha_bs],
+                       x + i * d.x_bs, static_cast<int>(d.x_inc),
+                       C + i * d.y_bs, static_cast<int>(d.y_inc));
+      }
    }
 };
 
@@ -0,0 +1,229 @@
+#ifndef FUSION_CPU_BLAS_GEMM_EPILOGUE_HPP
+#define FUSION_CPU_BLAS_GEMM_EPILOGUE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+#include "Fusion/core/Float16.hpp"
+#include "Fusion/core/Parallel.h"
+#include "Fusion/ops/OpParams.hpp" // Activation
+
+#include "PackedGemm.hpp"
+#include "SmallGemm.hpp"
+#include "backend/Gemm.hpp"
+
+// GEMM followed by a per-element epilogue (bias broadcast, activation)
+// applied to each block of C right after it is computed, instead of as
+// separate passes over the finished output. The native kernel calls the
+// epilogue per macro block from the task that produced it; BLAS is called
+// on row panels sized to stay in L2, each finished by the epilogue before
+// the next panel starts.
+namespace fusion::blas::epilogue {
+
+// Bytes of C per BLAS row panel: the panel is still in L2 when the epilogue
+// reads it back.
+constexpr std::size_t kPanelBytes = std::size_t{256} << 10;
+// Fewer rows than this per BLAS call and the call overhead dominates.
+constexpr std::size_t kMinPanelRows = 16;
+// Elements per task of the standalone activation passes.
+constexpr std::size_t kActivationGrain = std::size_t{1} << 15;
+
+// GELU, tanh approximation: 0.5 z (1 + tanh(sqrt(2 / pi) (z + 0.044715 z^3))).
+constexpr double kGeluScale = 0.7978845608028654;
+constexpr double kGeluCubic = 0.044715;
+
+template <Activation A, typename T> inline T activate(T z) {
+   if constexpr (A == Activation::ReLU) {
+      return z > T(0) ? z : T(0);
+   } else if constexpr (A == Activation::GELU) {
+      const T u = T(kGeluScale) * (z + T(kGeluCubic) * z * z * z);
+      return T(0.5) * z * (T(1) + std::tanh(u));
+   } else if constexpr (A == Activation::Tanh) {
+      return std::tanh(z);
+   } else {
+      return z;
+   }
+}
+
+// d act(z) / dz, given z and y = act(z); ReLU and tanh only need y.
+template <Activation A, typename T> inline T activate_grad(T z, T y) {
+   if constexpr (A == Activation::ReLU) {
+      return y > T(0) ? T(1) : T(0);
+   } else if constexpr (A == Activation::GELU) {
+      const T u = T(kGeluScale) * (z + T(kGeluCubic) * z * z * z);
+      const T t = std::tanh(u);
+      const T du = T(kGeluScale) * (T(1) + T(3 * kGeluCubic) * z * z);
+      return T(0.5) * (T(1) + t) + T(0.5) * z * (T(1) - t * t) * du;
+   } else if constexpr (A == Activation::Tanh) {
+      return T(1) - y * y;
+   } else {
+      return T(1);
+   }
+}
+
+// Whether the backward pass needs the pre-activation, not just the output.
+inline bool needs_pre_activation(Activation act) {
+   return act == Activation::GELU;
+}
+
+// Runs f with the activation as a compile-time constant, so the element
+// loops are specialised (and vectorised where the function allows).
+template <class F> inline void with_activation(Activation act, F &&f) {
+   switch (act) {
+   case Activation::ReLU:
+      return f(std::integral_constant<Activation, Activation::ReLU>{});
+   case Activation::GELU:
+      return f(std::integral_constant<Activation, Activation::GELU>{});
+   case Activation::Tanh:
+      return f(std::integral_constant<Activation, Activation::Tanh>{});
+   case Activation::None:
+      break;
+   }
+   f(std::integral_constant<Activation, Activation::None>{});
+}
+
+// C = act(C + bias), bias broadcast along the rows. When pre is set the
+// pre-activation C + bias is kept there too, pre_ld apart per row. The
+// block may be fp32 scratch for a 16-bit C (gemm_widened), U its type.
+template <typename T> struct BiasActivation {
+   const T *bias = nullptr;
+   Activation act = Activation::None;
+   T *pre = nullptr;
+   std::size_t pre_ld = 0;
+
+   template <typename U>
+   void operator()(std::size_t row, std::size_t col, std::size_t rows,
+                   std::size_t cols, U *C, std::size_t ldc) const {
+      with_activation(act, [&](auto a) {
+         constexpr Activation A = decltype(a)::value;
+         for (std::size_t i = 0; i < rows; ++i) {
+            U *c = C + i * ldc;
+            if (bias != nullptr) {
+               const T *b = bias + col;
+               for (std::size_t j = 0; j < cols; ++j) {
+                  c[j] += b[j];
+               }
+            }
+            if (pre != nullptr) {
+               std::copy(c, c + cols, pre + (row + i) * pre_ld + col);
+            }
+            if constexpr (A != Activation::None) {
+               for (std::size_t j = 0; j < cols; ++j) {
+                  c[j] = activate<A>(c[j]);
+               }
+            }
+         }
+      });
+   }
+};
+
+// C = op(A) op(B) (alpha = 1, beta = 0), then epi over all of C.
+template <typename T, class Epilogue>
+   requires(!is_half_float_v<T>)
+void gemm(bool trans_a, bool trans_b, int m, int n, int k, const T *A,
+          int lda, const T *B, int ldb, T *C, int ldc, const Epilogue &epi) {
+   if (m <= 0 || n <= 0) {
+      return;
+   }
+   const auto M = static_cast<std::size_t>(m);
+   const auto N = static_cast<std::size_t>(n);
+   const auto K = static_cast<std::size_t>(std::max(k, 0));
+   const auto ld = static_cast<std::size_t>(ldc);
+
+   if (small::fits(trans_a, trans_b, M, N, K)) {
+      small::gemm<T>(trans_a, trans_b, M, N, K, A, lda, B, ldb, C, ldc);
+      epi(0, 0, M, N, C, ld);
+      return;
+   }
+
+#if !defined(FUSION_NATIVE_GEMM)
+   if constexpr (blas_precision<T>) {
+      const std::size_t rows = std::min(
+          M, std::max(kMinPanelRows, kPanelBytes / (N * sizeof(T))));
+      const std::size_t panels = (M + rows - 1) / rows;
+      auto run_panel = [&](std::size_t p) {
+         const std::size_t r0 = p * rows;
+         const std::size_t mr = std::min(rows, M - r0);
+         const auto a_off = static_cast<std::int64_t>(r0) *
+                            static_cast<std::int64_t>(trans_a ? 1 : lda);
+         backend::gemm_rowmajor(trans_a, trans_b, static_cast<int>(mr), n, k,
+                                T(1), A + a_off, lda, B, ldb, T(0),
+                                C + r0 * ld, ldc);
+         epi(r0, 0, mr, N, C + r0 * ld, ld);
+      };
+
+      const std::size_t threads = fusion::parallel::max_concurrency();
+      if (panels >= threads && threads > 1) {
+         // One single-threaded BLAS call per panel, panels over the pool.
+         std::optional<fusion::parallel::BlasThreadScope> blas;
+         if (!fusion::parallel::in_parallel_region()) {
+            blas.emplace(1);
+         }
+         fusion::parallel::parallel_for(
+             0, panels, 1, [&](std::size_t lo, std::size_t hi) {
+                for (std::size_t p = lo; p < hi; ++p) {
+                   run_panel(p);
+                }
+             });
+         return;
+      }
+      // Too few panels to go round: BLAS threads each one itself.
+      for (std::size_t p = 0; p < panels; ++p) {
+         run_panel(p);
+      }
+      return;
+   }
+#endif
+
+   packed::gemm<T>(trans_a, trans_b, m, n, k, T(1), A, lda, B, ldb, T(0), C,
+                   ldc, epi);
+}
+
+// 16-bit operands: the native kernel widens A and B as it packs them and
+// runs epi on each fp32 block before narrowing it, so C is rounded once.
+// Without an epilogue small shapes keep the small kernel, which also
+// accumulates in fp32 and rounds once.
+template <HalfFloat H, class Epilogue>
+void gemm(bool trans_a, bool trans_b, int m, int n, int k, const H *A,
+          int lda, const H *B, int ldb, H *C, int ldc, const Epilogue &epi) {
+   if (m <= 0 || n <= 0) {
+      return;
+   }
+   const auto M = static_cast<std::size_t>(m);
+   const auto N = static_cast<std::size_t>(n);
+   const auto K = static_cast<std::size_t>(std::max(k, 0));
+
+   if constexpr (std::is_same_v<Epilogue, packed::NoEpilogue>) {
+      if (small::fits(trans_a, trans_b, M, N, K)) {
+         small::gemm<H>(trans_a, trans_b, M, N, K, A, lda, B, ldb, C, ldc);
+         return;
+      }
+   }
+   packed::gemm_widened<float>(trans_a, trans_b, m, n, k, 1.0f, A, lda, B,
+                               ldb, 0.0f, C, ldc, epi);
+}
+
+// dz = g * act'(z) over n elements in one pass; y = act(z) is the forward
+// output, z the pre-activation (read only when needs_pre_activation).
+template <typename T>
+void activation_backward(Activation act, std::size_t n, const T *g,
+                         const T *y, const T *z, T *dz) {
+   with_activation(act, [&](auto a) {
+      constexpr Activation A = decltype(a)::value;
+      fusion::parallel::parallel_for(
+          0, n, kActivationGrain, [&](std::size_t lo, std::size_t hi) {
+             for (std::size_t i = lo; i < hi; ++i) {
+                const T zi = (z != nullptr) ? z[i] : T(0);
+                dz[i] = g[i] * activate_grad<A>(zi, y[i]);
+             }
+          });
+   });
+}
+
+} // namespace fusion::blas::epilogue
+
+#endif // FUSION_CPU_BLAS_GEMM_EPILOGUE_HPP
@@ -0,0 +1,39 @@
+#ifndef FUSION_CPU_BLAS_NATIVE_BACKEND_HPP
+#define FUSION_CPU_BLAS_NATIVE_BACKEND_HPP
+
+#include "Fusion/core/Float16.hpp"
+#include "Fusion/cpu/simd/backend/BackendConcept.hpp"
+#include "Fusion/cpu/simd/backend/BackendVecExt.hpp"
+
+#if defined(FUSION_ENABLE_NEON) && defined(__ARM_NEON)
+#include "Fusion/cpu/simd/VecNeon128.hpp"
+#endif
+
+namespace fusion::blas {
+
+// Vector backend for the native BLAS kernels: the hand-written NEON backend
+// where there is one, the compiler's vector extension elsewhere.
+#if defined(FUSION_ENABLE_NEON) && defined(__ARM_NEON)
+template <typename T> struct native_backend {
+   using type = VecExt<T, kNativeVectorBytes>;
+};
+template <> struct native_backend<float> {
+   using type = Neon128<float>;
+};
+#else
+template <typename T> struct native_backend {
+   using type = VecExt<T, kNativeVectorBytes>;
+};
+#endif
+
+// 16-bit types are widened to float before they reach a vector kernel.
+template <HalfFloat H> struct native_backend<H> {
+   using type = typename native_backend<float>::type;
+};
+
+template <typename T>
+using NativeBackend = typename native_backend<T>::type;
+
+} // namespace fusion::blas
+
+#endif // FUSION_CPU_BLAS_NATIVE_BACKEND_HPP
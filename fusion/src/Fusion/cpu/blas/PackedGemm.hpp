@@ -0,0 +1,504 @@
+#ifndef FUSION_CPU_BLAS_PACKED_GEMM_HPP
+#define FUSION_CPU_BLAS_PACKED_GEMM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "Fusion/core/Float16.hpp"
+#include "Fusion/core/Parallel.h"
+#include "Fusion/cpu/simd/Convert.hpp"
+
+#include "NativeBackend.hpp"
+
+// BLIS-style GEMM for builds without a BLAS library.
+//
+//   for jc in N step NC            B block [KC x NC] packed once, shared
+//     for pc in K step KC
+//       for ic in M step MC        in parallel; A block [MC x KC] packed
+//         for jr in NC step NR       per task
+//           for ir in MC step MR   MR x NR micro-kernel, C tile in registers
+//
+// Packing copies each block into contiguous, 64-byte aligned panels in the
+// order the micro-kernel reads them, whatever the operand's layout or
+// transpose, so the inner loop only does unit-stride loads. Panels are zero
+// padded to whole MR/NR tiles; edge tiles go through a scratch tile. 16-bit
+// operands are widened to fp32 as they are packed (gemm_widened).
+namespace fusion::blas::packed {
+
+// Register and cache blocking. MR x NR accumulators (12 vectors) fit the 16
+// architectural vector registers of AVX2 and leave room for the B row and
+// the A broadcast; KC x NR of B stays in L1, MC x KC of A in L2, KC x NC of
+// B in L3.
+template <BackendFma B> struct Blocking {
+   static constexpr std::size_t kLanes = B::kLanes;
+   static constexpr std::size_t MR = 6;
+   static constexpr std::size_t NV = 2;
+   static constexpr std::size_t NR = NV * kLanes;
+   static constexpr std::size_t KC = 256;
+   static constexpr std::size_t MC = MR * 24;
+   static constexpr std::size_t NC = 4096;
+};
+
+constexpr std::size_t kPanelAlign = 64;
+
+// Called on each finished [rows x cols] block of C starting at (row, col),
+// by the task that computed it, while the block is still in cache. The
+// block pointer and ldc locate the block itself, which need not live in C
+// (gemm_widened passes its fp32 tile).
+struct NoEpilogue {
+   template <typename T>
+   void operator()(std::size_t, std::size_t, std::size_t, std::size_t, T *,
+                   std::size_t) const {}
+};
+
+// Grow-only 64-byte aligned scratch, reused across calls on a thread.
+template <typename T> class AlignedBuffer {
+ public:
+   T *get(std::size_t n) {
+      if (n > size_) {
+         data_.reset(static_cast<T *>(::operator new[](
+             n * sizeof(T), std::align_val_t{kPanelAlign})));
+         size_ = n;
+      }
+      return data_.get();
+   }
+
+ private:
+   struct Free {
+      void operator()(T *p) const {
+         ::operator delete[](p, std::align_val_t{kPanelAlign});
+      }
+   };
+   std::unique_ptr<T, Free> data_;
+   std::size_t size_ = 0;
+};
+
+// Element (r, c) of a row-major operand, transposed or not, as two steps.
+struct OperandSteps {
+   std::int64_t row;
+   std::int64_t col;
+};
+
+inline OperandSteps operand_steps(bool transpose, int ld) {
+   return transpose ? OperandSteps{1, ld} : OperandSteps{ld, 1};
+}
+
+// A[ic.., pc..] as ceil(mc / MR) panels of [kc x MR], column by column,
+// converted from S to T on the way.
+template <typename T, std::size_t MR, typename S = T>
+void pack_a(std::size_t mc, std::size_t kc, const S *A, OperandSteps s,
+            T *out) {
+   for (std::size_t ir = 0; ir < mc; ir += MR) {
+      const std::size_t mr = std::min(MR, mc - ir);
+      for (std::size_t p = 0; p < kc; ++p) {
+         const S *src = A + static_cast<std::int64_t>(ir) * s.row +
+                        static_cast<std::int64_t>(p) * s.col;
+         std::size_t i = 0;
+         for (; i < mr; ++i) {
+            out[i] = src[static_cast<std::int64_t>(i) * s.row];
+         }
+         for (; i < MR; ++i) {
+            out[i] = T(0);
+         }
+         out += MR;
+      }
+   }
+}
+
+// B[pc.., jc..] as ceil(nc / NR) panels of [kc x NR], row by row,
+// converted from S to T on the way.
+template <typename T, std::size_t NR, typename S = T>
+void pack_b(std::size_t kc, std::size_t nc, const S *B, OperandSteps s,
+            T *out) {
+   for (std::size_t jr = 0; jr < nc; jr += NR) {
+      const std::size_t nr = std::min(NR, nc - jr);
+      for (std::size_t p = 0; p < kc; ++p) {
+         const S *src = B + static_cast<std::int64_t>(p) * s.row +
+                        static_cast<std::int64_t>(jr) * s.col;
+         std::size_t j = 0;
+         if (s.col == 1) {
+            if constexpr (!std::is_same_v<S, T>) {
+               simd::widen(src, out, nr);
+               j = nr;
+            }
+            for (; j < nr; ++j) {
+               out[j] = src[j];
+            }
+         } else {
+            for (; j < nr; ++j) {
+               out[j] = src[static_cast<std::int64_t>(j) * s.col];
+            }
+         }
+         for (; j < NR; ++j) {
+            out[j] = T(0);
+         }
+         out += NR;
+      }
+   }
+}
+
+// C[MR x NR] = alpha * (a_panel . b_panel) + beta * C. beta == 0 never reads
+// C, so uninitialised output is fine.
+template <BackendFma B, typename T>
+inline void micro_kernel(std::size_t kc, const T *__restrict a,
+                         const T *__restrict b, T *__restrict c,
+                         std::size_t ldc, T alpha, T beta) {
+   using vec = typename B::vec;
+   using Blk = Blocking<B>;
+   constexpr std::size_t MR = Blk::MR;
+   constexpr std::size_t NV = Blk::NV;
+   constexpr std::size_t L = Blk::kLanes;
+
+   const vec zero = B::duplicate(T(0));
+   vec acc[MR][NV];
+   for (std::size_t i = 0; i < MR; ++i) {
+      for (std::size_t j = 0; j < NV; ++j) {
+         acc[i][j] = zero;
+      }
+   }
+
+   for (std::size_t p = 0; p < kc; ++p) {
+      vec bv[NV];
+      for (std::size_t j = 0; j < NV; ++j) {
+         bv[j] = B::load(b + j * L);
+      }
+      for (std::size_t i = 0; i < MR; ++i) {
+         const vec av = B::duplicate(a[i]);
+         for (std::size_t j = 0; j < NV; ++j) {
+            acc[i][j] = B::fma(acc[i][j], av, bv[j]);
+         }
+      }
+      a += MR;
+      b += Blk::NR;
+   }
+
+   const vec va = B::duplicate(alpha);
+   const vec vb = B::duplicate(beta);
+   for (std::size_t i = 0; i < MR; ++i) {
+      for (std::size_t j = 0; j < NV; ++j) {
+         T *dst = c + i * ldc + j * L;
+         vec r = B::fma(zero, acc[i][j], va);
+         if (beta != T(0)) {
+            r = B::fma(r, B::load(dst), vb);
+         }
+         B::store(dst, r);
+      }
+   }
+}
+
+// C[mc x nc] += op(A) op(B) over one packed A block and B block.
+template <BackendFma B, typename T>
+void macro_kernel(std::size_t mc, std::size_t nc, std::size_t kc,
+                  const T *a_pack, const T *b_pack, T *C, std::size_t ldc,
+                  T alpha, T beta) {
+   using Blk = Blocking<B>;
+   constexpr std::size_t MR = Blk::MR;
+   constexpr std::size_t NR = Blk::NR;
+   alignas(kPanelAlign) T tile[MR * NR];
+
+   for (std::size_t jr = 0; jr < nc; jr += NR) {
+      const std::size_t nr = std::min(NR, nc - jr);
+      const T *b = b_pack + jr * kc;
+      for (std::size_t ir = 0; ir < mc; ir += MR) {
+         const std::size_t mr = std::min(MR, mc - ir);
+         const T *a = a_pack + ir * kc;
+         T *c = C + ir * ldc + jr;
+         if (mr == MR && nr == NR) {
+            micro_kernel<B>(kc, a, b, c, ldc, alpha, beta);
+            continue;
+         }
+         micro_kernel<B>(kc, a, b, tile, NR, T(1), T(0));
+         for (std::size_t i = 0; i < mr; ++i) {
+            for (std::size_t j = 0; j < nr; ++j) {
+               T &dst = c[i * ldc + j];
+               const T v = alpha * tile[i * NR + j];
+               dst = (beta == T(0)) ? v : v + beta * dst;
+            }
+         }
+      }
+   }
+}
+
+// Elements of op(B) [k x n] packed for every (jc, pc) block gemm visits:
+// each column block is padded to whole NR panels.
+template <typename T, BackendFma B = NativeBackend<T>>
+std::size_t packed_b_size(std::size_t k, std::size_t n) {
+   using Blk = Blocking<B>;
+   return k * (((n + Blk::NR - 1) / Blk::NR) * Blk::NR);
+}
+
+// Offset of block (jc, pc) in a whole-matrix packing: the column blocks
+// before jc are full (NC is a multiple of NR), then pc rows of this one.
+inline std::size_t packed_b_offset(std::size_t k, std::size_t jc,
+                                   std::size_t pc, std::size_t nc_pad) {
+   return jc * k + pc * nc_pad;
+}
+
+// op(B) [k x n] packed once, in the order gemm_prepacked reads it. out holds
+// packed_b_size(k, n) elements.
+template <typename T, BackendFma B = NativeBackend<T>>
+void pack_b_all(bool trans_b, int k, int n, const T *Bm, int ldb, T *out) {
+   using Blk = Blocking<B>;
+   const auto K = static_cast<std::size_t>(std::max(k, 0));
+   const auto N = static_cast<std::size_t>(std::max(n, 0));
+   const OperandSteps sb = operand_steps(trans_b, ldb);
+   for (std::size_t jc = 0; jc < N; jc += Blk::NC) {
+      const std::size_t nc = std::min(Blk::NC, N - jc);
+      const std::size_t nc_pad = ((nc + Blk::NR - 1) / Blk::NR) * Blk::NR;
+      for (std::size_t pc = 0; pc < K; pc += Blk::KC) {
+         const std::size_t kc = std::min(Blk::KC, K - pc);
+         pack_b<T, Blk::NR>(kc, nc,
+                            Bm + static_cast<std::int64_t>(pc) * sb.row +
+                                static_cast<std::int64_t>(jc) * sb.col,
+                            sb, out + packed_b_offset(K, jc, pc, nc_pad));
+      }
+   }
+}
+
+// PackBuffer tags: each kind of scratch has its own cached buffer.
+struct PackedA;
+struct PackedB;
+struct WidenedTile;
+
+// Scratch for packed panels and C tiles. Their owner may still be reading
+// them while the thread runs another gemm: the packing thread waits in
+// parallel_for, where it may run another queued gemm, and an epilogue may
+// start one between blocks. Only the outermost user of a Tag on a thread
+// gets the thread's cached buffer; a nested one gets its own, so it cannot
+// grow or overwrite data still being read.
+template <typename T, class Tag = PackedB> class PackBuffer {
+ public:
+   PackBuffer() : nested_(busy()) { busy() = true; }
+   ~PackBuffer() { busy() = nested_; }
+
+   PackBuffer(const PackBuffer &) = delete;
+   PackBuffer &operator=(const PackBuffer &) = delete;
+
+   T *get(std::size_t n) { return nested_ ? own_.get(n) : cached().get(n); }
+
+ private:
+   static AlignedBuffer<T> &cached() {
+      thread_local AlignedBuffer<T> buffer;
+      return buffer;
+   }
+   static bool &busy() {
+      thread_local bool flag = false;
+      return flag;
+   }
+
+   bool nested_;
+   AlignedBuffer<T> own_;
+};
+
+namespace detail {
+
+// Rows of C per parallel task: enough row blocks to give every thread one,
+// a multiple of MR and at most MC.
+template <BackendFma B> std::size_t row_block(std::size_t M) {
+   using Blk = Blocking<B>;
+   const std::size_t threads = fusion::parallel::max_concurrency();
+   const std::size_t rows_per_thread = (M + threads - 1) / threads;
+   return std::min(Blk::MC,
+                   ((rows_per_thread + Blk::MR - 1) / Blk::MR) * Blk::MR);
+}
+
+// The blocked loop nest of gemm; b_block(jc, pc, kc, nc, nc_pad) yields the
+// packed [kc x nc] block of op(B) at (pc, jc).
+template <typename T, BackendFma B, class Epilogue, class BBlock>
+void gemm_blocked(bool trans_a, int m, int n, int k, T alpha, const T *A,
+                  int lda, BBlock &&b_block, T beta, T *C, int ldc,
+                  const Epilogue &epi) {
+   using Blk = Blocking<B>;
+   if (m <= 0 || n <= 0) {
+      return;
+   }
+   const auto M = static_cast<std::size_t>(m);
+   const auto N = static_cast<std::size_t>(n);
+   const auto K = static_cast<std::size_t>(std::max(k, 0));
+   const auto ldc_ = static_cast<std::size_t>(ldc);
+
+   if (K == 0 || alpha == T(0)) {
+      for (std::size_t i = 0; i < M; ++i) {
+         for (std::size_t j = 0; j < N; ++j) {
+            T &c = C[i * ldc_ + j];
+            c = (beta == T(0)) ? T(0) : beta * c;
+         }
+      }
+      epi(0, 0, M, N, C, ldc_);
+      return;
+   }
+
+   const OperandSteps sa = operand_steps(trans_a, lda);
+   const std::size_t mc_block = row_block<B>(M);
+   const std::size_t row_blocks = (M + mc_block - 1) / mc_block;
+
+   for (std::size_t jc = 0; jc < N; jc += Blk::NC) {
+      const std::size_t nc = std::min(Blk::NC, N - jc);
+      const std::size_t nc_pad = ((nc + Blk::NR - 1) / Blk::NR) * Blk::NR;
+      for (std::size_t pc = 0; pc < K; pc += Blk::KC) {
+         const std::size_t kc = std::min(Blk::KC, K - pc);
+         const T *b_pack = b_block(jc, pc, kc, nc, nc_pad);
+         // Later K blocks accumulate into what the first one wrote.
+         const T beta_k = (pc == 0) ? beta : T(1);
+
+         fusion::parallel::parallel_for(
+             0, row_blocks, 1, [&](std::size_t lo, std::size_t hi) {
+                PackBuffer<T, PackedA> a_buffer;
+                const std::size_t mc_pad =
+                    ((mc_block + Blk::MR - 1) / Blk::MR) * Blk::MR;
+                T *a_pack = a_buffer.get(mc_pad * kc);
+                for (std::size_t blk = lo; blk < hi; ++blk) {
+                   const std::size_t ic = blk * mc_block;
+                   const std::size_t mc = std::min(mc_block, M - ic);
+                   pack_a<T, Blk::MR>(
+                       mc, kc,
+                       A + static_cast<std::int64_t>(ic) * sa.row +
+                           static_cast<std::int64_t>(pc) * sa.col,
+                       sa, a_pack);
+                   macro_kernel<B>(mc, nc, kc, a_pack, b_pack,
+                                   C + ic * ldc_ + jc, ldc_, alpha, beta_k);
+                   if (pc + kc == K) {
+                      epi(ic, jc, mc, nc, C + ic * ldc_ + jc, ldc_);
+                   }
+                }
+             });
+      }
+   }
+}
+
+} // namespace detail
+
+// C = alpha * op(A) op(B) + beta * C, row-major, the same contract as
+// cblas_sgemm(CblasRowMajor, ...), then epi over every block of C.
+template <typename T, BackendFma B = NativeBackend<T>,
+          class Epilogue = NoEpilogue>
+void gemm(bool trans_a, bool trans_b, int m, int n, int k, T alpha,
+          const T *A, int lda, const T *Bm, int ldb, T beta, T *C, int ldc,
+          const Epilogue &epi = Epilogue{}) {
+   const OperandSteps sb = operand_steps(trans_b, ldb);
+   PackBuffer<T> b_buffer;
+   auto pack = [&](std::size_t jc, std::size_t pc, std::size_t kc,
+                   std::size_t nc, std::size_t nc_pad) -> const T * {
+      T *b_pack = b_buffer.get(nc_pad * kc);
+      pack_b<T, Blocking<B>::NR>(kc, nc,
+                                 Bm + static_cast<std::int64_t>(pc) * sb.row +
+                                     static_cast<std::int64_t>(jc) * sb.col,
+                                 sb, b_pack);
+      return b_pack;
+   };
+   detail::gemm_blocked<T, B>(trans_a, m, n, k, alpha, A, lda, pack, beta, C,
+                              ldc, epi);
+}
+
+// gemm with op(B) [k x n] already packed by pack_b_all, so repeated calls
+// against the same B (inference weights) skip packing it.
+template <typename T, BackendFma B = NativeBackend<T>,
+          class Epilogue = NoEpilogue>
+void gemm_prepacked(bool trans_a, int m, int n, int k, T alpha, const T *A,
+                    int lda, const T *b_packed, T beta, T *C, int ldc,
+                    const Epilogue &epi = Epilogue{}) {
+   const auto K = static_cast<std::size_t>(std::max(k, 0));
+   auto block = [&](std::size_t jc, std::size_t pc, std::size_t,
+                    std::size_t, std::size_t nc_pad) -> const T * {
+      return b_packed + packed_b_offset(K, jc, pc, nc_pad);
+   };
+   detail::gemm_blocked<T, B>(trans_a, m, n, k, alpha, A, lda, block, beta, C,
+                              ldc, epi);
+}
+
+// gemm_widened packs B for all of K at once, one column block at a time,
+// and keeps each task's C block in an fp32 tile: column blocks are narrowed
+// until the packed B block and the tile stay within these sizes.
+constexpr std::size_t kWidenedPanelBytes = std::size_t{4} << 20;
+constexpr std::size_t kWidenedTileBytes = std::size_t{256} << 10;
+
+// C = alpha * op(A) op(B) + beta * C on 16-bit operands, computed in T
+// (fp32). Packing widens A and B; each row block sums over all of K in an
+// fp32 tile, which epi finishes before it is narrowed into C, so every
+// element of C is rounded once. C is only read when beta != 0.
+template <typename T, BackendFma B = NativeBackend<T>,
+          class Epilogue = NoEpilogue, HalfFloat H>
+void gemm_widened(bool trans_a, bool trans_b, int m, int n, int k, T alpha,
+                  const H *A, int lda, const H *Bm, int ldb, T beta, H *C,
+                  int ldc, const Epilogue &epi = Epilogue{}) {
+   using Blk = Blocking<B>;
+   if (m <= 0 || n <= 0) {
+      return;
+   }
+   const auto M = static_cast<std::size_t>(m);
+   const auto N = static_cast<std::size_t>(n);
+   const auto K = static_cast<std::size_t>(std::max(k, 0));
+   const auto ldc_ = static_cast<std::size_t>(ldc);
+   const bool product = K != 0 && alpha != T(0);
+
+   const OperandSteps sa = operand_steps(trans_a, lda);
+   const OperandSteps sb = operand_steps(trans_b, ldb);
+   const std::size_t mc_block = detail::row_block<B>(M);
+   const std::size_t row_blocks = (M + mc_block - 1) / mc_block;
+   const std::size_t by_panel =
+       kWidenedPanelBytes / (std::max<std::size_t>(K, 1) * sizeof(T));
+   const std::size_t by_tile = kWidenedTileBytes / (mc_block * sizeof(T));
+   const std::size_t nc_block = std::max(
+       Blk::NR, std::min(Blk::NC, std::min(by_panel, by_tile)) / Blk::NR *
+                    Blk::NR);
+
+   PackBuffer<T> b_buffer;
+   for (std::size_t jc = 0; jc < N; jc += nc_block) {
+      const std::size_t nc = std::min(nc_block, N - jc);
+      const std::size_t nc_pad = ((nc + Blk::NR - 1) / Blk::NR) * Blk::NR;
+      T *b_pack = b_buffer.get(K * nc_pad);
+      for (std::size_t pc = 0; product && pc < K; pc += Blk::KC) {
+         pack_b<T, Blk::NR>(std::min(Blk::KC, K - pc), nc,
+                            Bm + static_cast<std::int64_t>(pc) * sb.row +
+                                static_cast<std::int64_t>(jc) * sb.col,
+                            sb, b_pack + pc * nc_pad);
+      }
+
+      fusion::parallel::parallel_for(
+          0, row_blocks, 1, [&](std::size_t lo, std::size_t hi) {
+             PackBuffer<T, PackedA> a_buffer;
+             PackBuffer<T, WidenedTile> c_buffer;
+             const std::size_t mc_pad =
+                 ((mc_block + Blk::MR - 1) / Blk::MR) * Blk::MR;
+             T *a_pack = a_buffer.get(mc_pad * std::min(Blk::KC, K));
+             T *tile = c_buffer.get(mc_block * nc);
+             for (std::size_t blk = lo; blk < hi; ++blk) {
+                const std::size_t ic = blk * mc_block;
+                const std::size_t mc = std::min(mc_block, M - ic);
+                H *c = C + ic * ldc_ + jc;
+                if (!product) {
+                   std::fill_n(tile, mc * nc, T(0));
+                }
+                for (std::size_t pc = 0; product && pc < K; pc += Blk::KC) {
+                   const std::size_t kc = std::min(Blk::KC, K - pc);
+                   pack_a<T, Blk::MR>(
+                       mc, kc,
+                       A + static_cast<std::int64_t>(ic) * sa.row +
+                           static_cast<std::int64_t>(pc) * sa.col,
+                       sa, a_pack);
+                   macro_kernel<B>(mc, nc, kc, a_pack, b_pack + pc * nc_pad,
+                                   tile, nc, alpha, pc == 0 ? T(0) : T(1));
+                }
+                if (beta != T(0)) {
+                   for (std::size_t i = 0; i < mc; ++i) {
+                      for (std::size_t j = 0; j < nc; ++j) {
+                         tile[i * nc + j] += beta * T(c[i * ldc_ + j]);
+                      }
+                   }
+                }
+                epi(ic, jc, mc, nc, tile, nc);
+                for (std::size_t i = 0; i < mc; ++i) {
+                   simd::narrow(tile + i * nc, c + i * ldc_, nc);
+                }
+             }
+          });
+   }
+}
+
+} // namespace fusion::blas::packed
+
+#endif // FUSION_CPU_BLAS_PACKED_GEMM_HPP
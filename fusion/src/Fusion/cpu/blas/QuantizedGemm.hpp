@@ -0,0 +1,385 @@
+#ifndef FUSION_CPU_BLAS_QUANTIZED_GEMM_HPP
+#define FUSION_CPU_BLAS_QUANTIZED_GEMM_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Fusion/common/Checks.hpp"
+#include "Fusion/core/Parallel.h"
+#include "Fusion/ops/OpParams.hpp" // Activation
+
+#include "GemmEpilogue.hpp" // activate, with_activation
+#include "PackedGemm.hpp"   // AlignedBuffer
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(FUSION_ENABLE_NEON) && defined(__ARM_NEON) &&                      \
+    defined(__ARM_FEATURE_DOTPROD)
+#include <arm_neon.h>
+#define FUSION_QGEMM_SDOT 1
+#endif
+
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+#define FUSION_QGEMM_VNNI 1
+#elif defined(__AVXVNNI__)
+#define FUSION_QGEMM_VNNI 1
+#define FUSION_QGEMM_AVXVNNI 1
+#endif
+
+// int8 x int8 -> int32 GEMM for quantized inference.
+//
+//   for (ic, jc) blocks of [MC x NC]   in parallel; A block packed per task
+//     for jr in NC step NR             B packed once, ahead of time
+//       for ir in MC step MR           MR x NR int32 tile in registers
+//
+// Operands are packed so every 32-bit lane holds four consecutive k: the
+// unit of VNNI vpdpbusd (u8 x s8), NEON sdot (s8 x s8) and the AVX2
+// fallback (pmaddubsw to int16 pairs, pmaddwd to int32). K is not blocked;
+// a task's int32 block is corrected for the zero points and handed to the
+// epilogue, which rescales (and requantizes) it while it is in cache, so
+// the int32 product never reaches memory as a whole.
+namespace fusion::blas::quant {
+
+// Stored values lie in [-127, 127]. Without -128 the AVX2 sign trick
+// (|a| times b with a's sign) cannot overflow a pmaddubsw int16 pair.
+constexpr std::int32_t kQMin = -127;
+constexpr std::int32_t kQMax = 127;
+
+// vpdpbusd takes A unsigned: A is packed as a + 128 and the zero-point
+// correction absorbs the shift.
+#if defined(FUSION_QGEMM_VNNI)
+constexpr std::int32_t kAShift = 128;
+#else
+constexpr std::int32_t kAShift = 0;
+#endif
+
+// Dot-product instruction this build uses, for benchmark labels.
+#if defined(FUSION_QGEMM_AVXVNNI)
+constexpr const char *kKernelName = "avx-vnni";
+#elif defined(FUSION_QGEMM_VNNI)
+constexpr const char *kKernelName = "avx512-vnni";
+#elif defined(__AVX2__)
+constexpr const char *kKernelName = "avx2";
+#elif defined(FUSION_QGEMM_SDOT)
+constexpr const char *kKernelName = "neon-sdot";
+#else
+constexpr const char *kKernelName = "scalar";
+#endif
+
+// Register and cache blocking: 4 x 16 int32 accumulators are eight AVX2 or
+// sixteen NEON registers. An NR panel of B over all of K stays in L2 for
+// K up to a few thousand; the [MC x NC] int32 block is 96 KiB.
+constexpr std::size_t kMR = 4;
+constexpr std::size_t kNR = 16;
+constexpr std::size_t kMC = kMR * 24;
+constexpr std::size_t kNC = 256;
+
+inline std::size_t k_quads(std::size_t k) { return (k + 3) / 4; }
+
+// op(B) [k x n] in ceil(n / NR) panels of [ceil(k / 4)][NR][4], zero padded,
+// with per-column sums and zero points for the correction.
+struct PackedB {
+   std::size_t k = 0;
+   std::size_t n = 0;
+   std::vector<std::int8_t> data;
+   std::vector<std::int32_t> col_sum;
+   std::vector<std::int32_t> zero; // per column; empty when all are 0
+
+   const std::int8_t *panel(std::size_t j) const {
+      return data.data() + (j / kNR) * k_quads(k) * kNR * 4;
+   }
+};
+
+inline PackedB pack_b(bool trans_b, int k, int n, const std::int8_t *B,
+                      int ldb, std::vector<std::int32_t> zero = {}) {
+   PackedB p;
+   p.k = static_cast<std::size_t>(std::max(k, 0));
+   p.n = static_cast<std::size_t>(std::max(n, 0));
+   const std::size_t kq = k_quads(p.k);
+   const std::size_t n_pad = (p.n + kNR - 1) / kNR * kNR;
+   p.data.assign(n_pad * kq * 4, 0);
+   p.col_sum.assign(p.n, 0);
+   const packed::OperandSteps s = packed::operand_steps(trans_b, ldb);
+   for (std::size_t j = 0; j < p.n; ++j) {
+      std::int8_t *dst = p.data.data() + (j / kNR) * kq * kNR * 4 +
+                         (j % kNR) * 4;
+      std::int32_t sum = 0;
+      for (std::size_t q = 0; q < p.k; ++q) {
+         const std::int8_t v = B[static_cast<std::int64_t>(q) * s.row +
+                                 static_cast<std::int64_t>(j) * s.col];
+         FUSION_CHECK(v >= kQMin, "quant::pack_b: -128 is outside [kQMin, "
+                                  "kQMax]");
+         dst[(q / 4) * kNR * 4 + q % 4] = v;
+         sum += v;
+      }
+      p.col_sum[j] = sum;
+   }
+   if (std::any_of(zero.begin(), zero.end(),
+                   [](std::int32_t z) { return z != 0; })) {
+      p.zero = std::move(zero);
+   }
+   return p;
+}
+
+// A[mc x k] (row-major, lda) as ceil(mc / MR) panels of [ceil(k / 4)][MR][4]
+// shifted by kAShift; row_sum gets the sum of each row as stored. Padding
+// is zero in either encoding.
+inline void pack_a(std::size_t mc, std::size_t k, const std::int8_t *A,
+                   std::size_t lda, std::int8_t *out, std::int32_t *row_sum) {
+   const std::size_t kq = k_quads(k);
+   for (std::size_t ir = 0; ir < mc; ir += kMR) {
+      std::memset(out, 0, kq * kMR * 4);
+      for (std::size_t r = 0; r < kMR && ir + r < mc; ++r) {
+         const std::int8_t *src = A + (ir + r) * lda;
+         std::int32_t sum = 0;
+         for (std::size_t q = 0; q < k; ++q) {
+            const std::int32_t v = src[q] + kAShift;
+            out[(q / 4) * kMR * 4 + r * 4 + q % 4] =
+                static_cast<std::int8_t>(static_cast<std::uint8_t>(v));
+            sum += v;
+         }
+         row_sum[ir + r] = sum;
+      }
+      out += kq * kMR * 4;
+   }
+}
+
+#if defined(__AVX2__)
+// acc plus, in every int32 lane, the dot product of that lane's four bytes
+// of a and b.
+inline __m256i dot_quads(__m256i acc, __m256i a, __m256i b) {
+#if defined(FUSION_QGEMM_AVXVNNI)
+   return _mm256_dpbusd_avx_epi32(acc, a, b);
+#elif defined(FUSION_QGEMM_VNNI)
+   return _mm256_dpbusd_epi32(acc, a, b);
+#else
+   // pmaddubsw wants u8 x s8: |a| times b with a's sign moved over, then
+   // pmaddwd against ones adds the int16 pairs into int32.
+   const __m256i pairs =
+       _mm256_maddubs_epi16(_mm256_sign_epi8(a, a), _mm256_sign_epi8(b, a));
+   return _mm256_add_epi32(acc,
+                           _mm256_madd_epi16(pairs, _mm256_set1_epi16(1)));
+#endif
+}
+#endif
+
+// C[MR x NR] = a_panel . b_panel over kq quads of k; C is overwritten.
+inline void micro_kernel(std::size_t kq, const std::int8_t *__restrict a,
+                         const std::int8_t *__restrict b,
+                         std::int32_t *__restrict c, std::size_t ldc) {
+#if defined(__AVX2__)
+   __m256i acc[kMR][2];
+   for (std::size_t r = 0; r < kMR; ++r) {
+      acc[r][0] = _mm256_setzero_si256();
+      acc[r][1] = _mm256_setzero_si256();
+   }
+   for (std::size_t q = 0; q < kq; ++q) {
+      const __m256i b0 =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b));
+      const __m256i b1 =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + 32));
+      for (std::size_t r = 0; r < kMR; ++r) {
+         std::int32_t quad;
+         std::memcpy(&quad, a + r * 4, sizeof(quad));
+         const __m256i va = _mm256_set1_epi32(quad);
+         acc[r][0] = dot_quads(acc[r][0], va, b0);
+         acc[r][1] = dot_quads(acc[r][1], va, b1);
+      }
+      a += kMR * 4;
+      b += kNR * 4;
+   }
+   for (std::size_t r = 0; r < kMR; ++r) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + r * ldc),
+                          acc[r][0]);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + r * ldc + 8),
+                          acc[r][1]);
+   }
+#elif defined(FUSION_QGEMM_SDOT)
+   int32x4_t acc[kMR][4];
+   for (std::size_t r = 0; r < kMR; ++r) {
+      for (std::size_t v = 0; v < 4; ++v) {
+         acc[r][v] = vdupq_n_s32(0);
+      }
+   }
+   for (std::size_t q = 0; q < kq; ++q) {
+      const int8x16_t bv[4] = {vld1q_s8(b), vld1q_s8(b + 16),
+                               vld1q_s8(b + 32), vld1q_s8(b + 48)};
+      for (std::size_t r = 0; r < kMR; ++r) {
+         std::int32_t quad;
+         std::memcpy(&quad, a + r * 4, sizeof(quad));
+         const int8x16_t va = vreinterpretq_s8_s32(vdupq_n_s32(quad));
+         for (std::size_t v = 0; v < 4; ++v) {
+            acc[r][v] = vdotq_s32(acc[r][v], bv[v], va);
+         }
+      }
+      a += kMR * 4;
+      b += kNR * 4;
+   }
+   for (std::size_t r = 0; r < kMR; ++r) {
+      for (std::size_t v = 0; v < 4; ++v) {
+         vst1q_s32(c + r * ldc + 4 * v, acc[r][v]);
+      }
+   }
+#else
+   std::int32_t acc[kMR][kNR] = {};
+   for (std::size_t q = 0; q < kq; ++q) {
+      for (std::size_t r = 0; r < kMR; ++r) {
+         for (std::size_t j = 0; j < kNR; ++j) {
+            for (std::size_t t = 0; t < 4; ++t) {
+               acc[r][j] += std::int32_t{a[r * 4 + t]} * b[j * 4 + t];
+            }
+         }
+      }
+      a += kMR * 4;
+      b += kNR * 4;
+   }
+   for (std::size_t r = 0; r < kMR; ++r) {
+      std::copy_n(acc[r], kNR, c + r * ldc);
+   }
+#endif
+}
+
+// acc[i][j] = sum_k (A[i][k] - a_zero) (B[k][j] - B.zero[j]) for A [m x k]
+// row-major, then epi(row, col, rows, cols, acc, ld) over every block. The
+// zero-point terms expand to per-row and per-column sums, so the kernel
+// itself only multiplies stored values. A must lie in [kQMin, kQMax] like B
+// (QuantizedTensor guarantees it): the AVX2 and VNNI kernels disagree on
+// -128.
+template <class Epilogue>
+void gemm(std::size_t m, const std::int8_t *A, std::size_t lda,
+          std::int32_t a_zero, const PackedB &B, const Epilogue &epi) {
+   const std::size_t N = B.n;
+   const std::size_t K = B.k;
+   if (m == 0 || N == 0) {
+      return;
+   }
+   const std::size_t kq = k_quads(K);
+   const std::int32_t za = a_zero + kAShift;
+   const auto kza = static_cast<std::int32_t>(K) * za;
+   const std::size_t row_blocks = (m + kMC - 1) / kMC;
+   const std::size_t col_blocks = (N + kNC - 1) / kNC;
+
+   fusion::parallel::parallel_for(
+       0, row_blocks * col_blocks, 1, [&](std::size_t lo, std::size_t hi) {
+          thread_local packed::AlignedBuffer<std::int8_t> a_buffer;
+          thread_local packed::AlignedBuffer<std::int32_t> c_buffer;
+          thread_local packed::AlignedBuffer<std::int32_t> sum_buffer;
+          std::int8_t *a_pack = a_buffer.get(kMC * kq * 4);
+          std::int32_t *acc = c_buffer.get(kMC * kNC);
+          std::int32_t *row_sum = sum_buffer.get(kMC);
+          std::size_t packed_ic = m;
+          for (std::size_t t = lo; t < hi; ++t) {
+             const std::size_t ic = (t / col_blocks) * kMC;
+             const std::size_t jc = (t % col_blocks) * kNC;
+             const std::size_t mc = std::min(kMC, m - ic);
+             const std::size_t nc = std::min(kNC, N - jc);
+             if (ic != packed_ic) {
+                pack_a(mc, K, A + ic * lda, lda, a_pack, row_sum);
+                packed_ic = ic;
+             }
+             for (std::size_t jr = 0; jr < nc; jr += kNR) {
+                const std::int8_t *b_panel = B.panel(jc + jr);
+                for (std::size_t ir = 0; ir < mc; ir += kMR) {
+                   micro_kernel(kq, a_pack + ir * kq * 4, b_panel,
+                                acc + ir * kNC + jr, kNC);
+                }
+             }
+             for (std::size_t i = 0; i < mc; ++i) {
+                std::int32_t *c = acc + i * kNC;
+                const std::int32_t *cs = B.col_sum.data() + jc;
+                if (B.zero.empty()) {
+                   for (std::size_t j = 0; j < nc; ++j) {
+                      c[j] -= za * cs[j];
+                   }
+                } else {
+                   const std::int32_t *zb = B.zero.data() + jc;
+                   const std::int32_t rs = row_sum[i] - kza;
+                   for (std::size_t j = 0; j < nc; ++j) {
+                      c[j] -= za * cs[j] + zb[j] * rs;
+                   }
+                }
+             }
+             epi(ic, jc, mc, nc, acc, kNC);
+          }
+       });
+}
+
+// act(acc * a_scale * b_scale[j] + bias[j]): the real value of accumulator
+// acc in column j. b_scale holds one scale per column; bias may be null.
+struct Rescale {
+   float a_scale = 1.0f;
+   const float *b_scale = nullptr;
+   const float *bias = nullptr;
+   Activation act = Activation::None;
+
+   template <Activation A, class Store>
+   void apply(std::size_t col, std::size_t rows, std::size_t cols,
+              const std::int32_t *acc, std::size_t ld, Store &&store) const {
+      for (std::size_t i = 0; i < rows; ++i) {
+         const std::int32_t *c = acc + i * ld;
+         for (std::size_t j = 0; j < cols; ++j) {
+            float y = static_cast<float>(c[j]) * (a_scale * b_scale[col + j]);
+            if (bias != nullptr) {
+               y += bias[col + j];
+            }
+            store(i, j, epilogue::activate<A>(y));
+         }
+      }
+   }
+};
+
+// Writes the rescaled block to a float C.
+struct Dequantize {
+   Rescale rescale;
+   float *out = nullptr;
+   std::size_t ldo = 0;
+
+   void operator()(std::size_t row, std::size_t col, std::size_t rows,
+                   std::size_t cols, const std::int32_t *acc,
+                   std::size_t ld) const {
+      float *o = out + row * ldo + col;
+      epilogue::with_activation(rescale.act, [&](auto a) {
+         rescale.apply<decltype(a)::value>(
+             col, rows, cols, acc, ld,
+             [&](std::size_t i, std::size_t j, float y) {
+                o[i * ldo + j] = y;
+             });
+      });
+   }
+};
+
+// Requantizes the rescaled block to an int8 C with (out_scale, out_zero),
+// rounding to nearest even and clamping to [kQMin, kQMax].
+struct Requantize {
+   Rescale rescale;
+   float out_scale = 1.0f;
+   std::int32_t out_zero = 0;
+   std::int8_t *out = nullptr;
+   std::size_t ldo = 0;
+
+   void operator()(std::size_t row, std::size_t col, std::size_t rows,
+                   std::size_t cols, const std::int32_t *acc,
+                   std::size_t ld) const {
+      std::int8_t *o = out + row * ldo + col;
+      const float inv = 1.0f / out_scale;
+      const auto zero = static_cast<float>(out_zero);
+      epilogue::with_activation(rescale.act, [&](auto a) {
+         rescale.apply<decltype(a)::value>(
+             col, rows, cols, acc, ld,
+             [&](std::size_t i, std::size_t j, float y) {
+                const float q = std::nearbyint(y * inv) + zero;
+                o[i * ldo + j] = static_cast<std::int8_t>(
+                    std::clamp(q, float(kQMin), float(kQMax)));
+             });
+      });
+   }
+};
+
+} // namespace fusion::blas::quant
+
+#endif // FUSION_CPU_BLAS_QUANTIZED_GEMM_HPP
@@ -0,0 +1,164 @@
+#ifndef FUSION_CPU_BLAS_SMALL_GEMM_HPP
+#define FUSION_CPU_BLAS_SMALL_GEMM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "Fusion/core/Float16.hpp"
+#include "Fusion/core/Parallel.h"
+#include "Fusion/core/TensorPlan.h" // GemmLikeDesc
+
+// GEMMs small enough that a BLAS call (argument checks, threading decisions,
+// packing) costs more than the arithmetic. Each output row is accumulated in
+// a stack array the compiler keeps in registers; the common square sizes get
+// a kernel with M, N and K fixed at compile time, so every loop unrolls.
+// Rows accumulate in accum_t<T>: fp32 for the 16-bit types.
+namespace fusion::blas::small {
+
+// Largest M, N and K taken by the small path.
+constexpr std::size_t kMaxDim = 32;
+
+// Largest M * N * K for shapes without a fixed-size kernel; past it the
+// generic loop loses to BLAS.
+constexpr std::size_t kMaxGenericVolume = 16 * 16 * 16;
+
+// Multiply-adds per task when a batch of small GEMMs is split across threads.
+constexpr std::size_t kBatchGrainVolume = std::size_t{1} << 15;
+
+// Square, non-transposed sizes with a compile-time kernel.
+inline bool has_fixed_kernel(bool trans_a, bool trans_b, std::size_t m,
+                             std::size_t n, std::size_t k) {
+   if (trans_a || trans_b || m != n || n != k) {
+      return false;
+   }
+   return m == 2 || m == 3 || m == 4 || m == 8 || m == 16 || m == 32;
+}
+
+// Whether op(A)[m x k] op(B)[k x n] should take the small path.
+inline bool fits(bool trans_a, bool trans_b, std::size_t m, std::size_t n,
+                 std::size_t k) {
+   if (m > kMaxDim || n > kMaxDim || k > kMaxDim) {
+      return false;
+   }
+   return has_fixed_kernel(trans_a, trans_b, m, n, k) ||
+          m * n * k <= kMaxGenericVolume;
+}
+
+// C[M x N] = A[M x K] B[K x N], row-major, leading dimensions at run time;
+// C += A B when accumulating.
+template <typename T, std::size_t M, std::size_t N, std::size_t K>
+inline void gemm_fixed(const T *__restrict A, std::int64_t lda,
+                       const T *__restrict B, std::int64_t ldb,
+                       T *__restrict C, std::int64_t ldc, bool accumulate) {
+   for (std::size_t i = 0; i < M; ++i) {
+      accum_t<T> row[N] = {};
+      if (accumulate) {
+         std::copy_n(C + static_cast<std::int64_t>(i) * ldc, N, row);
+      }
+      for (std::size_t p = 0; p < K; ++p) {
+         const accum_t<T> a = A[static_cast<std::int64_t>(i) * lda +
+                                static_cast<std::int64_t>(p)];
+         const T *b = B + static_cast<std::int64_t>(p) * ldb;
+         for (std::size_t j = 0; j < N; ++j) {
+            row[j] += a * b[j];
+         }
+      }
+      T *c = C + static_cast<std::int64_t>(i) * ldc;
+      for (std::size_t j = 0; j < N; ++j) {
+         c[j] = row[j];
+      }
+   }
+}
+
+// Any shape within kMaxDim, either operand possibly transposed.
+template <typename T>
+inline void gemm_any(bool trans_a, bool trans_b, std::size_t m, std::size_t n,
+                     std::size_t k, const T *__restrict A, std::int64_t lda,
+                     const T *__restrict B, std::int64_t ldb, T *__restrict C,
+                     std::int64_t ldc, bool accumulate) {
+   const std::int64_t a_i = trans_a ? 1 : lda;
+   const std::int64_t a_p = trans_a ? lda : 1;
+   const std::int64_t b_p = trans_b ? 1 : ldb;
+   const std::int64_t b_j = trans_b ? ldb : 1;
+   for (std::size_t i = 0; i < m; ++i) {
+      accum_t<T> row[kMaxDim] = {};
+      if (accumulate) {
+         std::copy_n(C + static_cast<std::int64_t>(i) * ldc, n, row);
+      }
+      for (std::size_t p = 0; p < k; ++p) {
+         const accum_t<T> a = A[static_cast<std::int64_t>(i) * a_i +
+                                static_cast<std::int64_t>(p) * a_p];
+         const T *b = B + static_cast<std::int64_t>(p) * b_p;
+         if (b_j == 1) {
+            for (std::size_t j = 0; j < n; ++j) {
+               row[j] += a * b[j];
+            }
+         } else {
+            for (std::size_t j = 0; j < n; ++j) {
+               row[j] += a * b[static_cast<std::int64_t>(j) * b_j];
+            }
+         }
+      }
+      T *c = C + static_cast<std::int64_t>(i) * ldc;
+      for (std::size_t j = 0; j < n; ++j) {
+         c[j] = row[j];
+      }
+   }
+}
+
+// C = op(A) op(B) for one small GEMM (alpha = 1, beta = 0), or
+// C += op(A) op(B) (beta = 1) when accumulate is set.
+template <typename T>
+inline void gemm(bool trans_a, bool trans_b, std::size_t m, std::size_t n,
+                 std::size_t k, const T *A, std::int64_t lda, const T *B,
+                 std::int64_t ldb, T *C, std::int64_t ldc,
+                 bool accumulate = false) {
+   if (has_fixed_kernel(trans_a, trans_b, m, n, k)) {
+      switch (m) {
+      case 2:
+         return gemm_fixed<T, 2, 2, 2>(A, lda, B, ldb, C, ldc, accumulate);
+      case 3:
+         return gemm_fixed<T, 3, 3, 3>(A, lda, B, ldb, C, ldc, accumulate);
+      case 4:
+         return gemm_fixed<T, 4, 4, 4>(A, lda, B, ldb, C, ldc, accumulate);
+      case 8:
+         return gemm_fixed<T, 8, 8, 8>(A, lda, B, ldb, C, ldc, accumulate);
+      case 16:
+         return gemm_fixed<T, 16, 16, 16>(A, lda, B, ldb, C, ldc, accumulate);
+      case 32:
+         return gemm_fixed<T, 32, 32, 32>(A, lda, B, ldb, C, ldc, accumulate);
+      default:
+         break;
+      }
+   }
+   gemm_any<T>(trans_a, trans_b, m, n, k, A, lda, B, ldb, C, ldc, accumulate);
+}
+
+// Whether a planned contraction can run on the small path: every batch
+// entry small and the whole batch in one strided run.
+inline bool can_execute(const GemmLikeDesc &g) {
+   return fits(g.a_transpose, g.b_transpose, g.M, g.N, g.K) &&
+          g.outer_batch.empty();
+}
+
+template <typename T>
+inline void execute(const T *A, const T *B, T *C, const GemmLikeDesc &g,
+                    bool accumulate = false) {
+   const std::size_t volume = std::max<std::size_t>(1, g.M * g.N * g.K);
+   const std::size_t grain =
+       std::max<std::size_t>(1, kBatchGrainVolume / volume);
+   fusion::parallel::parallel_for(
+       0, g.batch, grain, [&](std::size_t lo, std::size_t hi) {
+          for (std::size_t b = lo; b < hi; ++b) {
+             const auto i = static_cast<std::int64_t>(b);
+             gemm<T>(g.a_transpose, g.b_transpose, g.M, g.N, g.K,
+                     A + i * g.a_bs, g.lda, B + i * g.b_bs, g.ldb,
+                     C + i * g.out_bs, g.ldc, accumulate);
+          }
+       });
+}
+
+} // namespace fusion::blas::small
+
+#endif // FUSION_CPU_BLAS_SMALL_GEMM_HPP
@@ -0,0 +1,300 @@
+#ifndef FUSION_CPU_BLAS_VECTOR_KERNELS_HPP
+#define FUSION_CPU_BLAS_VECTOR_KERNELS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Fusion/core/Float16.hpp"
+#include "Fusion/core/Parallel.h"
+#include "Fusion/core/TensorPlan.h" // GemvLikeDesc, DotLikeDesc, AxpyLikeDesc
+
+#include "Fusion/cpu/simd/Convert.hpp"
+
+#include "NativeBackend.hpp"
+
+// Level-1/2 kernels (dot, axpy, gemv) for builds and dtypes without a BLAS
+// library behind them. Unit-stride runs go through the vector backend;
+// strided vectors are gathered once, or walked scalar when used only once.
+// bfloat16/float16 operands are widened a block at a time and run through
+// the float kernels, so their products accumulate in fp32.
+namespace fusion::blas::native {
+
+// Multiply-adds per pool task for gemv and for batches of dots.
+constexpr std::size_t kTaskVolume = std::size_t{1} << 15;
+
+template <typename T, BackendFma B = NativeBackend<T>>
+   requires(!is_half_float_v<T>)
+inline T dot(std::size_t n, const T *x, std::int64_t incx, const T *y,
+             std::int64_t incy) {
+   using vec = typename B::vec;
+   constexpr std::size_t L = B::kLanes;
+   if (incx != 1 || incy != 1) {
+      T acc = T(0);
+      for (std::size_t i = 0; i < n; ++i) {
+         const auto s = static_cast<std::int64_t>(i);
+         acc += x[s * incx] * y[s * incy];
+      }
+      return acc;
+   }
+
+   // Four independent accumulators hide the FMA latency.
+   const vec zero = B::duplicate(T(0));
+   vec acc[4] = {zero, zero, zero, zero};
+   std::size_t i = 0;
+   for (; i + 4 * L <= n; i += 4 * L) {
+      for (std::size_t u = 0; u < 4; ++u) {
+         const std::size_t o = i + u * L;
+         acc[u] = B::fma(acc[u], B::load(x + o), B::load(y + o));
+      }
+   }
+   for (; i + L <= n; i += L) {
+      acc[0] = B::fma(acc[0], B::load(x + i), B::load(y + i));
+   }
+   T sum = T(0);
+   T lanes[L];
+   for (std::size_t u = 0; u < 4; ++u) {
+      B::store(lanes, acc[u]);
+      for (std::size_t l = 0; l < L; ++l) {
+         sum += lanes[l];
+      }
+   }
+   for (; i < n; ++i) {
+      sum += x[i] * y[i];
+   }
+   return sum;
+}
+
+// y += alpha x.
+template <typename T, BackendFma B = NativeBackend<T>>
+   requires(!is_half_float_v<T>)
+inline void axpy(std::size_t n, T alpha, const T *x, std::int64_t incx, T *y,
+                 std::int64_t incy) {
+   constexpr std::size_t L = B::kLanes;
+   std::size_t i = 0;
+   if (incx == 1 && incy == 1) {
+      const auto va = B::duplicate(alpha);
+      for (; i + L <= n; i += L) {
+         B::store(y + i, B::fma(B::load(y + i), va, B::load(x + i)));
+      }
+      for (; i < n; ++i) {
+         y[i] += alpha * x[i];
+      }
+      return;
+   }
+   for (; i < n; ++i) {
+      const auto s = static_cast<std::int64_t>(i);
+      y[s * incy] += alpha * x[s * incx];
+   }
+}
+
+// x . y in fp32 for 16-bit x and y.
+template <HalfFloat H, BackendFma B = NativeBackend<float>>
+inline float dot(std::size_t n, const H *x, std::int64_t incx, const H *y,
+                 std::int64_t incy) {
+   float sum = 0.0f;
+   if (incx != 1 || incy != 1) {
+      for (std::size_t i = 0; i < n; ++i) {
+         const auto s = static_cast<std::int64_t>(i);
+         sum += float(x[s * incx]) * float(y[s * incy]);
+      }
+      return sum;
+   }
+   float wx[simd::kWidenBlock];
+   float wy[simd::kWidenBlock];
+   for (std::size_t i = 0; i < n; i += simd::kWidenBlock) {
+      const std::size_t len = std::min(simd::kWidenBlock, n - i);
+      simd::widen(x + i, wx, len);
+      simd::widen(y + i, wy, len);
+      sum += dot<float, B>(len, wx, 1, wy, 1);
+   }
+   return sum;
+}
+
+// y += alpha x for 16-bit x and y; each y element is rounded once.
+template <HalfFloat H, BackendFma B = NativeBackend<float>>
+inline void axpy(std::size_t n, H alpha, const H *x, std::int64_t incx, H *y,
+                 std::int64_t incy) {
+   if (incx != 1 || incy != 1) {
+      for (std::size_t i = 0; i < n; ++i) {
+         const auto s = static_cast<std::int64_t>(i);
+         y[s * incy] += float(alpha) * float(x[s * incx]);
+      }
+      return;
+   }
+   float wx[simd::kWidenBlock];
+   float wy[simd::kWidenBlock];
+   for (std::size_t i = 0; i < n; i += simd::kWidenBlock) {
+      const std::size_t len = std::min(simd::kWidenBlock, n - i);
+      simd::widen(x + i, wx, len);
+      simd::widen(y + i, wy, len);
+      axpy<float, B>(len, float(alpha), wx, 1, wy, 1);
+      simd::narrow(wy, y + i, len);
+   }
+}
+
+// y = alpha * op(A) x + beta * y, A stored row-major as rows x cols with
+// leading dimension lda; the cblas_?gemv(CblasRowMajor, ...) contract.
+template <typename T>
+   requires(!is_half_float_v<T>)
+void gemv(bool trans, std::size_t rows, std::size_t cols, T alpha, const T *A,
+          std::int64_t lda, const T *x, std::int64_t incx, T beta, T *y,
+          std::int64_t incy) {
+   const std::size_t nx = trans ? rows : cols;
+   const std::size_t ny = trans ? cols : rows;
+   std::vector<T> packed_x;
+   if (incx != 1) {
+      packed_x.resize(nx);
+      for (std::size_t i = 0; i < nx; ++i) {
+         packed_x[i] = x[static_cast<std::int64_t>(i) * incx];
+      }
+      x = packed_x.data();
+   }
+
+   auto scale_y = [&](std::size_t lo, std::size_t hi) {
+      for (std::size_t j = lo; j < hi; ++j) {
+         T &v = y[static_cast<std::int64_t>(j) * incy];
+         v = (beta == T(0)) ? T(0) : beta * v;
+      }
+   };
+
+   if (!trans) {
+      // One dot per output element, rows split across the pool.
+      const std::size_t grain = std::max<std::size_t>(
+          1, kTaskVolume / std::max<std::size_t>(cols, 1));
+      fusion::parallel::parallel_for(
+          0, ny, grain, [&](std::size_t lo, std::size_t hi) {
+             scale_y(lo, hi);
+             for (std::size_t i = lo; i < hi; ++i) {
+                const T *row = A + static_cast<std::int64_t>(i) * lda;
+                y[static_cast<std::int64_t>(i) * incy] +=
+                    alpha * dot<T>(cols, row, 1, x, 1);
+             }
+          });
+      return;
+   }
+
+   // y = A^T x: an axpy of every row into y, columns split across the pool
+   // so each task owns a slice of y.
+   const std::size_t grain =
+       std::max<std::size_t>(1, kTaskVolume / std::max<std::size_t>(rows, 1));
+   fusion::parallel::parallel_for(
+       0, ny, grain, [&](std::size_t lo, std::size_t hi) {
+          scale_y(lo, hi);
+          T *ys = y + static_cast<std::int64_t>(lo) * incy;
+          for (std::size_t i = 0; i < rows; ++i) {
+             const T *row = A + static_cast<std::int64_t>(i) * lda +
+                            static_cast<std::int64_t>(lo);
+             axpy<T>(hi - lo, alpha * x[i], row, 1, ys, incy);
+          }
+       });
+}
+
+// gemv for 16-bit A, x and y. x and y are widened once into fp32 buffers
+// and rows of A a block at a time, so y is rounded only when stored back.
+template <HalfFloat H>
+void gemv(bool trans, std::size_t rows, std::size_t cols, H alpha, const H *A,
+          std::int64_t lda, const H *x, std::int64_t incx, H beta, H *y,
+          std::int64_t incy) {
+   const std::size_t nx = trans ? rows : cols;
+   const std::size_t ny = trans ? cols : rows;
+   const float fa = alpha;
+   const float fb = beta;
+   std::vector<float> xf(nx);
+   std::vector<float> yf(ny);
+   for (std::size_t i = 0; i < nx; ++i) {
+      xf[i] = x[static_cast<std::int64_t>(i) * incx];
+   }
+   for (std::size_t j = 0; j < ny; ++j) {
+      yf[j] = (fb == 0.0f)
+                  ? 0.0f
+                  : fb * float(y[static_cast<std::int64_t>(j) * incy]);
+   }
+
+   if (!trans) {
+      const std::size_t grain = std::max<std::size_t>(
+          1, kTaskVolume / std::max<std::size_t>(cols, 1));
+      fusion::parallel::parallel_for(
+          0, ny, grain, [&](std::size_t lo, std::size_t hi) {
+             float w[simd::kWidenBlock];
+             for (std::size_t i = lo; i < hi; ++i) {
+                const H *row = A + static_cast<std::int64_t>(i) * lda;
+                float acc = 0.0f;
+                for (std::size_t j = 0; j < cols; j += simd::kWidenBlock) {
+                   const std::size_t len =
+                       std::min(simd::kWidenBlock, cols - j);
+                   simd::widen(row + j, w, len);
+                   acc += dot<float>(len, w, 1, xf.data() + j, 1);
+                }
+                yf[i] += fa * acc;
+             }
+          });
+   } else {
+      const std::size_t grain = std::max<std::size_t>(
+          1, kTaskVolume / std::max<std::size_t>(rows, 1));
+      fusion::parallel::parallel_for(
+          0, ny, grain, [&](std::size_t lo, std::size_t hi) {
+             float w[simd::kWidenBlock];
+             for (std::size_t i = 0; i < rows; ++i) {
+                const H *row = A + static_cast<std::int64_t>(i) * lda;
+                for (std::size_t j = lo; j < hi; j += simd::kWidenBlock) {
+                   const std::size_t len = std::min(simd::kWidenBlock, hi - j);
+                   simd::widen(row + j, w, len);
+                   axpy<float>(len, fa * xf[i], w, 1, yf.data() + j, 1);
+                }
+             }
+          });
+   }
+   for (std::size_t j = 0; j < ny; ++j) {
+      y[static_cast<std::int64_t>(j) * incy] = yf[j];
+   }
+}
+
+// Executors for the level-1/2 plans of contraction_tag, one call per batch
+// entry.
+template <typename T>
+void execute(const T *A, const T *B, T *C, const GemvLikeDesc &d, T alpha,
+             T beta) {
+   const T *mat = d.mat_is_a ? A : B;
+   const T *x = d.mat_is_a ? B : A;
+   for (std::size_t b = 0; b < d.batch; ++b) {
+      const auto i = static_cast<std::int64_t>(b);
+      gemv<T>(d.transpose, d.rows, d.cols, alpha, mat + i * d.mat_bs, d.ld,
+              x + i * d.x_bs, d.x_inc, beta, C + i * d.y_bs, d.y_inc);
+   }
+}
+
+template <typename T>
+void execute(const T *A, const T *B, T *C, const DotLikeDesc &d, T alpha,
+             T beta) {
+   const std::size_t grain =
+       std::max<std::size_t>(1, kTaskVolume / std::max<std::size_t>(d.n, 1));
+   fusion::parallel::parallel_for(
+       0, d.batch, grain, [&](std::size_t lo, std::size_t hi) {
+          for (std::size_t b = lo; b < hi; ++b) {
+             const auto i = static_cast<std::int64_t>(b);
+             T &out = C[i * d.out_bs];
+             const accum_t<T> v =
+                 alpha * dot<T>(d.n, A + i * d.a_bs, d.a_inc, B + i * d.b_bs,
+                                d.b_inc);
+             out = (beta == T(0)) ? v : v + beta * out;
+          }
+       });
+}
+
+// Accumulates into C: y += alpha * s * x for each batch entry.
+template <typename T>
+void execute(const T *A, const T *B, T *C, const AxpyLikeDesc &d, T alpha) {
+   const T *x = d.x_is_a ? A : B;
+   const T *s = d.x_is_a ? B : A;
+   for (std::size_t b = 0; b < d.batch; ++b) {
+      const auto i = static_cast<std::int64_t>(b);
+      axpy<T>(d.n, alpha * s[i * d.alpha_bs], x + i * d.x_bs, d.x_inc,
+              C + i * d.y_bs, d.y_inc);
+   }
+}
+
+} // namespace fusion::blas::native
+
+#endif // FUSION_CPU_BLAS_VECTOR_KERNELS_HPP
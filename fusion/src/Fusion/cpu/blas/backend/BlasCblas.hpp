@@ -2,7 +2,9 @@
 #define FUSION_CPU_BLAS_CBLAS_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <type_traits>
+#include <vector>
 
 #if defined(__APPLE__)
 #ifndef ACCELERATE_NEW_LAPACK
@@ -15,25 +17,134 @@
 
 namespace fusion::blas::backend {
 
-// float specialization (extend later)
+// One overload per precision: s* routines for float, d* for double.
 inline void gemm_rowmajor_nn(const float *A, const float *B, float *C, int m,
                              int n, int k, float alpha, float beta) {
    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k, alpha, A, k,
                B, n, beta, C, n);
 }
 
-inline void batched_gemm_rowmajor_nn(const float *baseA, const float *baseB,
-                                     float *baseC, int m, int n, int k,
-                                     std::size_t batch, float alpha,
-                                     float beta) {
+inline void gemm_rowmajor_nn(const double *A, const double *B, double *C,
+                             int m, int n, int k, double alpha, double beta) {
+   cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k, alpha, A, k,
+               B, n, beta, C, n);
+}
+
+// C = alpha * op(A) op(B) + beta * C, row-major, with explicit leading
+// dimensions so transposed and row-strided views need no copy.
+inline void gemm_rowmajor(bool trans_a, bool trans_b, int m, int n, int k,
+                          float alpha, const float *A, int lda, const float *B,
+                          int ldb, float beta, float *C, int ldc) {
+   cblas_sgemm(CblasRowMajor, trans_a ? CblasTrans : CblasNoTrans,
+               trans_b ? CblasTrans : CblasNoTrans, m, n, k, alpha, A, lda, B,
+               ldb, beta, C, ldc);
+}
+
+inline void gemm_rowmajor(bool trans_a, bool trans_b, int m, int n, int k,
+                          double alpha, const double *A, int lda,
+                          const double *B, int ldb, double beta, double *C,
+                          int ldc) {
+   cblas_dgemm(CblasRowMajor, trans_a ? CblasTrans : CblasNoTrans,
+               trans_b ? CblasTrans : CblasNoTrans, m, n, k, alpha, A, lda, B,
+               ldb, beta, C, ldc);
+}
+
+// Batch entry b of each operand starts b * *_bs elements past its base.
+template <typename T>
+inline void batched_gemm_rowmajor(bool trans_a, bool trans_b, int m, int n,
+                                  int k, T alpha, const T *baseA, int lda,
+                                  std::int64_t a_bs, const T *baseB, int ldb,
+                                  std::int64_t b_bs, T beta, T *baseC, int ldc,
+                                  std::int64_t c_bs, std::size_t batch) {
+   for (std::size_t b = 0; b < batch; ++b) {
+      const auto i = static_cast<std::int64_t>(b);
+      gemm_rowmajor(trans_a, trans_b, m, n, k, alpha, baseA + i * a_bs, lda,
+                    baseB + i * b_bs, ldb, beta, baseC + i * c_bs, ldc);
+   }
+}
+
+#if defined(FUSION_HAS_CBLAS_GEMM_BATCH)
+// The library's grouped batch entry point (MKL, recent OpenBLAS) with one
+// group: it schedules the items over its own threads.
+template <typename T>
+inline void batched_gemm_rowmajor_api(bool trans_a, bool trans_b, int m,
+                                      int n, int k, T alpha, const T *baseA,
+                                      int lda, std::int64_t a_bs,
+                                      const T *baseB, int ldb,
+                                      std::int64_t b_bs, T beta, T *baseC,
+                                      int ldc, std::int64_t c_bs,
+                                      std::size_t batch) {
+   std::vector<const T *> a(batch);
+   std::vector<const T *> b(batch);
+   std::vector<T *> c(batch);
+   for (std::size_t i = 0; i < batch; ++i) {
+      const auto s = static_cast<std::int64_t>(i);
+      a[i] = baseA + s * a_bs;
+      b[i] = baseB + s * b_bs;
+      c[i] = baseC + s * c_bs;
+   }
+   const CBLAS_TRANSPOSE ta = trans_a ? CblasTrans : CblasNoTrans;
+   const CBLAS_TRANSPOSE tb = trans_b ? CblasTrans : CblasNoTrans;
+   const int group_size = static_cast<int>(batch);
+   if constexpr (std::is_same_v<T, double>) {
+      cblas_dgemm_batch(CblasRowMajor, &ta, &tb, &m, &n, &k, &alpha, a.data(),
+                        &lda, b.data(), &ldb, &beta, c.data(), &ldc, 1,
+                        &group_size);
+   } else {
+      cblas_sgemm_batch(CblasRowMajor, &ta, &tb, &m, &n, &k, &alpha, a.data(),
+                        &lda, b.data(), &ldb, &beta, c.data(), &ldc, 1,
+                        &group_size);
+   }
+}
+#endif
+
+// y = alpha * op(A) x + beta * y, A stored row-major as rows x cols.
+inline void gemv_rowmajor(bool trans, int rows, int cols, float alpha,
+                          const float *A, int lda, const float *x, int incx,
+                          float beta, float *y, int incy) {
+   cblas_sgemv(CblasRowMajor, trans ? CblasTrans : CblasNoTrans, rows, cols,
+               alpha, A, lda, x, incx, beta, y, incy);
+}
+
+inline void gemv_rowmajor(bool trans, int rows, int cols, double alpha,
+                          const double *A, int lda, const double *x, int incx,
+                          double beta, double *y, int incy) {
+   cblas_dgemv(CblasRowMajor, trans ? CblasTrans : CblasNoTrans, rows, cols,
+               alpha, A, lda, x, incx, beta, y, incy);
+}
+
+inline float dot(int n, const float *x, int incx, const float *y, int incy) {
+   return cblas_sdot(n, x, incx, y, incy);
+}
+
+inline double dot(int n, const double *x, int incx, const double *y,
+                  int incy) {
+   return cblas_ddot(n, x, incx, y, incy);
+}
+
+// y += alpha x
+inline void axpy(int n, float alpha, const float *x, int incx, float *y,
+                 int incy) {
+   cblas_saxpy(n, alpha, x, incx, y, incy);
+}
+
+inline void axpy(int n, double alpha, const double *x, int incx, double *y,
+                 int incy) {
+   cblas_daxpy(n, alpha, x, incx, y, incy);
+}
+
+template <typename T>
+inline void batched_gemm_rowmajor_nn(const T *baseA, const T *baseB, T *baseC,
+                                     int m, int n, int k, std::size_t batch,
+                                     T alpha, T beta) {
    const std::size_t Asz = std::size_t(m) * std::size_t(k);
    const std::size_t Bsz = std::size_t(k) * std::size_t(n);
    const std::size_t Csz = std::size_t(m) * std::size_t(n);
 
    for (std::size_t b = 0; b < batch; ++b) {
-      const float *A = baseA + b * Asz;
-      const float *B = baseB + b * Bsz;
-      float *C = baseC + b * Csz;
+      const T *A = baseA + b * Asz;
+      const T *B = baseB + b * Bsz;
+      T *C = baseC + b * Csz;
       gemm_rowmajor_nn(A, B, C, m, n, k, alpha, beta);
    }
 }
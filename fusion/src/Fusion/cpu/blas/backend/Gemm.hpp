@@ -1,19 +1,38 @@
 #ifndef FUSION_CPU_BLAS_GEMM_HPP
 #define FUSION_CPU_BLAS_GEMM_HPP
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <type_traits>
 
+#include "Fusion/core/Parallel.h"
+
+// FUSION_NATIVE_GEMM routes every GEMM through the packed native kernel
+// instead of the linked BLAS library.
+#if defined(FUSION_NATIVE_GEMM)
+#include "Fusion/cpu/blas/BlasFallback.hpp"
+#else
 #include "BlasCblas.hpp"
+#if defined(FUSION_HAS_CBLAS_GEMM_BATCH)
+#define FUSION_GEMM_LIBRARY_BATCH 1
+#endif
+#endif
 
 namespace fusion::blas {
 
+// Element types the BLAS routines exist for (s* and d*).
+template <typename T>
+constexpr bool blas_precision =
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
 // single GEMM
 template <typename T>
 inline void gemm_rowmajor_nn(const T *A, const T *B, T *C, int m, int n, int k,
                              T alpha, T beta) {
-   static_assert(std::is_same_v<T, float>,
-                 "gemm_rowmajor_nn: only float is implemented currently");
+   static_assert(blas_precision<T>,
+                 "gemm_rowmajor_nn: only float and double are implemented");
    backend::gemm_rowmajor_nn(A, B, C, m, n, k, alpha, beta);
 }
 
@@ -23,12 +42,100 @@ inline void batched_gemm_rowmajor_nn(const T *baseA, const T *baseB, T *baseC,
                                      int m, int n, int k, std::size_t batch,
                                      T alpha, T beta) {
    static_assert(
-       std::is_same_v<T, float>,
-       "batched_gemm_rowmajor_nn: only float is implemented currently");
+       blas_precision<T>,
+       "batched_gemm_rowmajor_nn: only float and double are implemented");
    backend::batched_gemm_rowmajor_nn(baseA, baseB, baseC, m, n, k, batch, alpha,
                                      beta);
 }
 
+// How a batch of independent GEMMs is spread over the machine.
+//   Sequential:   one BLAS call per item, each free to use every BLAS thread.
+//                 Best when single items are large enough to thread well.
+//   OverBatch:    items split across the Fusion pool, each a single-threaded
+//                 BLAS call. Best for many small items (attention heads).
+//   LibraryBatch: the BLAS library's own batched entry point, when built
+//                 with FUSION_HAS_CBLAS_GEMM_BATCH.
+enum class BatchedGemmStrategy { Auto, Sequential, OverBatch, LibraryBatch };
+
+// M*N*K from which one GEMM keeps every BLAS thread busy (about 128^3).
+constexpr std::size_t kThreadedGemmVolume = std::size_t{1} << 21;
+// M*N*K handed to one pool task at a minimum, so tiny items are grouped.
+constexpr std::size_t kBatchTaskVolume = std::size_t{1} << 15;
+
+inline BatchedGemmStrategy choose_batched_gemm_strategy(int m, int n, int k,
+                                                        std::size_t batch,
+                                                        std::size_t threads) {
+   if (batch <= 1 || threads <= 1) {
+      return BatchedGemmStrategy::Sequential;
+   }
+   const std::size_t volume = std::size_t(m) * std::size_t(n) * std::size_t(k);
+   if (volume >= kThreadedGemmVolume && batch < threads) {
+      return BatchedGemmStrategy::Sequential;
+   }
+#if defined(FUSION_GEMM_LIBRARY_BATCH)
+   return BatchedGemmStrategy::LibraryBatch;
+#else
+   return BatchedGemmStrategy::OverBatch;
+#endif
+}
+
+// batched GEMM over transposed and/or strided operands
+template <typename T>
+inline void batched_gemm_rowmajor(
+    bool trans_a, bool trans_b, int m, int n, int k, T alpha, const T *baseA,
+    int lda, std::int64_t a_bs, const T *baseB, int ldb, std::int64_t b_bs,
+    T beta, T *baseC, int ldc, std::int64_t c_bs, std::size_t batch,
+    BatchedGemmStrategy strategy = BatchedGemmStrategy::Auto) {
+   static_assert(
+       blas_precision<T>,
+       "batched_gemm_rowmajor: only float and double are implemented");
+   if (strategy == BatchedGemmStrategy::Auto) {
+      strategy = choose_batched_gemm_strategy(
+          m, n, k, batch, fusion::parallel::max_concurrency());
+   }
+
+#if defined(FUSION_GEMM_LIBRARY_BATCH)
+   if (strategy == BatchedGemmStrategy::LibraryBatch) {
+      backend::batched_gemm_rowmajor_api(trans_a, trans_b, m, n, k, alpha,
+                                         baseA, lda, a_bs, baseB, ldb, b_bs,
+                                         beta, baseC, ldc, c_bs, batch);
+      return;
+   }
+#else
+   if (strategy == BatchedGemmStrategy::LibraryBatch) {
+      strategy = BatchedGemmStrategy::OverBatch;
+   }
+#endif
+
+   if (strategy == BatchedGemmStrategy::OverBatch && batch > 1) {
+      // Inside a parallel region the BLAS thread count belongs to whoever
+      // opened it (the graph executor sets it per run); only top-level calls
+      // drop BLAS to one thread for the duration.
+      std::optional<fusion::parallel::BlasThreadScope> blas;
+      if (!fusion::parallel::in_parallel_region()) {
+         blas.emplace(1);
+      }
+      const std::size_t volume = std::max<std::size_t>(
+          std::size_t(m) * std::size_t(n) * std::size_t(k), 1);
+      const std::size_t grain =
+          std::max<std::size_t>(kBatchTaskVolume / volume, 1);
+      fusion::parallel::parallel_for(
+          0, batch, grain, [&](std::size_t lo, std::size_t hi) {
+             backend::batched_gemm_rowmajor(
+                 trans_a, trans_b, m, n, k, alpha,
+                 baseA + static_cast<std::int64_t>(lo) * a_bs, lda, a_bs,
+                 baseB + static_cast<std::int64_t>(lo) * b_bs, ldb, b_bs,
+                 beta, baseC + static_cast<std::int64_t>(lo) * c_bs, ldc,
+                 c_bs, hi - lo);
+          });
+      return;
+   }
+
+   backend::batched_gemm_rowmajor(trans_a, trans_b, m, n, k, alpha, baseA, lda,
+                                  a_bs, baseB, ldb, b_bs, beta, baseC, ldc,
+                                  c_bs, batch);
+}
+
 } // namespace fusion::blas
 
 #endif // FUSION_CPU_BLAS_GEMM_HPP
@@ -0,0 +1,142 @@
+#ifndef FUSION_CPU_SIMD_CONVERT_HPP
+#define FUSION_CPU_SIMD_CONVERT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "Fusion/core/Float16.hpp"
+
+#if defined(__AVX2__) || defined(__F16C__) || defined(__AVX512BF16__)
+#include <immintrin.h>
+#endif
+#if defined(FUSION_ENABLE_NEON) && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define FUSION_NEON_CONVERT 1
+#endif
+
+// Bulk conversion between the 16-bit storage types and float. Kernels that
+// take 16-bit data widen it a block at a time into a stack buffer, run the
+// float kernel there and narrow the result, so the arithmetic (and any
+// accumulation) is fp32 while memory traffic stays 16-bit.
+namespace simd {
+
+// Elements per stack block: 2 KiB of float, well inside L1.
+constexpr std::size_t kWidenBlock = 512;
+
+inline void widen(const fusion::bfloat16 *src, float *dst, std::size_t n) {
+   std::size_t i = 0;
+#if defined(__AVX2__)
+   for (; i + 8 <= n; i += 8) {
+      const __m128i h =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+      const __m256i w = _mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16);
+      _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(w));
+   }
+#elif defined(FUSION_NEON_CONVERT)
+   for (; i + 4 <= n; i += 4) {
+      const uint16x4_t h =
+          vld1_u16(reinterpret_cast<const std::uint16_t *>(src + i));
+      vst1q_f32(dst + i, vreinterpretq_f32_u32(vshll_n_u16(h, 16)));
+   }
+#endif
+   for (; i < n; ++i) {
+      dst[i] = src[i];
+   }
+}
+
+inline void narrow(const float *src, fusion::bfloat16 *dst, std::size_t n) {
+   std::size_t i = 0;
+#if defined(__AVX512BF16__) && defined(__AVX512VL__)
+   for (; i + 8 <= n; i += 8) {
+      const __m128bh h = _mm256_cvtneps_pbh(_mm256_loadu_ps(src + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                       reinterpret_cast<const __m128i &>(h));
+   }
+#elif defined(__AVX2__)
+   // Round to nearest even on the integer bits; NaNs stay quiet NaNs.
+   const __m256i one = _mm256_set1_epi32(1);
+   const __m256i bias = _mm256_set1_epi32(0x7fff);
+   const __m256i abs_mask = _mm256_set1_epi32(0x7fffffff);
+   const __m256i inf = _mm256_set1_epi32(0x7f800000);
+   const __m256i quiet = _mm256_set1_epi32(0x40);
+   for (; i + 8 <= n; i += 8) {
+      const __m256i x = _mm256_castps_si256(_mm256_loadu_ps(src + i));
+      const __m256i odd = _mm256_and_si256(_mm256_srli_epi32(x, 16), one);
+      const __m256i rounded = _mm256_srli_epi32(
+          _mm256_add_epi32(x, _mm256_add_epi32(bias, odd)), 16);
+      const __m256i nan = _mm256_or_si256(_mm256_srli_epi32(x, 16), quiet);
+      const __m256i is_nan =
+          _mm256_cmpgt_epi32(_mm256_and_si256(x, abs_mask), inf);
+      const __m256i h = _mm256_blendv_epi8(rounded, nan, is_nan);
+      // packus interleaves the 128-bit lanes; the permute restores order.
+      const __m256i packed = _mm256_permute4x64_epi64(
+          _mm256_packus_epi32(h, _mm256_setzero_si256()), 0xd8);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                       _mm256_castsi256_si128(packed));
+   }
+#endif
+   for (; i < n; ++i) {
+      dst[i] = src[i];
+   }
+}
+
+inline void widen(const fusion::float16 *src, float *dst, std::size_t n) {
+   std::size_t i = 0;
+#if defined(__F16C__)
+   for (; i + 8 <= n; i += 8) {
+      const __m128i h =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+      _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+   }
+#elif defined(FUSION_NEON_CONVERT)
+   for (; i + 4 <= n; i += 4) {
+      const uint16x4_t h =
+          vld1_u16(reinterpret_cast<const std::uint16_t *>(src + i));
+      vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(h)));
+   }
+#endif
+   for (; i < n; ++i) {
+      dst[i] = src[i];
+   }
+}
+
+inline void narrow(const float *src, fusion::float16 *dst, std::size_t n) {
+   std::size_t i = 0;
+#if defined(__F16C__)
+   for (; i + 8 <= n; i += 8) {
+      const __m128i h =
+          _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), h);
+   }
+#elif defined(FUSION_NEON_CONVERT)
+   for (; i + 4 <= n; i += 4) {
+      const float16x4_t h = vcvt_f16_f32(vld1q_f32(src + i));
+      vst1_u16(reinterpret_cast<std::uint16_t *>(dst + i),
+               vreinterpret_u16_f16(h));
+   }
+#endif
+   for (; i < n; ++i) {
+      dst[i] = src[i];
+   }
+}
+
+// src to dst for any pair of element types; the 16-bit <-> float pairs take
+// the kernels above.
+template <typename From, typename To>
+inline void convert(const From *src, To *dst, std::size_t n) {
+   if constexpr (fusion::is_half_float_v<From> && std::is_same_v<To, float>) {
+      widen(src, dst, n);
+   } else if constexpr (std::is_same_v<From, float> &&
+                        fusion::is_half_float_v<To>) {
+      narrow(src, dst, n);
+   } else {
+      for (std::size_t i = 0; i < n; ++i) {
+         dst[i] = static_cast<To>(static_cast<fusion::accum_t<From>>(src[i]));
+      }
+   }
+}
+
+} // namespace simd
+
+#endif // FUSION_CPU_SIMD_CONVERT_HPP
@@ -1,8 +1,12 @@
 #ifndef FUSION_CPU_SIMD_TRAITS_HPP
 #define FUSION_CPU_SIMD_TRAITS_HPP
 
+#include <algorithm>
 #include <cstddef>
 
+#include "Fusion/core/Float16.hpp"
+
+#include "Convert.hpp"
 #include "SimdTags.hpp"
 
 #if defined(FUSION_ENABLE_NEON) && defined(__ARM_NEON)
@@ -11,8 +15,6 @@
 #include "VecFallback.hpp"
 #endif
 
-/* TODO: evaluate the use of neon_scalar for non-commutative operations */
-
 template <class Tag, typename T> struct simd_traits {
    static constexpr bool available = false;
 };
@@ -44,7 +46,7 @@ template <typename T> struct simd_traits<SubtractSIMD, T> {
       if (b_scalar) {
          simd::sub_contiguous_scalar<T>(out, a, *b, n);
       } else if (a_scalar) {
-         simd::sub_contiguous_scalar<T>(out, b, *a, n);
+         simd::sub_contiguous_scalar_lhs<T>(out, *a, b, n);
       } else {
          simd::sub_contiguous<T>(out, a, b, n);
       }
@@ -60,7 +62,7 @@ template <typename T> struct simd_traits<DivideSIMD, T> {
       if (b_scalar) {
          simd::div_contiguous_scalar<T>(out, a, *b, n);
       } else if (a_scalar) {
-         simd::div_contiguous_scalar<T>(out, b, *a, n);
+         simd::div_contiguous_scalar_lhs<T>(out, *a, b, n);
       } else {
          simd::div_contiguous<T>(out, a, b, n);
       }
@@ -108,7 +110,7 @@ template <typename T> struct simd_traits<PowerSIMD, T> {
       if (b_scalar) {
          simd::pow_contiguous_scalar<T>(out, a, *b, n);
       } else if (a_scalar) {
-         simd::pow_contiguous_scalar<T>(out, b, *a, n);
+         simd::pow_contiguous_scalar_lhs<T>(out, *a, b, n);
       } else {
          simd::pow_contiguous<T>(out, a, b, n);
       }
@@ -124,7 +126,7 @@ template <typename T> struct simd_traits<GreaterThanEqualSIMD, T> {
       if (b_scalar) {
          simd::greater_than_equal_contiguous_scalar<T>(out, a, *b, n);
       } else if (a_scalar) {
-         simd::greater_than_equal_contiguous_scalar<T>(out, b, *a, n);
+         simd::greater_than_equal_contiguous_scalar_lhs<T>(out, *a, b, n);
       } else {
          simd::greater_than_equal_contiguous<T>(out, a, b, n);
       }
@@ -140,7 +142,7 @@ template <typename T> struct simd_traits<GreaterThanSIMD, T> {
       if (b_scalar) {
          simd::greater_than_contiguous_scalar<T>(out, a, *b, n);
       } else if (a_scalar) {
-         simd::greater_than_contiguous_scalar<T>(out, b, *a, n);
+         simd::greater_than_contiguous_scalar_lhs<T>(out, *a, b, n);
       } else {
          simd::greater_than_contiguous<T>(out, a, b, n);
       }
@@ -186,6 +188,120 @@ template <typename T> struct simd_traits<SumSIMD, T> {
       simd::sum_contiguous<T>(&acc, a, n);
       return acc;
    }
+
+   // Column reduction: out[j] += sum over `rows` rows of a[i * row_stride + j].
+   static void reduce_columns(T *out, const T *a, std::size_t rows,
+                              std::size_t cols, std::size_t row_stride) {
+      simd::sum_columns_contiguous<T>(out, a, rows, cols, row_stride);
+   }
+};
+
+// ---------- 16-bit floats ----------
+// bfloat16 and float16 run the float kernels over blocks widened on the
+// stack: 16-bit loads and stores, fp32 arithmetic and accumulation.
+template <class Tag, typename H> struct widened_binary_traits {
+   static constexpr bool available = simd_traits<Tag, float>::available;
+
+   static void execute_contiguous(const H *a, const H *b, H *out, std::size_t n,
+                                  bool a_scalar, bool b_scalar) {
+      float wa[simd::kWidenBlock];
+      float wb[simd::kWidenBlock];
+      float wo[simd::kWidenBlock];
+      const float sa = a_scalar ? float(*a) : 0.0f;
+      const float sb = b_scalar ? float(*b) : 0.0f;
+      for (std::size_t i = 0; i < n; i += simd::kWidenBlock) {
+         const std::size_t len = std::min(simd::kWidenBlock, n - i);
+         if (!a_scalar) {
+            simd::widen(a + i, wa, len);
+         }
+         if (!b_scalar) {
+            simd::widen(b + i, wb, len);
+         }
+         simd_traits<Tag, float>::execute_contiguous(
+             a_scalar ? &sa : wa, b_scalar ? &sb : wb, wo, len, a_scalar,
+             b_scalar);
+         simd::narrow(wo, out + i, len);
+      }
+   }
+};
+
+template <class Tag, typename H> struct widened_unary_traits {
+   static constexpr bool available = simd_traits<Tag, float>::available;
+
+   static void execute_contiguous(const H *a, H *out, std::size_t n,
+                                  bool a_scalar) {
+      float wa[simd::kWidenBlock];
+      float wo[simd::kWidenBlock];
+      for (std::size_t i = 0; i < n; i += simd::kWidenBlock) {
+         const std::size_t len = std::min(simd::kWidenBlock, n - i);
+         simd::widen(a + i, wa, len);
+         simd_traits<Tag, float>::execute_contiguous(wa, wo, len, a_scalar);
+         simd::narrow(wo, out + i, len);
+      }
+   }
+};
+
+template <fusion::HalfFloat H>
+struct simd_traits<AddSIMD, H> : widened_binary_traits<AddSIMD, H> {};
+template <fusion::HalfFloat H>
+struct simd_traits<SubtractSIMD, H> : widened_binary_traits<SubtractSIMD, H> {
+};
+template <fusion::HalfFloat H>
+struct simd_traits<DivideSIMD, H> : widened_binary_traits<DivideSIMD, H> {};
+template <fusion::HalfFloat H>
+struct simd_traits<MultiplySIMD, H> : widened_binary_traits<MultiplySIMD, H> {
+};
+template <fusion::HalfFloat H>
+struct simd_traits<MaximumSIMD, H> : widened_binary_traits<MaximumSIMD, H> {};
+template <fusion::HalfFloat H>
+struct simd_traits<PowerSIMD, H> : widened_binary_traits<PowerSIMD, H> {};
+template <fusion::HalfFloat H>
+struct simd_traits<GreaterThanEqualSIMD, H>
+    : widened_binary_traits<GreaterThanEqualSIMD, H> {};
+template <fusion::HalfFloat H>
+struct simd_traits<GreaterThanSIMD, H>
+    : widened_binary_traits<GreaterThanSIMD, H> {};
+template <fusion::HalfFloat H>
+struct simd_traits<ExponentialSIMD, H>
+    : widened_unary_traits<ExponentialSIMD, H> {};
+template <fusion::HalfFloat H>
+struct simd_traits<NaturalLogSIMD, H>
+    : widened_unary_traits<NaturalLogSIMD, H> {};
+template <fusion::HalfFloat H>
+struct simd_traits<SqrtSIMD, H> : widened_unary_traits<SqrtSIMD, H> {};
+
+// Sums come back in fp32; only the caller's final store rounds.
+template <fusion::HalfFloat H> struct simd_traits<SumSIMD, H> {
+   static constexpr bool available = true;
+
+   static float reduce_contiguous(const H *a, std::size_t n) {
+      float w[simd::kWidenBlock];
+      float acc = 0.0f;
+      for (std::size_t i = 0; i < n; i += simd::kWidenBlock) {
+         const std::size_t len = std::min(simd::kWidenBlock, n - i);
+         simd::widen(a + i, w, len);
+         acc += simd_traits<SumSIMD, float>::reduce_contiguous(w, len);
+      }
+      return acc;
+   }
+
+   // out[j] += the column sums, kept in fp32 across all rows of a panel.
+   static void reduce_columns(H *out, const H *a, std::size_t rows,
+                              std::size_t cols, std::size_t row_stride) {
+      float acc[simd::kWidenBlock];
+      float w[simd::kWidenBlock];
+      for (std::size_t j0 = 0; j0 < cols; j0 += simd::kWidenBlock) {
+         const std::size_t len = std::min(simd::kWidenBlock, cols - j0);
+         simd::widen(out + j0, acc, len);
+         for (std::size_t i = 0; i < rows; ++i) {
+            simd::widen(a + i * row_stride + j0, w, len);
+            for (std::size_t j = 0; j < len; ++j) {
+               acc[j] += w[j];
+            }
+         }
+         simd::narrow(acc, out + j0, len);
+      }
+   }
 };
 
 #endif // FUSION_CPU_SIMD_TRAITS_HPP
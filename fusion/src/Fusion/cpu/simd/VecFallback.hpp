@@ -38,6 +38,38 @@ inline void sum_contiguous(T *dst, const T *a, std::size_t n) {
    *dst = acc;
 }
 
+// dst[j] += sum_i a[i * row_stride + j] for j < cols. Whole rows are added
+// into dst so the inner loop is unit-stride and vectorises. Columns are
+// processed in panels whose accumulators stay in L1 however tall `a` is, and
+// kSumRowBlock rows are folded in registers per store to dst.
+static constexpr std::size_t kSumColumnBlock = 512;
+static constexpr std::size_t kSumRowBlock = 4;
+
+template <typename T>
+inline void sum_columns_contiguous(T *__restrict dst, const T *__restrict a,
+                                   std::size_t rows, std::size_t cols,
+                                   std::size_t row_stride) {
+   for (std::size_t j0 = 0; j0 < cols; j0 += kSumColumnBlock) {
+      const std::size_t w =
+          (cols - j0 < kSumColumnBlock) ? cols - j0 : kSumColumnBlock;
+      T *__restrict d = dst + j0;
+      std::size_t i = 0;
+      for (; i + kSumRowBlock <= rows; i += kSumRowBlock) {
+         const T *__restrict r0 = a + i * row_stride + j0;
+         const T *__restrict r1 = r0 + row_stride;
+         const T *__restrict r2 = r1 + row_stride;
+         const T *__restrict r3 = r2 + row_stride;
+         for (std::size_t j = 0; j < w; ++j)
+            d[j] += (r0[j] + r1[j]) + (r2[j] + r3[j]);
+      }
+      for (; i < rows; ++i) {
+         const T *__restrict r = a + i * row_stride + j0;
+         for (std::size_t j = 0; j < w; ++j)
+            d[j] += r[j];
+      }
+   }
+}
+
 template <typename T>
 inline void sqrt_contiguous(T *__restrict dst, const T *__restrict a,
                             std::size_t n) {
@@ -151,6 +183,46 @@ inline void maximum_contiguous_scalar(T *__restrict dst, const T *__restrict a,
       dst[i] = a[i] > b ? a[i] : b;
 }
 
+// Scalar on the left-hand side: dst[i] = a op b[i]. Only the
+// non-commutative ops need these.
+template <typename T>
+inline void sub_contiguous_scalar_lhs(T *__restrict dst, const T a,
+                                      const T *__restrict b, std::size_t n) {
+   for (std::size_t i = 0; i < n; ++i)
+      dst[i] = a - b[i];
+}
+
+template <typename T>
+inline void div_contiguous_scalar_lhs(T *__restrict dst, const T a,
+                                      const T *__restrict b, std::size_t n) {
+   for (std::size_t i = 0; i < n; ++i)
+      dst[i] = a / b[i];
+}
+
+template <typename T>
+inline void pow_contiguous_scalar_lhs(T *__restrict dst, const T a,
+                                      const T *__restrict b, std::size_t n) {
+   for (std::size_t i = 0; i < n; ++i)
+      dst[i] = std::pow(a, b[i]);
+}
+
+template <typename T>
+inline void greater_than_contiguous_scalar_lhs(T *__restrict dst, const T a,
+                                               const T *__restrict b,
+                                               std::size_t n) {
+   for (std::size_t i = 0; i < n; ++i)
+      dst[i] = a > b[i];
+}
+
+template <typename T>
+inline void greater_than_equal_contiguous_scalar_lhs(T *__restrict dst,
+                                                     const T a,
+                                                     const T *__restrict b,
+                                                     std::size_t n) {
+   for (std::size_t i = 0; i < n; ++i)
+      dst[i] = a >= b[i];
+}
+
 } // namespace simd
 
 #endif // FUSION_CPU_VEC_FALLBACK_HPP
@@ -26,8 +26,8 @@ static constexpr std::size_t kBlock = kUnroll * kF32Lanes; // 16
 static constexpr std::size_t kStepVec = kBlock;
 static constexpr std::size_t kStep = kUnroll;
 
-// TODO: we DO NOT support lhs side scalar operations - MAKE SURE you deal with
-// non-commutative OPS!
+// Non-commutative ops take a left-hand scalar through the *_scalar_lhs
+// kernels at the end of this file.
 
 // =========================
 // Core contiguous kernels - Current alignment in fixed 64 // TODO: Fix
@@ -46,6 +46,18 @@ inline void sum_contiguous(T *__restrict dst, const T *__restrict a,
        [](T acc, T x) -> T { return acc + x; });
 }
 
+template <typename T>
+inline void sum_columns_contiguous(T *__restrict dst, const T *__restrict a,
+                                   std::size_t rows, std::size_t cols,
+                                   std::size_t row_stride) {
+
+   using B = Neon128<T>;
+   return simd::detail::column_reduce_apply<T, B>(
+       dst, a, rows, cols, row_stride,
+       [](B::vec vx, B::vec vy) -> B::vec { return B::add(vx, vy); },
+       [](T x, T y) -> T { return x + y; });
+}
+
 template <typename T>
 inline void sqrt_contiguous(T *__restrict dst, const T *__restrict a,
                             std::size_t n) {
@@ -106,8 +118,8 @@ inline void greater_than_contiguous(T *__restrict dst, const T *__restrict a,
    return simd::detail::binary_contiguous_apply<T, B>(
        dst, a, b, n,
        [](B::vec vx, B::vec vy) -> B::vec {
-          return B::blend(B::cgt(vx, vy), B::duplicate(1.0f),
-                          B::duplicate(0.0f));
+          return B::blend(B::cgt(vx, vy), B::duplicate(T(1)),
+                          B::duplicate(T(0)));
        },
        [](T x, T y) -> T { return x > y; });
 }
@@ -121,8 +133,8 @@ greater_than_equal_contiguous(T *__restrict dst, const T *__restrict a,
    return simd::detail::binary_contiguous_apply<T, B>(
        dst, a, b, n,
        [](B::vec vx, B::vec vy) -> B::vec {
-          return B::blend(B::cge(vx, vy), B::duplicate(1.0f),
-                          B::duplicate(0.0f));
+          return B::blend(B::cge(vx, vy), B::duplicate(T(1)),
+                          B::duplicate(T(0)));
        },
        [](T x, T y) -> T { return x >= y; });
 }
@@ -175,8 +187,7 @@ inline void div_contiguous(T *__restrict dst, const T *__restrict a,
 // Scalar wrappers
 // =========================
 // Useful when your inner dim sees stride==0 for RHS/LHS (broadcast scalar).
-// If LHS is the scalar instead, you can either add "scalar_lhs" variants
-// or just swap operands in the caller for commutative ops.
+// Commutative ops swap operands in the caller when LHS is the scalar.
 
 template <typename T>
 inline void greater_than_contiguous_scalar(T *__restrict dst,
@@ -187,8 +198,8 @@ inline void greater_than_contiguous_scalar(T *__restrict dst,
    return simd::detail::binary_contiguous_scalar_apply<T, B>(
        dst, a, b, n,
        [](B::vec vx, B::vec vy) -> B::vec {
-          return B::blend(B::cgt(vx, vy), B::duplicate(1.0f),
-                          B::duplicate(0.0f));
+          return B::blend(B::cgt(vx, vy), B::duplicate(T(1)),
+                          B::duplicate(T(0)));
        },
        [](T x, T y) -> T { return x > y; });
 }
@@ -202,8 +213,8 @@ inline void greater_than_equal_contiguous_scalar(T *__restrict dst,
    return simd::detail::binary_contiguous_scalar_apply<T, B>(
        dst, a, b, n,
        [](B::vec vx, B::vec vy) -> B::vec {
-          return B::blend(B::cge(vx, vy), B::duplicate(1.0f),
-                          B::duplicate(0.0f));
+          return B::blend(B::cge(vx, vy), B::duplicate(T(1)),
+                          B::duplicate(T(0)));
        },
        [](T x, T y) -> T { return x >= y; });
 }
@@ -277,6 +288,73 @@ inline void div_contiguous_scalar(T *__restrict dst, const T *__restrict a,
        [](T x, T y) -> T { return x / y; });
 }
 
+// Scalar on the left-hand side: dst[i] = a op b[i]. The shared loop always
+// passes the tensor operand first, so the vector and tail ops swap back.
+
+template <typename T>
+inline void sub_contiguous_scalar_lhs(T *__restrict dst, const T a,
+                                      const T *__restrict b, std::size_t n) {
+
+   using B = Neon128<T>;
+   return simd::detail::binary_contiguous_scalar_apply<T, B>(
+       dst, b, a, n,
+       [](B::vec vy, B::vec vx) -> B::vec { return B::sub(vx, vy); },
+       [](T y, T x) -> T { return x - y; });
+}
+
+template <typename T>
+inline void div_contiguous_scalar_lhs(T *__restrict dst, const T a,
+                                      const T *__restrict b, std::size_t n) {
+
+   using B = Neon128<T>;
+   return simd::detail::binary_contiguous_scalar_apply<T, B>(
+       dst, b, a, n,
+       [](B::vec vy, B::vec vx) -> B::vec { return B::div(vx, vy); },
+       [](T y, T x) -> T { return x / y; });
+}
+
+template <typename T>
+inline void pow_contiguous_scalar_lhs(T *__restrict dst, const T a,
+                                      const T *__restrict b, std::size_t n) {
+
+   using B = Neon128<T>;
+   return simd::detail::binary_contiguous_scalar_apply<T, B>(
+       dst, b, a, n,
+       [](B::vec vy, B::vec vx) -> B::vec { return B::pow(vx, vy); },
+       [](T y, T x) -> T { return std::pow(x, y); });
+}
+
+template <typename T>
+inline void greater_than_contiguous_scalar_lhs(T *__restrict dst, const T a,
+                                               const T *__restrict b,
+                                               std::size_t n) {
+
+   using B = Neon128<T>;
+   return simd::detail::binary_contiguous_scalar_apply<T, B>(
+       dst, b, a, n,
+       [](B::vec vy, B::vec vx) -> B::vec {
+          return B::blend(B::cgt(vx, vy), B::duplicate(T(1)),
+                          B::duplicate(T(0)));
+       },
+       [](T y, T x) -> T { return x > y; });
+}
+
+template <typename T>
+inline void greater_than_equal_contiguous_scalar_lhs(T *__restrict dst,
+                                                     const T a,
+                                                     const T *__restrict b,
+                                                     std::size_t n) {
+
+   using B = Neon128<T>;
+   return simd::detail::binary_contiguous_scalar_apply<T, B>(
+       dst, b, a, n,
+       [](B::vec vy, B::vec vx) -> B::vec {
+          return B::blend(B::cge(vx, vy), B::duplicate(T(1)),
+                          B::duplicate(T(0)));
+       },
+       [](T y, T x) -> T { return x >= y; });
+}
+
 } // namespace simd
 #else // --------- Fallback (non-NEON builds) ---------
 
@@ -2,6 +2,7 @@
 #define FUSION_CPU_BACKEND_CONCEPT_HPP
 
 #include <concepts>
+#include <cstddef>
 
 /* TODO: refactor this into multiple concepts */
 
@@ -65,9 +66,22 @@ concept BackendReduction = requires(typename B::vec v) {
    { B::horizontal_add(v) } -> std::same_as<typename B::U>;
 };
 
+// The subset a register-blocked kernel (e.g. the packed GEMM) needs. Every
+// full backend provides it, and so does the portable VecExt.
+template <typename B>
+concept BackendFma = requires(const typename B::U *ptr, typename B::U *out,
+                              typename B::vec v, typename B::U s) {
+   { B::kLanes } -> std::convertible_to<std::size_t>;
+   { B::load(ptr) } -> std::same_as<typename B::vec>;
+   { B::store(out, v) };
+   { B::duplicate(s) } -> std::same_as<typename B::vec>;
+   { B::fma(v, v, v) } -> std::same_as<typename B::vec>;
+};
+
 template <typename B>
 concept BackendConcept =
     BackendCore<B> && BackendLoadStore<B> && BackendComparison<B> &&
-    BackendArithmetic<B> && BackendTranscendental<B> && BackendReduction<B>;
+    BackendArithmetic<B> && BackendTranscendental<B> && BackendReduction<B> &&
+    BackendFma<B>;
 
 #endif // FUSION_CPU_BACKEND_CONCEPT_HPP
@@ -47,6 +47,9 @@ template <> struct Neon128<float> {
    static vec mul(vec x, vec y) { return vmulq_f32(x, y); }
    static vec div(vec x, vec y) { return vdivq_f32(x, y); }
 
+   // acc + x * y, fused.
+   static vec fma(vec acc, vec x, vec y) { return vfmaq_f32(acc, x, y); }
+
    static vec maximum(vec x, vec y) { return vmaxq_f32(x, y); }
    static vec pow(vec x, vec y) { return Sleef_powf4_u10(x, y); }
 
@@ -65,4 +68,51 @@ template <> struct Neon128<float> {
    }
 };
 
+// Two double lanes per register; the float64x2 intrinsics are A64 only.
+#if defined(__aarch64__)
+template <> struct Neon128<double> {
+
+   using U = double;
+   using vec = float64x2_t;
+   using wide_vec = float64x2x4_t;
+   using mask = uint64x2_t;
+
+   static constexpr std::size_t kVectorBytes = 16;
+   static constexpr std::size_t kLanes = kVectorBytes / sizeof(U);
+   static constexpr std::size_t kUnroll = 4;
+   static constexpr std::size_t kBlock = kUnroll * kLanes; // 8
+
+   static constexpr std::size_t kStepVec = kBlock;
+   static constexpr std::size_t kStep = kLanes;
+
+   static wide_vec wide_load(const U *x) { return vld1q_f64_x4(x); }
+   static vec load(const U *x) { return vld1q_f64(x); }
+
+   static void wide_store(U *dst, wide_vec x) { vst1q_f64_x4(dst, x); }
+   static void store(U *dst, vec x) { vst1q_f64(dst, x); }
+
+   static mask cgt(vec x, vec y) { return vcgtq_f64(x, y); }
+   static mask cge(vec x, vec y) { return vcgeq_f64(x, y); }
+   static vec duplicate(U x) { return vdupq_n_f64(x); }
+
+   static vec blend(mask m, vec x, vec y) { return vbslq_f64(m, x, y); }
+
+   static vec add(vec x, vec y) { return vaddq_f64(x, y); }
+   static vec sub(vec x, vec y) { return vsubq_f64(x, y); }
+   static vec mul(vec x, vec y) { return vmulq_f64(x, y); }
+   static vec div(vec x, vec y) { return vdivq_f64(x, y); }
+
+   static vec fma(vec acc, vec x, vec y) { return vfmaq_f64(acc, x, y); }
+
+   static vec maximum(vec x, vec y) { return vmaxq_f64(x, y); }
+   static vec pow(vec x, vec y) { return Sleef_powd2_u10(x, y); }
+
+   static vec sqrt(vec x) { return vsqrtq_f64(x); }
+   static vec log(vec x) { return Sleef_logd2_u10(x); }
+   static vec exp(vec x) { return Sleef_expd2_u10(x); }
+
+   static double horizontal_add(vec x) { return vaddvq_f64(x); }
+};
+#endif
+
 #endif // FUSION_CPU_NEON128_BACKEND_HPP
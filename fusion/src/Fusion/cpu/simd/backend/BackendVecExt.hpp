@@ -0,0 +1,42 @@
+#ifndef FUSION_CPU_VECEXT_BACKEND_HPP
+#define FUSION_CPU_VECEXT_BACKEND_HPP
+
+#include <cstddef>
+#include <cstring>
+
+// Fixed-width vectors on the GCC/Clang vector extension. The compiler lowers
+// them to whatever the target offers (SSE/AVX2/AVX-512, NEON), so kernels
+// that only need loads, stores, broadcasts and multiply-adds (BackendFma)
+// get real SIMD on targets without a hand-written intrinsic backend.
+template <typename T, std::size_t Bytes> struct VecExt {
+   using U = T;
+   typedef T vec __attribute__((vector_size(Bytes)));
+
+   static constexpr std::size_t kVectorBytes = Bytes;
+   static constexpr std::size_t kLanes = Bytes / sizeof(U);
+
+   // Unaligned; memcpy folds into a single vector load/store.
+   static vec load(const U *x) {
+      vec v;
+      std::memcpy(&v, x, sizeof(vec));
+      return v;
+   }
+   static void store(U *dst, vec x) { std::memcpy(dst, &x, sizeof(vec)); }
+
+   static vec duplicate(U x) { return vec{} + x; }
+
+   // acc + x * y; contracted to an FMA where the target has one and
+   // floating-point contraction is enabled.
+   static vec fma(vec acc, vec x, vec y) { return acc + x * y; }
+};
+
+// Widest vector the compilation target supports natively.
+#if defined(__AVX512F__)
+inline constexpr std::size_t kNativeVectorBytes = 64;
+#elif defined(__AVX__)
+inline constexpr std::size_t kNativeVectorBytes = 32;
+#else
+inline constexpr std::size_t kNativeVectorBytes = 16;
+#endif
+
+#endif // FUSION_CPU_VECEXT_BACKEND_HPP
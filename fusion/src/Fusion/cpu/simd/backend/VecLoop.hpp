@@ -202,6 +202,57 @@ void reduce_contiguous_apply(T *__restrict dst, const T *__restrict a,
    *dst = result;
 };
 
+// dst[j] = op(dst[j], a[i * row_stride + j]) over all rows i, for j < cols.
+// Column panels of kColumnBlock keep the running dst slice in L1 for tall
+// inputs; kRowBlock rows are combined in registers before each dst update.
+template <typename T, BackendConcept Backend, class BinaryVecOp,
+          class BinaryScalarOp>
+void column_reduce_apply(T *__restrict dst, const T *__restrict a,
+                         std::size_t rows, std::size_t cols,
+                         std::size_t row_stride, BinaryVecOp vec_op,
+                         BinaryScalarOp scalar_op) {
+
+   using B = Backend;
+   using vec = typename B::vec;
+
+   constexpr std::size_t kStep = B::kStep;
+   constexpr std::size_t kColumnBlock = 512;
+   constexpr std::size_t kRowBlock = 4;
+
+   for (std::size_t j0 = 0; j0 < cols; j0 += kColumnBlock) {
+      const std::size_t w =
+          (cols - j0 < kColumnBlock) ? cols - j0 : kColumnBlock;
+      T *__restrict pd = dst + j0;
+
+      std::size_t i = 0;
+      for (; i + kRowBlock <= rows; i += kRowBlock) {
+         const T *__restrict r0 = a + i * row_stride + j0;
+         const T *__restrict r1 = r0 + row_stride;
+         const T *__restrict r2 = r1 + row_stride;
+         const T *__restrict r3 = r2 + row_stride;
+
+         std::size_t j = 0;
+         for (; j + kStep <= w; j += kStep) {
+            vec v01 = vec_op(B::load(r0 + j), B::load(r1 + j));
+            vec v23 = vec_op(B::load(r2 + j), B::load(r3 + j));
+            B::store(pd + j, vec_op(B::load(pd + j), vec_op(v01, v23)));
+         }
+         for (; j < w; ++j)
+            pd[j] = scalar_op(pd[j], scalar_op(scalar_op(r0[j], r1[j]),
+                                               scalar_op(r2[j], r3[j])));
+      }
+
+      for (; i < rows; ++i) {
+         const T *__restrict r = a + i * row_stride + j0;
+         std::size_t j = 0;
+         for (; j + kStep <= w; j += kStep)
+            B::store(pd + j, vec_op(B::load(pd + j), B::load(r + j)));
+         for (; j < w; ++j)
+            pd[j] = scalar_op(pd[j], r[j]);
+      }
+   }
+};
+
 } // namespace detail
 
 } // namespace simd
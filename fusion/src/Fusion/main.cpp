@@ -47,7 +47,8 @@ int main() {
    std::cout << "plan num operands: " << plan_in.num_operands << std::endl;
    std::cout << "plan out_ndim: " << plan_in.out_ndim << std::endl;
    std::cout << "plan out shape: " << shape_str(plan_in.out_shape) << std::endl;
-   std::cout << "plan reduction_axis: " << plan_in.reduction_axis << std::endl;
+   std::cout << "plan reduction_axes: " << shape_str(plan_in.reduction_axes)
+             << std::endl;
    std::cout << "---------------\n";
 
    for (auto p : plan_in.loop) {
@@ -1,6 +1,7 @@
 #ifndef OPS_COMPARISON_HPP
 #define OPS_COMPARISON_HPP
 
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -39,6 +40,40 @@ inline RawTensor<T> maximum(const RawTensor<T> &x, const RawTensor<T> &y) {
    return out;
 }
 
+// out= variants; see binary_into in Ewise.hpp for the aliasing rules.
+
+template <typename T, class Tag>
+inline RawTensor<T> &compare_into(const RawTensor<T> &x, const RawTensor<T> &y,
+                                  RawTensor<T> &out, const std::string &op) {
+   BinaryEwiseMeta meta = make_binary_meta(x, y);
+   FUSION_CHECK(x.dtype() == y.dtype(), "dtypes do not match!");
+   FUSION_CHECK(x.device() == y.device(), "devices do not match!");
+   check_out(out, x, meta.out_shape, op);
+   check_ewise_alias(out, x, op);
+   check_ewise_alias(out, y, op);
+   fusion::iter::binary_ewise_tag<T, Tag>(x, y, meta, out);
+   out.bump_version();
+   return out;
+}
+
+template <typename T>
+inline RawTensor<T> &greater(const RawTensor<T> &x, const RawTensor<T> &y,
+                             RawTensor<T> &out) {
+   return compare_into<T, GreaterThanSIMD>(x, y, out, "greater");
+}
+
+template <typename T>
+inline RawTensor<T> &greater_equal(const RawTensor<T> &x,
+                                   const RawTensor<T> &y, RawTensor<T> &out) {
+   return compare_into<T, GreaterThanEqualSIMD>(x, y, out, "greater_equal");
+}
+
+template <typename T>
+inline RawTensor<T> &maximum(const RawTensor<T> &x, const RawTensor<T> &y,
+                             RawTensor<T> &out) {
+   return compare_into<T, MaximumSIMD>(x, y, out, "maximum");
+}
+
 } // namespace math
 
 } // namespace fusion
@@ -0,0 +1,346 @@
+#ifndef OPS_EINSUM_HPP
+#define OPS_EINSUM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Fusion/common/Checks.hpp"
+
+#include "Fusion/core/PlanMeta.hpp"
+#include "Fusion/core/RawTensor.hpp"
+#include "Fusion/core/TensorIter.hpp"
+
+#include "Helpers.hpp"
+#include "Linalg.hpp"
+#include "Reduce.hpp"
+
+// Two-operand einsum, "bij,bjk->bik". Contractions whose operands already
+// sit in a GEMM layout go straight to contraction_tag (BLAS, level-1/2 or
+// the small kernels). Anything else is rearranged into one, as TBLIS and
+// opt_einsum do: labels only one operand carries are summed out, each
+// operand is copied into [batch..., M..., K...] / [batch..., K..., N...]
+// order, one batched matmul runs, and the result is permuted into the
+// requested output order.
+
+namespace fusion {
+
+namespace math {
+
+namespace linalg {
+
+// Subscripts with one letter per axis; the output is explicit after "->"
+// or, numpy-style, every label used exactly once, in alphabetical order.
+struct EinsumSpec {
+   std::string a, b, out;
+
+   std::string str() const { return a + "," + b + "->" + out; }
+};
+
+inline EinsumSpec parse_einsum(std::string_view subscripts,
+                               const std::size_t a_rank,
+                               const std::size_t b_rank) {
+   std::string s;
+   for (char c : subscripts) {
+      if (c != ' ') {
+         s.push_back(c);
+      }
+   }
+   FUSION_CHECK(s.find("...") == std::string::npos,
+                "einsum: ellipsis is not supported");
+   const std::size_t arrow = s.find("->");
+   const std::string inputs = s.substr(0, arrow);
+   const std::size_t comma = inputs.find(',');
+   FUSION_CHECK(comma != std::string::npos &&
+                    inputs.find(',', comma + 1) == std::string::npos,
+                "einsum: expected two operands, got '" + inputs + "'");
+
+   EinsumSpec spec;
+   spec.a = inputs.substr(0, comma);
+   spec.b = inputs.substr(comma + 1);
+   auto is_label = [](char c) {
+      return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+   };
+   auto check_labels = [&](const std::string &l, const char *what) {
+      for (std::size_t i = 0; i < l.size(); ++i) {
+         FUSION_CHECK(is_label(l[i]), std::string("einsum: bad label in ") +
+                                          what + " '" + l + "'");
+         FUSION_CHECK(l.find(l[i], i + 1) == std::string::npos,
+                      std::string("einsum: repeated label in ") + what +
+                          " '" + l + "' (diagonals are not supported)");
+      }
+   };
+   check_labels(spec.a, "first operand");
+   check_labels(spec.b, "second operand");
+
+   if (arrow != std::string::npos) {
+      spec.out = s.substr(arrow + 2);
+   } else {
+      for (char c : spec.a + spec.b) {
+         const bool once = (spec.a + spec.b).find(c) ==
+                           (spec.a + spec.b).rfind(c);
+         if (once) {
+            spec.out.push_back(c);
+         }
+      }
+      std::sort(spec.out.begin(), spec.out.end());
+   }
+   check_labels(spec.out, "output");
+   for (char c : spec.out) {
+      FUSION_CHECK(spec.a.find(c) != std::string::npos ||
+                       spec.b.find(c) != std::string::npos,
+                   std::string("einsum: output label '") + c +
+                       "' is in neither operand");
+   }
+
+   FUSION_CHECK(spec.a.size() == a_rank,
+                "einsum: first operand has rank " + std::to_string(a_rank) +
+                    " but subscripts '" + spec.a + "'");
+   FUSION_CHECK(spec.b.size() == b_rank,
+                "einsum: second operand has rank " + std::to_string(b_rank) +
+                    " but subscripts '" + spec.b + "'");
+   return spec;
+}
+
+inline EinsumBinding make_einsum_binding(const EinsumSpec &spec) {
+   auto labels = [](const std::string &s) {
+      return std::vector<Label>(s.begin(), s.end());
+   };
+   EinsumBinding binding;
+   // {out, A, B}, as make_contraction_plan_einsum_out expects.
+   binding.op_axis_labels = {labels(spec.out), labels(spec.a),
+                             labels(spec.b)};
+   binding.out_labels = labels(spec.out);
+   return binding;
+}
+
+// out[i...] = x[perm[i]...]: a strided gather into a new contiguous tensor.
+template <typename T>
+inline RawTensor<T> permuted_copy(const RawTensor<T> &x,
+                                  const std::vector<std::size_t> &perm) {
+   const std::vector<std::size_t> in_shape = x.shape();
+   const std::vector<std::int64_t> in_strides = x.strides();
+   const std::size_t nd = perm.size();
+   std::vector<std::size_t> shape(nd);
+   std::vector<std::int64_t> stride(nd);
+   for (std::size_t d = 0; d < nd; ++d) {
+      shape[d] = in_shape[perm[d]];
+      stride[d] = in_strides[perm[d]];
+   }
+   RawTensor<T> out(shape.empty() ? std::vector<std::size_t>{1} : shape,
+                    x.dtype(), x.device());
+   const T *src = x.get_ptr();
+   T *dst = out.get_ptr();
+   if (nd == 0) {
+      *dst = *src;
+      return out;
+   }
+
+   const std::size_t inner = shape[nd - 1];
+   const std::int64_t inner_stride = stride[nd - 1];
+   const std::size_t rows = out.flat_size() / std::max<std::size_t>(inner, 1);
+   std::vector<std::size_t> idx(nd, 0);
+   std::int64_t off = 0;
+   for (std::size_t r = 0; r < rows; ++r) {
+      for (std::size_t i = 0; i < inner; ++i) {
+         dst[i] = src[off + static_cast<std::int64_t>(i) * inner_stride];
+      }
+      dst += inner;
+      // Odometer over every axis but the innermost.
+      for (std::size_t d = nd - 1; d-- > 0;) {
+         off += stride[d];
+         if (++idx[d] < shape[d]) {
+            break;
+         }
+         off -= stride[d] * static_cast<std::int64_t>(shape[d]);
+         idx[d] = 0;
+      }
+   }
+   return out;
+}
+
+namespace detail {
+
+inline bool has_label(const std::string &s, char c) {
+   return s.find(c) != std::string::npos;
+}
+
+inline std::size_t product(const std::vector<std::size_t> &v) {
+   return std::accumulate(v.begin(), v.end(), std::size_t{1},
+                          std::multiplies<>());
+}
+
+// x with its labels reordered to `order`, contiguous.
+template <typename T>
+RawTensor<T> arrange(const RawTensor<T> &x, const std::string &labels,
+                     const std::string &order) {
+   std::vector<std::size_t> perm;
+   bool identity = true;
+   for (std::size_t d = 0; d < order.size(); ++d) {
+      perm.push_back(labels.find(order[d]));
+      identity = identity && perm.back() == d;
+   }
+   if (identity && x.is_contiguous()) {
+      return x;
+   }
+   return permuted_copy(x, perm);
+}
+
+// Sums x over the axes whose label keep() rejects and drops those labels.
+template <typename T, class Keep>
+RawTensor<T> sum_out_labels(const RawTensor<T> &x, std::string &labels,
+                            Keep &&keep) {
+   std::vector<std::size_t> axes;
+   std::vector<std::size_t> kept_shape;
+   std::string kept;
+   const std::vector<std::size_t> shape = x.shape();
+   for (std::size_t d = 0; d < labels.size(); ++d) {
+      if (keep(labels[d])) {
+         kept.push_back(labels[d]);
+         kept_shape.push_back(shape[d]);
+      } else {
+         axes.push_back(d);
+      }
+   }
+   if (axes.empty()) {
+      return x;
+   }
+   const RawTensor<T> src = arrange(x, labels, labels);
+   labels = kept;
+   if (kept_shape.empty()) {
+      kept_shape.push_back(1);
+   }
+   return src.sum(axes, true).reshape(kept_shape);
+}
+
+} // namespace detail
+
+// The general engine: any two-operand einsum as one batched matmul.
+template <typename T>
+RawTensor<T> einsum_via_gemm(EinsumSpec spec, const RawTensor<T> &A,
+                             const RawTensor<T> &B) {
+   using detail::has_label;
+
+   // Labels only one operand carries are summed out up front.
+   RawTensor<T> a = detail::sum_out_labels(A, spec.a, [&](char c) {
+      return has_label(spec.b, c) || has_label(spec.out, c);
+   });
+   RawTensor<T> b = detail::sum_out_labels(B, spec.b, [&](char c) {
+      return has_label(spec.a, c) || has_label(spec.out, c);
+   });
+
+   auto extent = [](const RawTensor<T> &x, const std::string &l, char c) {
+      return x.shape()[l.find(c)];
+   };
+
+   // A contracted label broadcast in one operand (extent 1) factors out of
+   // the sum: reduce the other operand over it first.
+   for (char c : std::string(spec.a)) {
+      if (!has_label(spec.b, c) || has_label(spec.out, c)) {
+         continue;
+      }
+      const std::size_t ea = extent(a, spec.a, c);
+      const std::size_t eb = extent(b, spec.b, c);
+      if (ea == eb) {
+         continue;
+      }
+      FUSION_CHECK(ea == 1 || eb == 1, std::string("einsum: label '") + c +
+                                           "' has mismatched extents");
+      RawTensor<T> &x = (ea == 1) ? b : a;
+      const std::string &l = (ea == 1) ? spec.b : spec.a;
+      const std::size_t axis = l.find(c);
+      x = detail::arrange(x, l, l).sum(std::vector<std::size_t>{axis}, true);
+   }
+
+   // Batch labels in output order, then the output's M and N labels; K in
+   // the first operand's order.
+   std::string batch, m, n, k;
+   for (char c : spec.out) {
+      const bool in_a = has_label(spec.a, c);
+      const bool in_b = has_label(spec.b, c);
+      if (in_a && in_b) {
+         batch.push_back(c);
+      } else if (in_a) {
+         m.push_back(c);
+      } else {
+         n.push_back(c);
+      }
+   }
+   for (char c : spec.a) {
+      if (has_label(spec.b, c) && !has_label(spec.out, c)) {
+         k.push_back(c);
+      }
+   }
+
+   const std::string a_order = batch + m + k;
+   const std::string b_order = batch + k + n;
+   a = detail::arrange(a, spec.a, a_order);
+   b = detail::arrange(b, spec.b, b_order);
+
+   // Batch extents stay per operand so matmul broadcasts them.
+   std::vector<std::size_t> a_shape, b_shape, r_shape;
+   std::vector<std::size_t> m_ext, n_ext, k_ext;
+   for (char c : batch) {
+      a_shape.push_back(extent(a, a_order, c));
+      b_shape.push_back(extent(b, b_order, c));
+      r_shape.push_back(std::max(a_shape.back(), b_shape.back()));
+   }
+   for (char c : m) {
+      m_ext.push_back(extent(a, a_order, c));
+   }
+   for (char c : k) {
+      k_ext.push_back(extent(a, a_order, c));
+   }
+   for (char c : n) {
+      n_ext.push_back(extent(b, b_order, c));
+   }
+   const std::size_t M = detail::product(m_ext);
+   const std::size_t N = detail::product(n_ext);
+   const std::size_t K = detail::product(k_ext);
+   a_shape.insert(a_shape.end(), {M, K});
+   b_shape.insert(b_shape.end(), {K, N});
+
+   RawTensor<T> r = a.reshape(a_shape).matmul(b.reshape(b_shape));
+
+   // [batch..., M, N] -> [batch..., m..., n...] -> output order.
+   r_shape.insert(r_shape.end(), m_ext.begin(), m_ext.end());
+   r_shape.insert(r_shape.end(), n_ext.begin(), n_ext.end());
+   if (r_shape.empty()) {
+      return r.reshape({1});
+   }
+   return detail::arrange(r.reshape(r_shape), batch + m + n, spec.out);
+}
+
+template <typename T>
+inline RawTensor<T> einsum(std::string_view subscripts, const RawTensor<T> &A,
+                           const RawTensor<T> &B) {
+   FUSION_CHECK(A.is_initialised(), "einsum: A uninitialised");
+   FUSION_CHECK(B.is_initialised(), "einsum: B uninitialised");
+   FUSION_CHECK(A.dtype() == B.dtype(), "einsum: dtype mismatch");
+   FUSION_CHECK(A.device() == B.device(), "einsum: device mismatch");
+
+   const EinsumSpec spec = parse_einsum(subscripts, A.rank(), B.rank());
+   if (!spec.out.empty()) {
+      const EinsumBinding binding = make_einsum_binding(spec);
+      ContractionMeta meta = make_contraction_meta_einsum<T>(A, B, binding);
+      if (meta.plan.gemm_like) {
+         RawTensor<T> out = init_out_from_meta(A, B, meta);
+         fusion::iter::contraction_tag<T, BatchedGemmBLAS, MultiplySIMD>(
+             A, B, meta, out);
+         return out;
+      }
+   }
+   return einsum_via_gemm(spec, A, B);
+}
+
+} // namespace linalg
+
+} // namespace math
+
+} // namespace fusion
+
+#endif // OPS_EINSUM_HPP
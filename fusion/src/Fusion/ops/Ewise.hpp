@@ -1,6 +1,7 @@
 #ifndef EWISE_HPP
 #define EWISE_HPP
 
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -54,7 +55,7 @@ inline RawTensor<T> pow(const RawTensor<T> &x, const RawTensor<T> &y) {
    return out;
 }
 
-std::string shape_str(std::vector<size_t> shape) {
+inline std::string shape_str(std::vector<size_t> shape) {
    std::ostringstream oss;
    oss << '(';
    for (size_t i = 0; i < shape.size(); ++i) {
@@ -66,20 +67,188 @@ std::string shape_str(std::vector<size_t> shape) {
    return oss.str();
 }
 
+// ---------- out= variants ----------
+// Write into a caller-provided tensor that already has the broadcast result
+// shape. out may be x or y itself when that operand is not broadcast.
+
+template <typename T, class Tag>
+inline RawTensor<T> &binary_into(const RawTensor<T> &x, const RawTensor<T> &y,
+                                 RawTensor<T> &out, const std::string &op) {
+   BinaryEwiseMeta meta = make_binary_meta(x, y);
+   FUSION_CHECK(x.dtype() == y.dtype(), "dtypes do not match!");
+   FUSION_CHECK(x.device() == y.device(), "devices do not match!");
+   check_out(out, x, meta.out_shape, op);
+   check_ewise_alias(out, x, op);
+   check_ewise_alias(out, y, op);
+   fusion::iter::binary_ewise_tag<T, Tag>(x, y, meta, out);
+   out.bump_version();
+   return out;
+}
+
+template <typename T>
+inline RawTensor<T> &add(const RawTensor<T> &x, const RawTensor<T> &y,
+                         RawTensor<T> &out) {
+   return binary_into<T, AddSIMD>(x, y, out, "add");
+}
+
+template <typename T>
+inline RawTensor<T> &sub(const RawTensor<T> &x, const RawTensor<T> &y,
+                         RawTensor<T> &out) {
+   return binary_into<T, SubtractSIMD>(x, y, out, "sub");
+}
+
+template <typename T>
+inline RawTensor<T> &mul(const RawTensor<T> &x, const RawTensor<T> &y,
+                         RawTensor<T> &out) {
+   return binary_into<T, MultiplySIMD>(x, y, out, "mul");
+}
+
+template <typename T>
+inline RawTensor<T> &div(const RawTensor<T> &x, const RawTensor<T> &y,
+                         RawTensor<T> &out) {
+   return binary_into<T, DivideSIMD>(x, y, out, "div");
+}
+
 template <typename T>
-inline void sub_inplace(RawTensor<T> &x, const RawTensor<T> &y) {
-   // TODO: need to impl_ a way to ignore batch dim in shape check in
-   // a sensible way
-   BinaryEwiseMeta meta{};
-   meta.fastpath = true;
-   meta.out_shape = x.shape();
-   meta.fast_len = x.flat_size();
-   // this impl is unstable for > rank(2) NDtensors
-   FUSION_CHECK(meta.out_shape[x.rank() - 1] == x.shape()[x.rank() - 1],
-                "sub_inplace would change tensor shape; "
-                "use out-of-place sub() instead.");
+inline RawTensor<T> &pow(const RawTensor<T> &x, const RawTensor<T> &y,
+                         RawTensor<T> &out) {
+   return binary_into<T, PowerSIMD>(x, y, out, "pow");
+}
+
+// ---------- buffer donation ----------
+// Rvalue operators pass the operands that are about to die as donors. The
+// first donor that is uniquely owned and already has the result's shape
+// receives the result, so a chain like (a + b) * c allocates only once.
 
-   fusion::iter::binary_ewise_tag<T, SubtractSIMD>(x, y, meta, x);
+template <typename T, class Tag>
+inline RawTensor<T> binary_donating(const RawTensor<T> &x,
+                                    const RawTensor<T> &y,
+                                    RawTensor<T> *donor_x,
+                                    RawTensor<T> *donor_y) {
+   BinaryEwiseMeta meta = make_binary_meta(x, y);
+   FUSION_CHECK(x.dtype() == y.dtype(), "dtypes do not match!");
+   FUSION_CHECK(x.device() == y.device(), "devices do not match!");
+   for (RawTensor<T> *donor : {donor_x, donor_y}) {
+      if (can_donate(donor, meta.out_shape)) {
+         fusion::iter::binary_ewise_tag<T, Tag>(x, y, meta, *donor);
+         return std::move(*donor);
+      }
+   }
+   RawTensor<T> out = init_out_from_meta(x, y, meta);
+   fusion::iter::binary_ewise_tag<T, Tag>(x, y, meta, out);
+   return out;
+}
+
+// ---------- in-place ----------
+// x = x op y with y broadcast to x. The destination never changes shape, so
+// y must broadcast *to* x (e.g. a [F] bias into a [B, F] activation).
+
+template <typename T, class Tag>
+inline RawTensor<T> &binary_inplace(RawTensor<T> &x, const RawTensor<T> &y,
+                                    const std::string &op) {
+   BinaryEwiseMeta meta = make_binary_meta(x, y);
+   FUSION_CHECK(meta.out_shape == x.shape(),
+                op + ": cannot broadcast into destination of shape " +
+                    x.shape_str() + " (source " + y.shape_str() + ")");
+   check_out(x, y, meta.out_shape, op);
+   check_ewise_alias(x, y, op);
+   fusion::iter::binary_ewise_tag<T, Tag>(x, y, meta, x);
+   x.bump_version();
+   return x;
+}
+
+// x = x op s without materialising s as a tensor.
+template <typename T, class Tag>
+inline RawTensor<T> &scalar_inplace(RawTensor<T> &x, const T s) {
+   FUSION_CHECK(x.is_contiguous(), "in-place scalar op on strided tensor");
+   T *p = x.get_ptr();
+   simd_traits<Tag, T>::execute_contiguous(p, &s, p, x.flat_size(), false,
+                                           true);
+   x.bump_version();
+   return x;
+}
+
+template <typename T>
+inline RawTensor<T> &add_(RawTensor<T> &x, const RawTensor<T> &y) {
+   return binary_inplace<T, AddSIMD>(x, y, "add_");
+}
+
+template <typename T>
+inline RawTensor<T> &sub_(RawTensor<T> &x, const RawTensor<T> &y) {
+   return binary_inplace<T, SubtractSIMD>(x, y, "sub_");
+}
+
+template <typename T>
+inline RawTensor<T> &mul_(RawTensor<T> &x, const RawTensor<T> &y) {
+   return binary_inplace<T, MultiplySIMD>(x, y, "mul_");
+}
+
+template <typename T>
+inline RawTensor<T> &div_(RawTensor<T> &x, const RawTensor<T> &y) {
+   return binary_inplace<T, DivideSIMD>(x, y, "div_");
+}
+
+template <typename T> inline RawTensor<T> &add_(RawTensor<T> &x, const T s) {
+   return scalar_inplace<T, AddSIMD>(x, s);
+}
+
+template <typename T> inline RawTensor<T> &sub_(RawTensor<T> &x, const T s) {
+   return scalar_inplace<T, SubtractSIMD>(x, s);
+}
+
+template <typename T> inline RawTensor<T> &mul_(RawTensor<T> &x, const T s) {
+   return scalar_inplace<T, MultiplySIMD>(x, s);
+}
+
+template <typename T> inline RawTensor<T> &div_(RawTensor<T> &x, const T s) {
+   return scalar_inplace<T, DivideSIMD>(x, s);
+}
+
+// x += value * t1 (op) t2, op being * (addcmul_) or / (addcdiv_). When t1 and
+// t2 match x element for element this is one fused pass with no temporary;
+// otherwise t1 op t2 is broadcast into a temporary first.
+template <typename T, class Tag>
+inline RawTensor<T> &addc_inplace(RawTensor<T> &x, const RawTensor<T> &t1,
+                                  const RawTensor<T> &t2, const T value,
+                                  const std::string &op) {
+   check_ewise_alias(x, t1, op);
+   check_ewise_alias(x, t2, op);
+   const bool same = t1.shape() == x.shape() && t2.shape() == x.shape() &&
+                     x.is_contiguous() && t1.is_contiguous() &&
+                     t2.is_contiguous();
+   if (!same) {
+      BinaryEwiseMeta meta = make_binary_meta(t1, t2);
+      RawTensor<T> tmp = init_out_from_meta(t1, t2, meta);
+      fusion::iter::binary_ewise_tag<T, Tag>(t1, t2, meta, tmp);
+      if (value != T(1)) {
+         scalar_inplace<T, MultiplySIMD>(tmp, value);
+      }
+      return binary_inplace<T, AddSIMD>(x, tmp, op);
+   }
+   check_out(x, t1, t1.shape(), op);
+   FUSION_CHECK(t1.dtype() == t2.dtype(), op + ": dtype mismatch");
+   T *px = x.get_ptr();
+   const T *p1 = t1.get_ptr();
+   const T *p2 = t2.get_ptr();
+   const std::size_t n = x.flat_size();
+   Tag tag{};
+   for (std::size_t i = 0; i < n; ++i) {
+      px[i] += value * tag(p1[i], p2[i]);
+   }
+   x.bump_version();
+   return x;
+}
+
+template <typename T>
+inline RawTensor<T> &addcmul_(RawTensor<T> &x, const RawTensor<T> &t1,
+                              const RawTensor<T> &t2, const T value = T(1)) {
+   return addc_inplace<T, MultiplySIMD>(x, t1, t2, value, "addcmul_");
+}
+
+template <typename T>
+inline RawTensor<T> &addcdiv_(RawTensor<T> &x, const RawTensor<T> &t1,
+                              const RawTensor<T> &t2, const T value = T(1)) {
+   return addc_inplace<T, DivideSIMD>(x, t1, t2, value, "addcdiv_");
 }
 
 } // namespace math
@@ -2,6 +2,8 @@
 #define OP_HELPERS_HPP
 
 #include <cassert>
+#include <string>
+#include <vector>
 
 #include "Fusion/Tensor.h"
 #include "Fusion/core/PlanMeta.hpp"
@@ -36,4 +38,60 @@ inline RawTensor<T> init_out_from_meta(const RawTensor<T> &x,
    return RawTensor<T>(m.out_shape, x.dtype(), x.device());
 }
 
+// True when the buffers of a and b overlap.
+template <typename T>
+inline bool may_alias(const RawTensor<T> &a, const RawTensor<T> &b) {
+   if (!a.is_initialised() || !b.is_initialised()) {
+      return false;
+   }
+   return a.begin() < b.end() && b.begin() < a.end();
+}
+
+// Validates a caller-provided output: it must already have the result's
+// shape, dtype and device, and be contiguous. Outputs are never resized.
+template <typename T>
+inline void check_out(const RawTensor<T> &out, const RawTensor<T> &like,
+                      const std::vector<std::size_t> &shape,
+                      const std::string &op) {
+   FUSION_CHECK(out.is_initialised(), op + ": out is uninitialised");
+   FUSION_CHECK(out.shape() == shape,
+                op + ": out has shape " + out.shape_str() +
+                    " but the result shape differs");
+   FUSION_CHECK(out.dtype() == like.dtype(), op + ": out dtype mismatch");
+   FUSION_CHECK(out.device() == like.device(), op + ": out device mismatch");
+   FUSION_CHECK(out.is_contiguous(), op + ": out must be contiguous");
+}
+
+// Elementwise kernels read and write each index once, so out may be an input
+// with the identical layout (pointer, shape and strides), but not overlap an
+// input broadcast into it or a strided/transposed view of it.
+template <typename T>
+inline void check_ewise_alias(const RawTensor<T> &out, const RawTensor<T> &in,
+                              const std::string &op) {
+   if (may_alias(out, in)) {
+      FUSION_CHECK(in.get_ptr() == out.get_ptr() &&
+                       in.shape() == out.shape() &&
+                       in.strides() == out.strides(),
+                   op + ": out overlaps an input it does not match "
+                        "element for element");
+   }
+}
+
+// Reductions and contractions read an input element after writing outputs,
+// so out must not overlap any input.
+template <typename T>
+inline void check_no_alias(const RawTensor<T> &out, const RawTensor<T> &in,
+                           const std::string &op) {
+   FUSION_CHECK(!may_alias(out, in), op + ": out overlaps an input");
+}
+
+// True when donor may receive a result of `shape` in place: nothing else
+// references its buffer and its layout already matches.
+template <typename T>
+inline bool can_donate(const RawTensor<T> *donor,
+                       const std::vector<std::size_t> &shape) {
+   return donor != nullptr && donor->is_uniquely_owned() &&
+          donor->is_contiguous() && donor->shape() == shape;
+}
+
 #endif // OP_HELPERS_HPP
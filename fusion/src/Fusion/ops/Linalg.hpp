@@ -1,6 +1,10 @@
 #ifndef OPS_LINALG_HPP
 #define OPS_LINALG_HPP
 
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -9,8 +13,11 @@
 #include "Fusion/core/PlanMeta.hpp"
 #include "Fusion/core/RawTensor.hpp"
 #include "Fusion/core/TensorIter.hpp"
+#include "Fusion/cpu/blas/GemmEpilogue.hpp"
+#include "Fusion/cpu/blas/SmallGemm.hpp"
 
 #include "Helpers.hpp"
+#include "OpParams.hpp"
 
 namespace fusion {
 
@@ -24,17 +31,13 @@ inline EinsumBinding make_matmul_binding(std::size_t a_nd, std::size_t b_nd) {
       throw std::runtime_error("matmul: expected rank >= 2 for both operands");
    }
 
-   // For now require same batch rank. If you want broadcast batch ranks
-   // you can pad the smaller with leading singleton axes in desc building,
-   // or construct labels with left-padding logic.
+   // Batch axes broadcast numpy-style: right-aligned, a missing or extent-1
+   // axis repeats the other operand's. The planner turns the repeat into a
+   // stride-0 batch or, when the layout allows, folds it into the rows of
+   // one tall GEMM; the broadcast operand is never expanded.
    const std::size_t batch_nd_a = a_nd - 2;
    const std::size_t batch_nd_b = b_nd - 2;
-   if (batch_nd_a != batch_nd_b) {
-      throw std::runtime_error(
-          "matmul: batch rank mismatch (implement broadcasting/padding)");
-   }
-
-   const std::size_t batch_nd = batch_nd_a;
+   const std::size_t batch_nd = std::max(batch_nd_a, batch_nd_b);
 
    // Label assignment:
    // batch dims: 0..batch_nd-1
@@ -51,12 +54,16 @@ inline EinsumBinding make_matmul_binding(std::size_t a_nd, std::size_t b_nd) {
       batch_labels[t] = static_cast<Label>(base + t);
 
    // A labels: [batch..., i, k]
-   std::vector<Label> a_labels = batch_labels;
+   const auto a_skip = static_cast<std::ptrdiff_t>(batch_nd - batch_nd_a);
+   std::vector<Label> a_labels(batch_labels.begin() + a_skip,
+                               batch_labels.end());
    a_labels.push_back(Li);
    a_labels.push_back(Lk);
 
    // B labels: [batch..., k, j]
-   std::vector<Label> b_labels = batch_labels;
+   const auto b_skip = static_cast<std::ptrdiff_t>(batch_nd - batch_nd_b);
+   std::vector<Label> b_labels(batch_labels.begin() + b_skip,
+                               batch_labels.end());
    b_labels.push_back(Lk);
    b_labels.push_back(Lj);
 
@@ -90,6 +97,20 @@ inline RawTensor<T> matmul(const RawTensor<T> &A, const RawTensor<T> &B) {
    if (kA != kB)
       throw std::runtime_error("matmul: inner dimension mismatch");
 
+   // Small 2-D products: planning would cost more than the product itself.
+   if (a_shape.size() == 2 && b_shape.size() == 2 && A.is_contiguous() &&
+       B.is_contiguous() &&
+       fusion::blas::small::fits(false, false, a_shape[0], b_shape[1], kA)) {
+      const std::size_t m = a_shape[0];
+      const std::size_t n = b_shape[1];
+      RawTensor<T> out({m, n}, A.dtype(), A.device());
+      fusion::blas::small::gemm<T>(
+          false, false, m, n, kA, A.get_ptr(), static_cast<std::int64_t>(kA),
+          B.get_ptr(), static_cast<std::int64_t>(n), out.get_ptr(),
+          static_cast<std::int64_t>(n));
+      return out;
+   }
+
    EinsumBinding binding = make_matmul_binding(a_shape.size(), b_shape.size());
    ContractionMeta meta = make_contraction_meta_einsum<T>(A, B, binding);
 
@@ -106,6 +127,179 @@ inline RawTensor<T> matmul(const RawTensor<T> &A, const RawTensor<T> &B) {
    return out;
 }
 
+// out= variant. out must already have the product's shape and must not
+// overlap A or B.
+template <typename T>
+inline RawTensor<T> &matmul(const RawTensor<T> &A, const RawTensor<T> &B,
+                            RawTensor<T> &out) {
+   FUSION_CHECK(A.is_initialised(), "matmul: A uninitialised");
+   FUSION_CHECK(B.is_initialised(), "matmul: B uninitialised");
+   FUSION_CHECK(A.dtype() == B.dtype(), "matmul: dtype mismatch");
+   FUSION_CHECK(A.device() == B.device(), "matmul: device mismatch");
+
+   const auto &a_shape = A.shape();
+   const auto &b_shape = B.shape();
+   if (a_shape.size() < 2 || b_shape.size() < 2)
+      throw std::runtime_error("matmul: expected rank >= 2");
+   if (a_shape[a_shape.size() - 1] != b_shape[b_shape.size() - 2])
+      throw std::runtime_error("matmul: inner dimension mismatch");
+
+   EinsumBinding binding = make_matmul_binding(a_shape.size(), b_shape.size());
+   ContractionMeta meta = make_contraction_meta_einsum<T>(A, B, binding);
+   check_out(out, A, meta.out_shape, "matmul");
+   check_no_alias(out, A, "matmul");
+   check_no_alias(out, B, "matmul");
+   fusion::iter::contraction_tag<T, BatchedGemmBLAS, MultiplySIMD>(A, B, meta,
+                                                                  out);
+   out.bump_version();
+   return out;
+}
+
+// out += A @ B, summed by the GEMM itself (beta = 1) with no temporary for
+// the product. out must already have the product's shape and must not
+// overlap A or B.
+template <typename T>
+inline RawTensor<T> &addmm_(RawTensor<T> &out, const RawTensor<T> &A,
+                            const RawTensor<T> &B) {
+   FUSION_CHECK(A.is_initialised(), "addmm_: A uninitialised");
+   FUSION_CHECK(B.is_initialised(), "addmm_: B uninitialised");
+   FUSION_CHECK(A.dtype() == B.dtype(), "addmm_: dtype mismatch");
+   FUSION_CHECK(A.device() == B.device(), "addmm_: device mismatch");
+
+   const auto &a_shape = A.shape();
+   const auto &b_shape = B.shape();
+   if (a_shape.size() < 2 || b_shape.size() < 2)
+      throw std::runtime_error("addmm_: expected rank >= 2");
+   if (a_shape[a_shape.size() - 1] != b_shape[b_shape.size() - 2])
+      throw std::runtime_error("addmm_: inner dimension mismatch");
+
+   EinsumBinding binding = make_matmul_binding(a_shape.size(), b_shape.size());
+   ContractionMeta meta = make_contraction_meta_einsum<T>(A, B, binding);
+   check_out(out, A, meta.out_shape, "addmm_");
+   check_no_alias(out, A, "addmm_");
+   check_no_alias(out, B, "addmm_");
+   fusion::iter::contraction_tag<T, BatchedGemmBLAS, MultiplySIMD>(A, B, meta,
+                                                                  out, true);
+   out.bump_version();
+   return out;
+}
+
+namespace detail {
+
+// A 2-D operand as GEMM takes it: transposed or not, and its leading
+// dimension. One of its strides must be 1.
+struct GemmOperand {
+   bool transpose;
+   int ld;
+};
+
+template <typename T>
+inline GemmOperand gemm_operand(const RawTensor<T> &x, const char *what) {
+   const auto &shape = x.shape();
+   const auto &strides = x.strides();
+   const auto rows = static_cast<std::int64_t>(shape[0]);
+   const auto cols = static_cast<std::int64_t>(shape[1]);
+   if (strides[1] == 1 && strides[0] >= cols) {
+      return {false, static_cast<int>(std::max<std::int64_t>(strides[0], 1))};
+   }
+   if (strides[0] == 1 && strides[1] >= rows) {
+      return {true, static_cast<int>(std::max<std::int64_t>(strides[1], 1))};
+   }
+   throw std::runtime_error(std::string(what) +
+                            ": operand has no unit stride");
+}
+
+} // namespace detail
+
+// y = act(x W^T + b): x [..., in], W [units, in] (the Linear layer's kernel
+// layout, read as a transposed operand, not copied), b [units] or null. The
+// bias and activation run in the GEMM epilogue while each block of y is in
+// cache, not as separate passes. pre, when given, receives x W^T + b, which
+// the GELU gradient needs.
+template <typename T>
+inline RawTensor<T> linear(const RawTensor<T> &x, const RawTensor<T> &W,
+                           const RawTensor<T> *b, const Activation act,
+                           RawTensor<T> *pre = nullptr) {
+   FUSION_CHECK(x.is_initialised(), "linear: x uninitialised");
+   FUSION_CHECK(W.is_initialised(), "linear: W uninitialised");
+   FUSION_CHECK(x.dtype() == W.dtype(), "linear: dtype mismatch");
+   FUSION_CHECK(x.device() == W.device(), "linear: device mismatch");
+   FUSION_CHECK(W.rank() == 2, "linear: W must be [units, in]");
+   FUSION_CHECK(x.rank() >= 1, "linear: x must have rank >= 1");
+
+   const std::size_t units = W.shape()[0];
+   const std::size_t in = W.shape()[1];
+   FUSION_CHECK(x.shape().back() == in,
+                "linear: x's last axis does not match W");
+   if (b != nullptr) {
+      FUSION_CHECK(b->is_initialised() && b->is_contiguous() &&
+                       b->flat_size() == units,
+                   "linear: b must hold one value per unit");
+   }
+
+   // Leading axes of x fold into the GEMM rows.
+   const std::size_t rows = x.flat_size() / std::max<std::size_t>(in, 1);
+   detail::GemmOperand xa{false, static_cast<int>(in)};
+   if (x.rank() == 2) {
+      xa = detail::gemm_operand(x, "linear");
+   } else {
+      FUSION_CHECK(x.is_contiguous(), "linear: x is not contiguous");
+   }
+   const detail::GemmOperand wb = detail::gemm_operand(W, "linear");
+
+   std::vector<std::size_t> out_shape = x.shape();
+   out_shape.back() = units;
+   RawTensor<T> out(out_shape, x.dtype(), x.device());
+   if (pre != nullptr) {
+      *pre = RawTensor<T>(out_shape, x.dtype(), x.device());
+   }
+
+   // y = x W^T: W is op(B) transposed unless it already is a view of W^T.
+   const fusion::blas::epilogue::BiasActivation<T> epi{
+       b != nullptr ? b->get_ptr() : nullptr, act,
+       pre != nullptr ? pre->get_ptr() : nullptr, units};
+   fusion::blas::epilogue::gemm<T>(
+       xa.transpose, !wb.transpose, static_cast<int>(rows),
+       static_cast<int>(units), static_cast<int>(in), x.get_ptr(), xa.ld,
+       W.get_ptr(), wb.ld, out.get_ptr(), static_cast<int>(units), epi);
+   return out;
+}
+
+template <typename T>
+inline RawTensor<T> linear(const RawTensor<T> &x, const RawTensor<T> &W,
+                           const RawTensor<T> &b,
+                           const Activation act = Activation::None) {
+   return linear(x, W, &b, act);
+}
+
+template <typename T>
+inline RawTensor<T> linear(const RawTensor<T> &x, const RawTensor<T> &W,
+                           const Activation act = Activation::None) {
+   return linear(x, W, static_cast<const RawTensor<T> *>(nullptr), act);
+}
+
+// Upstream gradient through the activation of linear(): g * act'(z) in one
+// pass, from the forward output y and, for GELU, the pre-activation z.
+template <typename T>
+inline RawTensor<T> activation_backward(const RawTensor<T> &g,
+                                        const RawTensor<T> &y,
+                                        const RawTensor<T> *pre,
+                                        const Activation act) {
+   if (act == Activation::None) {
+      return g;
+   }
+   FUSION_CHECK(g.shape() == y.shape() && g.is_contiguous(),
+                "activation_backward: gradient does not match the output");
+   FUSION_CHECK(!fusion::blas::epilogue::needs_pre_activation(act) ||
+                    pre != nullptr,
+                "activation_backward: pre-activation required");
+   RawTensor<T> dz(y.shape(), y.dtype(), y.device());
+   fusion::blas::epilogue::activation_backward<T>(
+       act, y.flat_size(), g.get_ptr(), y.get_ptr(),
+       pre != nullptr ? pre->get_ptr() : nullptr, dz.get_ptr());
+   return dz;
+}
+
 template <typename T>
 inline RawTensor<T> swapaxes(const RawTensor<T> &x, const int axis1,
                              const int axis2) {
@@ -2,15 +2,36 @@
 #define OP_PARAMS_HPP
 
 #include <cstddef>
+#include <string>
+#include <vector>
 
 struct SwapAxesParam {
    int axis1;
    int axis2;
 };
 
+// Empty reduction_axes reduces every axis.
 struct ReductionParam {
-   const std::size_t reduction_axis;
+   const std::vector<std::size_t> reduction_axes;
    const bool keepdim;
 };
 
+struct VarianceParam {
+   const std::vector<std::size_t> reduction_axes;
+   const bool keepdim;
+   const std::size_t correction;
+};
+
+// Activation fused into a GEMM epilogue.
+enum class Activation { None, ReLU, GELU, Tanh };
+
+struct LinearParam {
+   Activation activation;
+};
+
+// Two-operand einsum subscripts, "bij,bjk->bik".
+struct EinsumParam {
+   std::string subscripts;
+};
+
 #endif // OP_PARAMS_HPP
@@ -0,0 +1,241 @@
+#ifndef OPS_PACKED_WEIGHT_HPP
+#define OPS_PACKED_WEIGHT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Fusion/common/Checks.hpp"
+#include "Fusion/core/RawTensor.hpp"
+#include "Fusion/cpu/blas/GemmEpilogue.hpp"
+#include "Fusion/cpu/blas/PackedGemm.hpp"
+#include "Fusion/cpu/blas/SmallGemm.hpp"
+
+#include "Linalg.hpp"
+#include "OpParams.hpp"
+
+namespace fusion::math::linalg {
+
+// How a PackedWeight keeps op(w). BLAS repacks B on every call whatever we
+// do, but reads a plain non-transposed [K x N] matrix fastest; the native
+// kernel reads its NR-wide panels directly and skips packing altogether.
+// 16-bit weights stay row-major in both builds: the GEMM widens them per
+// call, and fp32 panels would double what the weight occupies.
+enum class PackedLayout { RowMajor, Panels };
+
+template <typename T> constexpr PackedLayout packed_layout() {
+   if constexpr (is_half_float_v<T>) {
+      return PackedLayout::RowMajor;
+   }
+#if defined(FUSION_NATIVE_GEMM)
+   return PackedLayout::Panels;
+#else
+   return fusion::blas::blas_precision<T> ? PackedLayout::RowMajor
+                                          : PackedLayout::Panels;
+#endif
+}
+
+// A weight used as the right-hand GEMM operand B = op(w) [K x N] call after
+// call (inference), held in the layout the GEMM backend reads fastest so
+// no call transposes or packs it again. transpose = true takes w as the
+// Linear kernel layout [N x K], so B = w^T.
+//
+// The packed copy follows w's buffer: a write through the tensor ops bumps
+// w's version and the next use repacks. Copies of a PackedWeight share one
+// packed copy. A repack fills a fresh buffer and swaps it in, so a GEMM that
+// took data() earlier keeps reading the panels it started with.
+template <typename T> class PackedWeight {
+ public:
+   PackedWeight() = default;
+
+   explicit PackedWeight(RawTensor<T> w, const bool transpose = false)
+       : w_(std::move(w)), transpose_(transpose),
+         cache_(std::make_shared<Cache>()) {
+      FUSION_CHECK(w_.is_initialised(), "PackedWeight: w uninitialised");
+      FUSION_CHECK(w_.rank() == 2, "PackedWeight: w must be 2-D");
+      std::lock_guard<std::mutex> lock(cache_->mutex);
+      repack(*cache_);
+   }
+
+   const RawTensor<T> &source() const noexcept { return w_; }
+   bool transposed() const noexcept { return transpose_; }
+   static constexpr PackedLayout layout() { return packed_layout<T>(); }
+
+   // op(w) is [rows x cols] = [K x N].
+   std::size_t rows() const { return w_.shape()[transpose_ ? 1 : 0]; }
+   std::size_t cols() const { return w_.shape()[transpose_ ? 0 : 1]; }
+
+   // Whether the packed copy still matches w's contents.
+   bool is_current() const {
+      std::lock_guard<std::mutex> lock(cache_->mutex);
+      return cache_->version == w_.version();
+   }
+
+   // The packed op(w), repacked first when w was written since. Hold the
+   // returned pointer for as long as the GEMM reads it.
+   std::shared_ptr<const T> data() const {
+      std::lock_guard<std::mutex> lock(cache_->mutex);
+      if (cache_->version != w_.version()) {
+         repack(*cache_);
+      }
+      return std::shared_ptr<const T>(cache_->panels,
+                                      cache_->panels->get(0));
+   }
+
+ private:
+   using Panels = fusion::blas::packed::AlignedBuffer<T>;
+
+   struct Cache {
+      std::mutex mutex;
+      std::shared_ptr<Panels> panels;
+      std::uint64_t version = 0;
+   };
+
+   void repack(Cache &c) const {
+      auto panels = std::make_shared<Panels>();
+      const detail::GemmOperand wo = detail::gemm_operand(w_, "PackedWeight");
+      // B = op(w) as a GEMM operand: transposed iff exactly one of the view
+      // and the requested op transposes.
+      const bool trans_b = wo.transpose != transpose_;
+      const int k = static_cast<int>(rows());
+      const int n = static_cast<int>(cols());
+      if constexpr (packed_layout<T>() == PackedLayout::Panels) {
+         T *out = panels->get(
+             fusion::blas::packed::packed_b_size<T>(rows(), cols()));
+         fusion::blas::packed::pack_b_all<T>(trans_b, k, n, w_.get_ptr(),
+                                             wo.ld, out);
+      } else {
+         T *out = panels->get(rows() * cols());
+         const auto s = fusion::blas::packed::operand_steps(trans_b, wo.ld);
+         const T *src = w_.get_ptr();
+         for (std::size_t i = 0; i < rows(); ++i) {
+            for (std::size_t j = 0; j < cols(); ++j) {
+               out[i * cols() + j] = src[static_cast<std::int64_t>(i) * s.row +
+                                         static_cast<std::int64_t>(j) * s.col];
+            }
+         }
+      }
+      c.panels = std::move(panels);
+      c.version = w_.version();
+   }
+
+   RawTensor<T> w_;
+   bool transpose_ = false;
+   std::shared_ptr<Cache> cache_;
+};
+
+namespace detail {
+
+// out [rows x N] = x [rows x K] op(w), then epi over every block of out.
+// Shapes that fit the small kernel never packed anything to begin with and
+// read w directly.
+template <typename T, class Epilogue>
+void packed_gemm(const RawTensor<T> &x, const GemmOperand &xa,
+                 const std::size_t rows, const PackedWeight<T> &W, T *out,
+                 const Epilogue &epi) {
+   const std::size_t K = W.rows();
+   const std::size_t N = W.cols();
+   const GemmOperand wo = gemm_operand(W.source(), "PackedWeight");
+   const bool trans_w = wo.transpose != W.transposed();
+   const auto m = static_cast<int>(rows);
+   const auto n = static_cast<int>(N);
+   const auto k = static_cast<int>(K);
+   if (fusion::blas::small::fits(xa.transpose, trans_w, rows, N, K)) {
+      fusion::blas::epilogue::gemm<T>(xa.transpose, trans_w, m, n, k,
+                                      x.get_ptr(), xa.ld, W.source().get_ptr(),
+                                      wo.ld, out, n, epi);
+      return;
+   }
+   const std::shared_ptr<const T> panels = W.data();
+   if constexpr (PackedWeight<T>::layout() == PackedLayout::Panels) {
+      fusion::blas::packed::gemm_prepacked<T>(xa.transpose, m, n, k, T(1),
+                                              x.get_ptr(), xa.ld, panels.get(),
+                                              T(0), out, n, epi);
+   } else {
+      fusion::blas::epilogue::gemm<T>(xa.transpose, false, m, n, k,
+                                      x.get_ptr(), xa.ld, panels.get(), n,
+                                      out, n, epi);
+   }
+}
+
+// x [..., K] as GEMM rows, leading axes folded in.
+template <typename T>
+GemmOperand packed_rows(const RawTensor<T> &x, const PackedWeight<T> &W,
+                        const char *what, std::size_t &rows) {
+   FUSION_CHECK(x.is_initialised(), std::string(what) + ": x uninitialised");
+   FUSION_CHECK(W.source().is_initialised(),
+                std::string(what) + ": packed weight is empty");
+   FUSION_CHECK(x.dtype() == W.source().dtype(),
+                std::string(what) + ": dtype mismatch");
+   FUSION_CHECK(x.device() == W.source().device(),
+                std::string(what) + ": device mismatch");
+   FUSION_CHECK(x.rank() >= 1 && x.shape().back() == W.rows(),
+                std::string(what) + ": x's last axis does not match W");
+   const std::size_t K = W.rows();
+   rows = x.flat_size() / std::max<std::size_t>(K, 1);
+   if (x.rank() == 2) {
+      return gemm_operand(x, what);
+   }
+   FUSION_CHECK(x.is_contiguous(), std::string(what) + ": x not contiguous");
+   return {false, static_cast<int>(K)};
+}
+
+} // namespace detail
+
+// A @ op(w) for a 2-D packed weight, the leading axes of A folding into the
+// GEMM rows as in matmul with a 2-D right operand.
+template <typename T>
+inline RawTensor<T> matmul(const RawTensor<T> &A, const PackedWeight<T> &W) {
+   FUSION_CHECK(A.rank() >= 2, "matmul: expected rank >= 2");
+   std::size_t rows = 0;
+   const detail::GemmOperand xa = detail::packed_rows(A, W, "matmul", rows);
+   std::vector<std::size_t> out_shape = A.shape();
+   out_shape.back() = W.cols();
+   RawTensor<T> out(out_shape, A.dtype(), A.device());
+   detail::packed_gemm(A, xa, rows, W, out.get_ptr(),
+                       fusion::blas::packed::NoEpilogue{});
+   return out;
+}
+
+// act(x op(w) + b), with bias and activation in the GEMM epilogue as in
+// linear(); a Linear kernel [units, in] is packed with transpose = true.
+template <typename T>
+inline RawTensor<T> linear(const RawTensor<T> &x, const PackedWeight<T> &W,
+                           const RawTensor<T> *b, const Activation act) {
+   std::size_t rows = 0;
+   const detail::GemmOperand xa = detail::packed_rows(x, W, "linear", rows);
+   if (b != nullptr) {
+      FUSION_CHECK(b->is_initialised() && b->is_contiguous() &&
+                       b->flat_size() == W.cols(),
+                   "linear: b must hold one value per unit");
+   }
+   std::vector<std::size_t> out_shape = x.shape();
+   out_shape.back() = W.cols();
+   RawTensor<T> out(out_shape, x.dtype(), x.device());
+   const fusion::blas::epilogue::BiasActivation<T> epi{
+       b != nullptr ? b->get_ptr() : nullptr, act, nullptr};
+   detail::packed_gemm(x, xa, rows, W, out.get_ptr(), epi);
+   return out;
+}
+
+template <typename T>
+inline RawTensor<T> linear(const RawTensor<T> &x, const PackedWeight<T> &W,
+                           const RawTensor<T> &b,
+                           const Activation act = Activation::None) {
+   return linear(x, W, &b, act);
+}
+
+template <typename T>
+inline RawTensor<T> linear(const RawTensor<T> &x, const PackedWeight<T> &W,
+                           const Activation act = Activation::None) {
+   return linear(x, W, static_cast<const RawTensor<T> *>(nullptr), act);
+}
+
+} // namespace fusion::math::linalg
+
+#endif // OPS_PACKED_WEIGHT_HPP
@@ -0,0 +1,338 @@
+#ifndef OPS_QUANTIZE_HPP
+#define OPS_QUANTIZE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Fusion/common/Checks.hpp"
+#include "Fusion/core/RawTensor.hpp"
+#include "Fusion/cpu/blas/QuantizedGemm.hpp"
+
+#include "Linalg.hpp"
+#include "OpParams.hpp"
+
+// Affine int8 quantization: real = scale * (q - zero_point), q in
+// [kQMin, kQMax]. A tensor has one (scale, zero_point) pair, or one per
+// index along a channel axis.
+namespace fusion::math::quant {
+
+using fusion::blas::quant::kQMax;
+using fusion::blas::quant::kQMin;
+
+struct QuantParams {
+   std::vector<float> scale;
+   std::vector<std::int32_t> zero_point;
+   // Channel axis, or -1 for a single pair over the whole tensor.
+   int axis = -1;
+
+   bool per_channel() const noexcept { return axis >= 0; }
+};
+
+// How calibrate() maps a range onto [kQMin, kQMax].
+//   Symmetric: [-max|x|, max|x|], zero_point 0. Weights; keeps the GEMM
+//              free of the per-row correction.
+//   Affine:    [min(x, 0), max(x, 0)], zero_point placed so 0 is exact.
+//              Activations, whose range is often one-sided (after ReLU).
+enum class QuantScheme { Symmetric, Affine };
+
+namespace detail {
+
+// Channel of flat element i for a contiguous tensor: (i / inner) % channels.
+struct ChannelMap {
+   std::size_t channels = 1;
+   std::size_t inner = 1;
+
+   std::size_t operator()(std::size_t i) const {
+      return (i / inner) % channels;
+   }
+};
+
+inline ChannelMap channel_map(const std::vector<std::size_t> &shape,
+                              int axis) {
+   ChannelMap m;
+   if (axis < 0) {
+      return m;
+   }
+   FUSION_CHECK(static_cast<std::size_t>(axis) < shape.size(),
+                "quantize: channel axis out of range");
+   m.channels = shape[static_cast<std::size_t>(axis)];
+   for (std::size_t d = static_cast<std::size_t>(axis) + 1; d < shape.size();
+        ++d) {
+      m.inner *= shape[d];
+   }
+   return m;
+}
+
+inline std::int8_t quantize_value(float x, float inv_scale,
+                                  std::int32_t zero) {
+   const float q = std::nearbyint(x * inv_scale) + static_cast<float>(zero);
+   return static_cast<std::int8_t>(
+       std::clamp(q, float(kQMin), float(kQMax)));
+}
+
+} // namespace detail
+
+// Scale and zero point from the range of x, per tensor (axis = -1) or per
+// index along axis.
+inline QuantParams calibrate(const RawTensor<float> &x, QuantScheme scheme,
+                             int axis = -1) {
+   FUSION_CHECK(x.is_initialised(), "calibrate: x uninitialised");
+   FUSION_CHECK(x.is_contiguous(), "calibrate: x is not contiguous");
+   const detail::ChannelMap ch = detail::channel_map(x.shape(), axis);
+   std::vector<float> lo(ch.channels, 0.0f);
+   std::vector<float> hi(ch.channels, 0.0f);
+   const float *p = x.get_ptr();
+   for (std::size_t i = 0; i < x.flat_size(); ++i) {
+      const std::size_t c = ch(i);
+      lo[c] = std::min(lo[c], p[i]);
+      hi[c] = std::max(hi[c], p[i]);
+   }
+
+   QuantParams q;
+   q.axis = axis;
+   q.scale.resize(ch.channels);
+   q.zero_point.resize(ch.channels);
+   for (std::size_t c = 0; c < ch.channels; ++c) {
+      float scale = 0.0f;
+      std::int32_t zero = 0;
+      if (scheme == QuantScheme::Symmetric) {
+         scale = std::max(-lo[c], hi[c]) / float(kQMax);
+      } else {
+         scale = (hi[c] - lo[c]) / float(kQMax - kQMin);
+         if (scale > 0.0f) {
+            zero = static_cast<std::int32_t>(
+                std::nearbyint(float(kQMin) - lo[c] / scale));
+            zero = std::clamp(zero, kQMin, kQMax);
+         }
+      }
+      // An all-zero channel quantizes to zero_point with any scale.
+      q.scale[c] = scale > 0.0f ? scale : 1.0f;
+      q.zero_point[c] = zero;
+   }
+   return q;
+}
+
+// int8 data with the parameters that map it back to real values.
+class QuantizedTensor {
+ public:
+   QuantizedTensor() = default;
+
+   QuantizedTensor(RawTensor<std::int8_t> data, QuantParams params)
+       : data_(std::move(data)), params_(std::move(params)) {
+      FUSION_CHECK(data_.is_initialised(), "QuantizedTensor: data empty");
+      const std::size_t n =
+          params_.per_channel()
+              ? detail::channel_map(data_.shape(), params_.axis).channels
+              : 1;
+      FUSION_CHECK(params_.scale.size() == n &&
+                       params_.zero_point.size() == n,
+                   "QuantizedTensor: need one scale and zero point per "
+                   "channel");
+      // -128 is excluded so every GEMM kernel gives the same answer. A
+      // strided view (a transposed weight) is checked over its whole buffer.
+      const bool dense = data_.is_contiguous();
+      const std::int8_t *first = dense ? data_.get_ptr() : data_.begin();
+      const std::int8_t *last =
+          dense ? first + data_.flat_size() : data_.end();
+      std::int8_t lo = 0;
+      for (const std::int8_t *v = first; v != last; ++v) {
+         lo = std::min(lo, *v);
+      }
+      FUSION_CHECK(lo >= kQMin,
+                   "QuantizedTensor: values must lie in [-127, 127]");
+   }
+
+   const RawTensor<std::int8_t> &data() const noexcept { return data_; }
+   const QuantParams &params() const noexcept { return params_; }
+   std::vector<std::size_t> shape() const { return data_.shape(); }
+
+ private:
+   RawTensor<std::int8_t> data_;
+   QuantParams params_;
+};
+
+inline QuantizedTensor quantize(const RawTensor<float> &x,
+                                QuantParams params) {
+   FUSION_CHECK(x.is_initialised(), "quantize: x uninitialised");
+   FUSION_CHECK(x.is_contiguous(), "quantize: x is not contiguous");
+   const detail::ChannelMap ch = detail::channel_map(
+       x.shape(), params.per_channel() ? params.axis : -1);
+   FUSION_CHECK(params.scale.size() == ch.channels &&
+                    params.zero_point.size() == ch.channels,
+                "quantize: need one scale and zero point per channel");
+   std::vector<float> inv(ch.channels);
+   for (std::size_t c = 0; c < ch.channels; ++c) {
+      FUSION_CHECK(params.scale[c] > 0.0f, "quantize: scale must be > 0");
+      inv[c] = 1.0f / params.scale[c];
+   }
+
+   RawTensor<std::int8_t> q(x.shape(), DType::INT8, x.device());
+   const float *src = x.get_ptr();
+   std::int8_t *dst = q.get_ptr();
+   const std::size_t n = x.flat_size();
+   fusion::parallel::parallel_for(
+       0, n, std::size_t{1} << 15, [&](std::size_t lo, std::size_t hi) {
+          for (std::size_t i = lo; i < hi; ++i) {
+             const std::size_t c = ch(i);
+             dst[i] = detail::quantize_value(src[i], inv[c],
+                                             params.zero_point[c]);
+          }
+       });
+   return QuantizedTensor(std::move(q), std::move(params));
+}
+
+inline QuantizedTensor quantize(const RawTensor<float> &x,
+                                QuantScheme scheme = QuantScheme::Affine,
+                                int axis = -1) {
+   return quantize(x, calibrate(x, scheme, axis));
+}
+
+inline RawTensor<float> dequantize(const QuantizedTensor &q) {
+   const RawTensor<std::int8_t> &data = q.data();
+   FUSION_CHECK(data.is_contiguous(), "dequantize: data is not contiguous");
+   const QuantParams &p = q.params();
+   const detail::ChannelMap ch = detail::channel_map(data.shape(), p.axis);
+   RawTensor<float> out(data.shape(), DType::FLOAT32, data.device());
+   const std::int8_t *src = data.get_ptr();
+   float *dst = out.get_ptr();
+   const std::size_t n = data.flat_size();
+   fusion::parallel::parallel_for(
+       0, n, std::size_t{1} << 15, [&](std::size_t lo, std::size_t hi) {
+          for (std::size_t i = lo; i < hi; ++i) {
+             const std::size_t c = ch(i);
+             dst[i] = p.scale[c] * static_cast<float>(src[i] - p.zero_point[c]);
+          }
+       });
+   return out;
+}
+
+// A Linear kernel [units, in] in int8, quantized per tensor or per unit
+// (axis 0) and packed once for the int8 GEMM.
+class QuantizedWeight {
+ public:
+   QuantizedWeight() = default;
+
+   explicit QuantizedWeight(const QuantizedTensor &w) {
+      const RawTensor<std::int8_t> &data = w.data();
+      FUSION_CHECK(data.rank() == 2, "QuantizedWeight: w must be 2-D");
+      const QuantParams &p = w.params();
+      FUSION_CHECK(!p.per_channel() || p.axis == 0,
+                   "QuantizedWeight: channels must run along the units");
+      units_ = data.shape()[0];
+      in_ = data.shape()[1];
+      scale_.resize(units_);
+      std::vector<std::int32_t> zero(units_);
+      for (std::size_t j = 0; j < units_; ++j) {
+         scale_[j] = p.per_channel() ? p.scale[j] : p.scale[0];
+         zero[j] = p.per_channel() ? p.zero_point[j] : p.zero_point[0];
+      }
+      // B = w^T [in x units]: transposed unless w already is a view of it.
+      const auto wo =
+          fusion::math::linalg::detail::gemm_operand(data, "QuantizedWeight");
+      packed_ = fusion::blas::quant::pack_b(
+          !wo.transpose, static_cast<int>(in_), static_cast<int>(units_),
+          data.get_ptr(), wo.ld, std::move(zero));
+   }
+
+   // Symmetric, per unit: the usual choice for weights.
+   explicit QuantizedWeight(const RawTensor<float> &w)
+       : QuantizedWeight(quantize(w, QuantScheme::Symmetric, 0)) {}
+
+   std::size_t units() const noexcept { return units_; }
+   std::size_t in_features() const noexcept { return in_; }
+   const std::vector<float> &scale() const noexcept { return scale_; }
+   const fusion::blas::quant::PackedB &packed() const noexcept {
+      return packed_;
+   }
+
+ private:
+   std::size_t units_ = 0;
+   std::size_t in_ = 0;
+   std::vector<float> scale_;
+   fusion::blas::quant::PackedB packed_;
+};
+
+namespace detail {
+
+// x [..., in] as int8 GEMM rows against w. make_epi(rescale, out_shape)
+// allocates the output and returns the epilogue that writes it.
+template <class MakeEpilogue>
+void quantized_linear(const QuantizedTensor &x, const QuantizedWeight &w,
+                      const RawTensor<float> *b, const Activation act,
+                      MakeEpilogue &&make_epi) {
+   const RawTensor<std::int8_t> &data = x.data();
+   FUSION_CHECK(data.is_initialised(), "linear: x uninitialised");
+   FUSION_CHECK(!x.params().per_channel(),
+                "linear: x must be quantized per tensor");
+   FUSION_CHECK(data.is_contiguous(), "linear: x is not contiguous");
+   FUSION_CHECK(data.rank() >= 1 && data.shape().back() == w.in_features(),
+                "linear: x's last axis does not match W");
+   if (b != nullptr) {
+      FUSION_CHECK(b->is_initialised() && b->is_contiguous() &&
+                       b->flat_size() == w.units(),
+                   "linear: b must hold one value per unit");
+   }
+   const std::size_t in = w.in_features();
+   const std::size_t rows = data.flat_size() / std::max<std::size_t>(in, 1);
+   std::vector<std::size_t> out_shape = data.shape();
+   out_shape.back() = w.units();
+
+   const fusion::blas::quant::Rescale rescale{
+       x.params().scale[0], w.scale().data(),
+       b != nullptr ? b->get_ptr() : nullptr, act};
+   fusion::blas::quant::gemm(rows, data.get_ptr(), in,
+                             x.params().zero_point[0], w.packed(),
+                             make_epi(rescale, out_shape));
+}
+
+} // namespace detail
+
+// act(x w^T + b) in float from int8 x and w: the int32 products are
+// rescaled, biased and activated in the GEMM epilogue.
+inline RawTensor<float> linear(const QuantizedTensor &x,
+                               const QuantizedWeight &w,
+                               const RawTensor<float> *b = nullptr,
+                               const Activation act = Activation::None) {
+   RawTensor<float> out;
+   detail::quantized_linear(
+       x, w, b, act,
+       [&](const fusion::blas::quant::Rescale &r,
+           const std::vector<std::size_t> &shape) {
+          out = RawTensor<float>(shape, DType::FLOAT32, x.data().device());
+          return fusion::blas::quant::Dequantize{r, out.get_ptr(), w.units()};
+       });
+   return out;
+}
+
+// The same, requantized to int8 with `out_params` (per tensor) in the
+// epilogue, so a chain of quantized layers never materialises float.
+inline QuantizedTensor linear(const QuantizedTensor &x,
+                              const QuantizedWeight &w,
+                              const RawTensor<float> *b, const Activation act,
+                              QuantParams out_params) {
+   FUSION_CHECK(!out_params.per_channel() && out_params.scale.size() == 1 &&
+                    out_params.zero_point.size() == 1 &&
+                    out_params.scale[0] > 0.0f,
+                "linear: output must be quantized per tensor");
+   RawTensor<std::int8_t> out;
+   detail::quantized_linear(
+       x, w, b, act,
+       [&](const fusion::blas::quant::Rescale &r,
+           const std::vector<std::size_t> &shape) {
+          out = RawTensor<std::int8_t>(shape, DType::INT8, x.data().device());
+          return fusion::blas::quant::Requantize{
+              r, out_params.scale[0], out_params.zero_point[0], out.get_ptr(),
+              w.units()};
+       });
+   return QuantizedTensor(std::move(out), std::move(out_params));
+}
+
+} // namespace fusion::math::quant
+
+#endif // OPS_QUANTIZE_HPP
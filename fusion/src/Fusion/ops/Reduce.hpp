@@ -15,6 +15,17 @@ namespace fusion {
 
 namespace math {
 
+template <typename T>
+inline RawTensor<T> sum(const RawTensor<T> &x,
+                        const std::vector<std::size_t> &axes,
+                        const bool keep_dim,
+                        const SumMode mode = SumMode::Pairwise) {
+   ReductionMeta meta = make_reduction_meta(x, axes, keep_dim);
+   RawTensor<T> out = init_out_from_meta(x, meta);
+   fusion::iter::reduction_tag<T, SumSIMD>(x, meta, out, mode);
+   return out;
+}
+
 template <typename T>
 inline RawTensor<T> sum(const RawTensor<T> &x, const std::size_t axis,
                         const bool keep_dim) {
@@ -24,17 +35,111 @@ inline RawTensor<T> sum(const RawTensor<T> &x, const std::size_t axis,
    return out;
 }
 
+template <typename T>
+inline RawTensor<T> mean(const RawTensor<T> &x,
+                         const std::vector<std::size_t> &axes,
+                         const bool keep_dim,
+                         const SumMode mode = SumMode::Pairwise) {
+   ReductionMeta meta = make_reduction_meta(x, axes, keep_dim);
+   RawTensor<T> out = init_out_from_meta(x, meta);
+   const T scale = T(1) / static_cast<T>(meta.reduce_len);
+   fusion::iter::reduction_tag<T, SumSIMD>(x, meta, out, mode, scale);
+   return out;
+}
+
 template <typename T>
 inline RawTensor<T> mean(const RawTensor<T> &x, const std::size_t axis,
                          const bool keep_dim) {
    ReductionMeta meta = make_reduction_meta(x, axis, keep_dim);
    RawTensor<T> out = init_out_from_meta(x, meta);
-   fusion::iter::reduction_tag<T, SumSIMD>(x, meta, out);
-   const T denom = static_cast<T>(meta.reduce_len);
-   out = out / denom;
+   const T scale = T(1) / static_cast<T>(meta.reduce_len);
+   fusion::iter::reduction_tag<T, SumSIMD>(x, meta, out, SumMode::Pairwise,
+                                           scale);
+   return out;
+}
+
+// out= variants. out must already have the reduced shape and must not
+// overlap x.
+template <typename T>
+inline RawTensor<T> &sum(const RawTensor<T> &x,
+                         const std::vector<std::size_t> &axes,
+                         const bool keep_dim, RawTensor<T> &out,
+                         const SumMode mode = SumMode::Pairwise) {
+   ReductionMeta meta = make_reduction_meta(x, axes, keep_dim);
+   check_out(out, x, meta.out_shape, "sum");
+   check_no_alias(out, x, "sum");
+   fusion::iter::reduction_tag<T, SumSIMD>(x, meta, out, mode);
+   out.bump_version();
+   return out;
+}
+
+template <typename T>
+inline RawTensor<T> &mean(const RawTensor<T> &x,
+                          const std::vector<std::size_t> &axes,
+                          const bool keep_dim, RawTensor<T> &out,
+                          const SumMode mode = SumMode::Pairwise) {
+   ReductionMeta meta = make_reduction_meta(x, axes, keep_dim);
+   check_out(out, x, meta.out_shape, "mean");
+   check_no_alias(out, x, "mean");
+   const T scale = T(1) / static_cast<T>(meta.reduce_len);
+   fusion::iter::reduction_tag<T, SumSIMD>(x, meta, out, mode, scale);
+   out.bump_version();
+   return out;
+}
+
+// Variance over `axes` in one pass (Welford/Chan). correction = 0 gives the
+// population variance, 1 the unbiased sample variance.
+template <typename T>
+inline RawTensor<T> var(const RawTensor<T> &x,
+                        const std::vector<std::size_t> &axes,
+                        const bool keep_dim, const std::size_t correction = 0) {
+   ReductionMeta meta = make_reduction_meta(x, axes, keep_dim);
+   RawTensor<T> out = init_out_from_meta(x, meta);
+   fusion::iter::variance_tag<T>(x, meta, out, correction, false);
    return out;
 }
 
+template <typename T>
+inline RawTensor<T> stddev(const RawTensor<T> &x,
+                           const std::vector<std::size_t> &axes,
+                           const bool keep_dim,
+                           const std::size_t correction = 0) {
+   ReductionMeta meta = make_reduction_meta(x, axes, keep_dim);
+   RawTensor<T> out = init_out_from_meta(x, meta);
+   fusion::iter::variance_tag<T>(x, meta, out, correction, true);
+   return out;
+}
+
+// Sums a broadcast result back down to `shape` (right-aligned, as
+// broadcasting aligns): the gradient of an operand that was broadcast in the
+// forward pass. Returns g unchanged when no axis was broadcast.
+template <typename T>
+inline RawTensor<T> sum_to_shape(const RawTensor<T> &g,
+                                 const std::vector<std::size_t> &shape) {
+   const std::vector<std::size_t> g_shape = g.shape();
+   if (g_shape == shape) {
+      return g;
+   }
+   FUSION_CHECK(g_shape.size() >= shape.size(),
+                "sum_to_shape: target has higher rank than source");
+   const std::size_t lead = g_shape.size() - shape.size();
+   std::vector<std::size_t> axes;
+   for (std::size_t d = 0; d < g_shape.size(); ++d) {
+      if (d < lead) {
+         axes.push_back(d);
+      } else if (shape[d - lead] == 1 && g_shape[d] != 1) {
+         axes.push_back(d);
+      } else {
+         FUSION_CHECK(shape[d - lead] == g_shape[d],
+                      "sum_to_shape: shapes are not broadcast-compatible");
+      }
+   }
+   if (axes.empty()) {
+      return g.reshape(shape);
+   }
+   return g.sum(axes, true).reshape(shape);
+}
+
 } // namespace math
 
 } // namespace fusion
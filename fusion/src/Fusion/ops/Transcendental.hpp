@@ -1,12 +1,15 @@
 #ifndef OPS_TRANSCENENTAL_HPP
 #define OPS_TRANSCENENTAL_HPP
 
+#include <string>
 #include <string_view>
 #include <vector>
 
 #include "Fusion/core/RawTensor.hpp"
 #include "Fusion/core/TensorIter.hpp"
 
+#include "Helpers.hpp"
+
 namespace fusion {
 
 namespace math {
@@ -32,6 +35,47 @@ template <typename T> inline RawTensor<T> exp(const RawTensor<T> &x) {
    return out;
 }
 
+// out= variants. out may be x itself, which makes these in place.
+
+template <typename T, class Tag>
+inline RawTensor<T> &unary_into(const RawTensor<T> &x, RawTensor<T> &out,
+                                const std::string &op) {
+   UnaryEwiseMeta meta = make_unary_meta(x);
+   check_out(out, x, meta.out_shape, op);
+   check_ewise_alias(out, x, op);
+   fusion::iter::unary_ewise_tag<T, Tag>(x, meta, out);
+   out.bump_version();
+   return out;
+}
+
+template <typename T>
+inline RawTensor<T> &sqrt(const RawTensor<T> &x, RawTensor<T> &out) {
+   return unary_into<T, SqrtSIMD>(x, out, "sqrt");
+}
+
+template <typename T>
+inline RawTensor<T> &log(const RawTensor<T> &x, RawTensor<T> &out) {
+   return unary_into<T, NaturalLogSIMD>(x, out, "log");
+}
+
+template <typename T>
+inline RawTensor<T> &exp(const RawTensor<T> &x, RawTensor<T> &out) {
+   return unary_into<T, ExponentialSIMD>(x, out, "exp");
+}
+
+// Evaluates into x's own buffer when nothing else shares it.
+template <typename T, class Tag>
+inline RawTensor<T> unary_donating(RawTensor<T> &&x) {
+   UnaryEwiseMeta meta = make_unary_meta(x);
+   if (can_donate(&x, meta.out_shape)) {
+      fusion::iter::unary_ewise_tag<T, Tag>(x, meta, x);
+      return std::move(x);
+   }
+   RawTensor<T> out = init_out_from_meta(x, meta);
+   fusion::iter::unary_ewise_tag<T, Tag>(x, meta, out);
+   return out;
+}
+
 } // namespace math
 
 } // namespace fusion
@@ -6,6 +6,7 @@
 #include "Fusion/autodiff/AutodiffBridge.hpp"
 #include "Fusion/autodiff/AutodiffMode.hpp"
 #include "Fusion/autodiff/EngineContext.hpp"
+#include "Fusion/core/Parallel.h"
 
 #include "factory/BindFactory.hpp"
 #include "random/BindRandom.hpp"
@@ -14,11 +15,14 @@
 namespace py = pybind11;
 
 PYBIND11_MODULE(fusion, m_ten) {
-   m_ten.doc() =
-       "Fusion Tensor module exposing Tensor<float> (for composition)";
+   m_ten.doc() = "Fusion Tensor module exposing Tensor<float> and "
+                 "Tensor<double> (for composition)";
    bind_tensor<float>(m_ten, "Tensor");
    bind_factory<float>(m_ten, "factory");
    bind_random<float>(m_ten, "Random");
+   bind_tensor<double>(m_ten, "Tensor64");
+   bind_factory<double>(m_ten, "factory64");
+   bind_random<double>(m_ten, "Random64");
 
    py::class_<Device>(m_ten, "CppDevice")
        .def(py::init<DeviceType, DeviceIdx>(), py::arg("type"),
@@ -34,24 +38,35 @@ PYBIND11_MODULE(fusion, m_ten) {
        .value("FLOAT64", DType::FLOAT64)
        .value("INT32", DType::INT32)
        .value("INT64", DType::INT64)
-       .value("BOOL", DType::BOOL);
+       .value("BOOL", DType::BOOL)
+       .value("BFLOAT16", DType::BFLOAT16)
+       .value("FLOAT16", DType::FLOAT16)
+       .value("INT8", DType::INT8);
 
-   py::class_<EngineScope<float>>(m_ten, "grad_tape")
+   py::class_<GradTape>(m_ten, "grad_tape")
        .def(py::init<>())
        .def(
            "__enter__",
-           [](EngineScope<float> &self) -> EngineScope<float> & {
+           [](GradTape &self) -> GradTape & {
               self.enter();
               return self;
            },
            py::return_value_policy::reference)
        .def("__exit__",
-            [](EngineScope<float> &self, const py::object &, const py::object &,
+            [](GradTape &self, const py::object &, const py::object &,
                const py::object &) -> bool {
                self.exit();
                return false;
             });
 
+   m_ten.def("set_num_threads", &fusion::parallel::set_num_threads,
+             py::arg("num_threads"),
+             "Set the number of threads used by Fusion kernels and BLAS. "
+             "Defaults to FUSION_NUM_THREADS or the CPUs this process may "
+             "run on.");
+   m_ten.def("get_num_threads", &fusion::parallel::get_num_threads,
+             "Number of threads used by Fusion kernels.");
+
    auto m_ad = m_ten.def_submodule("autodiff", "Autodiff control");
 
    m_ad.def(
@@ -59,11 +74,12 @@ PYBIND11_MODULE(fusion, m_ten) {
        [](pybind11::object &state) -> bool {
           if (!state.is_none()) {
              const bool active = pybind11::cast<bool>(state);
-             set_autodiff_enabled<float>(active);
+             set_autodiff_enabled_all(active);
           }
           return autodiff::grad_enabled();
        },
        pybind11::arg("state") = pybind11::none(),
        "Get or set whether autodiff is enabled for this thread. "
-       "When enabled, a default Engine is installed in the EngineContext.");
+       "When enabled, a default Engine is installed in the EngineContext "
+       "for both Tensor and Tensor64.");
 }
@@ -170,12 +170,74 @@ template <typename T> void bind_tensor(py::module_ &m, const char *name) {
        .def("exp", &PyT::exp)
        .def("log", &PyT::log)
        .def("sum", [](const PyT &t) { return t.sum(-1, false); })
-       .def("sum", &PyT::sum, py::arg("axis"), py::arg("keepdim") = false)
+       .def(
+           "sum",
+           [](const PyT &t, std::int64_t axis, bool keepdim) {
+              return t.sum(tensor_py_helpers::to_axis(axis, t.rank()),
+                            keepdim);
+           },
+           py::arg("axis"), py::arg("keepdim") = false)
+       .def(
+           "sum",
+           [](const PyT &t, const std::vector<std::int64_t> &axes,
+              bool keepdim) {
+              return t.sum(tensor_py_helpers::to_axes(axes), keepdim);
+           },
+           py::arg("axis"), py::arg("keepdim") = false)
        .def("mean", [](const PyT &t) { return t.mean(-1, false); })
-       .def("mean", &PyT::mean, py::arg("axis"), py::arg("keepdim") = false)
+       .def(
+           "mean",
+           [](const PyT &t, std::int64_t axis, bool keepdim) {
+              return t.mean(tensor_py_helpers::to_axis(axis, t.rank()),
+                            keepdim);
+           },
+           py::arg("axis"), py::arg("keepdim") = false)
+       .def(
+           "mean",
+           [](const PyT &t, const std::vector<std::int64_t> &axes,
+              bool keepdim) {
+              return t.mean(tensor_py_helpers::to_axes(axes), keepdim);
+           },
+           py::arg("axis"), py::arg("keepdim") = false)
+
+       .def(
+           "var",
+           [](const PyT &t, const std::vector<std::int64_t> &axes,
+              bool keepdim, std::size_t correction) {
+              return t.var(tensor_py_helpers::to_axes(axes), keepdim,
+                           correction);
+           },
+           py::arg("axis") = std::vector<std::int64_t>{},
+           py::arg("keepdim") = false, py::arg("correction") = 0)
+       .def(
+           "std",
+           [](const PyT &t, const std::vector<std::int64_t> &axes,
+              bool keepdim, std::size_t correction) {
+              return t.stddev(tensor_py_helpers::to_axes(axes), keepdim,
+                              correction);
+           },
+           py::arg("axis") = std::vector<std::int64_t>{},
+           py::arg("keepdim") = false, py::arg("correction") = 0)
 
        // --- matrix multiply ( @ ) ---
        .def("__matmul__", &PyT::matmul, "Matrix multiplication (A @ B)")
+       .def(
+           "linear",
+           [](const PyT &x, const PyT &w, const std::string &activation) {
+              return x.linear(w, tensor_py_helpers::to_activation(activation));
+           },
+           py::arg("kernel"), py::arg("activation") = "none",
+           "activation(x @ kernel.T), fused into one GEMM.")
+       .def(
+           "linear",
+           [](const PyT &x, const PyT &w, const PyT &b,
+              const std::string &activation) {
+              return x.linear(w, b,
+                              tensor_py_helpers::to_activation(activation));
+           },
+           py::arg("kernel"), py::arg("bias"), py::arg("activation") = "none",
+           "activation(x @ kernel.T + bias), with the bias and activation "
+           "applied in the GEMM epilogue.")
 
        // --- power & maximum ---
        .def(
@@ -1,8 +1,10 @@
 #ifndef TENSOR_HELPERS_H
 #define TENSOR_HELPERS_H
 
+#include <cstdint>
 #include <pybind11/numpy.h>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "Fusion/Tensor.h"
@@ -12,7 +14,7 @@ namespace py = pybind11;
 
 namespace tensor_py_helpers {
 template <typename T>
-inline py::array_t<float> tensor_to_numpy(const Tensor<float> &t) {
+inline py::array_t<T> tensor_to_numpy(const Tensor<T> &t) {
    // Grab the shape vector
    const auto &shape = t.shape();
    size_t ndim = shape.size();
@@ -21,19 +23,19 @@ inline py::array_t<float> tensor_to_numpy(const Tensor<float> &t) {
    // Build Python-side shape and stride arrays
    std::vector<ssize_t> py_shape(shape.begin(), shape.end());
    std::vector<ssize_t> py_strides(ndim);
-   // C‐contiguous: stride of last dim is sizeof(float)
-   ssize_t running = sizeof(float);
+   // C‐contiguous: stride of last dim is sizeof(T)
+   ssize_t running = sizeof(T);
    for (int i = ndim - 1; i >= 0; --i) {
       py_strides[i] = running;
       running *= static_cast<ssize_t>(shape[i]);
    }
 
    // Allocate the array
-   py::array_t<float> arr(py_shape, py_strides);
+   py::array_t<T> arr(py_shape, py_strides);
    auto buf = arr.request();
-   float *dst = static_cast<float *>(buf.ptr);
+   T *dst = static_cast<T *>(buf.ptr);
 
-   // Copy from our flat std::vector<float>
+   // Copy from our flat std::vector<T>
    const auto &src = t.raw().raw_data();
    if (t.size() != total) {
       throw std::runtime_error("tensor_to_numpy: size mismatch");
@@ -43,6 +45,41 @@ inline py::array_t<float> tensor_to_numpy(const Tensor<float> &t) {
    return arr;
 }
 
+// Python axes may be negative; the reduction meta normalises them.
+inline std::vector<std::size_t>
+to_axes(const std::vector<std::int64_t> &axes) {
+   return std::vector<std::size_t>(axes.begin(), axes.end());
+}
+
+// A single Python axis, negative counting from the back. Resolved here:
+// the C++ API reads size_t(-1) as "every axis", not the last one.
+inline std::size_t to_axis(std::int64_t axis, std::size_t rank) {
+   const auto r = static_cast<std::int64_t>(rank);
+   if (axis < -r || axis >= r) {
+      throw std::out_of_range("axis " + std::to_string(axis) +
+                              " out of range for rank " +
+                              std::to_string(rank));
+   }
+   return static_cast<std::size_t>(axis < 0 ? axis + r : axis);
+}
+
+// Activation names as Python passes them: "none", "relu", "gelu", "tanh".
+inline Activation to_activation(const std::string &name) {
+   if (name == "none") {
+      return Activation::None;
+   }
+   if (name == "relu") {
+      return Activation::ReLU;
+   }
+   if (name == "gelu") {
+      return Activation::GELU;
+   }
+   if (name == "tanh") {
+      return Activation::Tanh;
+   }
+   throw std::invalid_argument("unknown activation '" + name + "'");
+}
+
 } // namespace tensor_py_helpers
 
 #endif // TENSOR_HELPERS_H
@@ -1,7 +1,9 @@
 #ifndef TENSOR_BUFFER_H
 #define TENSOR_BUFFER_H
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
@@ -65,8 +67,21 @@ class TensorBuffer {
 
    TensorBuffer(const TensorBuffer &) = delete;
    TensorBuffer &operator=(const TensorBuffer &) = delete;
-   TensorBuffer(TensorBuffer &&) noexcept = default;
-   TensorBuffer &operator=(TensorBuffer &&) noexcept = default;
+   // Member-wise like the defaults; the atomic version counter has no move.
+   TensorBuffer(TensorBuffer &&other) noexcept
+       : ptr_(std::move(other.ptr_)), size_(other.size_),
+         alignment_(other.alignment_), allocator_(other.allocator_),
+         version_(other.version_.load(std::memory_order_acquire)) {}
+
+   TensorBuffer &operator=(TensorBuffer &&other) noexcept {
+      ptr_ = std::move(other.ptr_);
+      size_ = other.size_;
+      alignment_ = other.alignment_;
+      allocator_ = other.allocator_;
+      version_.store(other.version_.load(std::memory_order_acquire),
+                     std::memory_order_release);
+      return *this;
+   }
 
    void *data() noexcept { return ptr_.get(); };
    const void *data() const noexcept { return ptr_.get(); };
@@ -92,6 +107,20 @@ class TensorBuffer {
       std::swap(ptr_, other.ptr_);
       std::swap(size_, other.size_);
       std::swap(alignment_, other.alignment_);
+      bump_version();
+      other.bump_version();
+   }
+
+   // Counts writes made through the tensor ops (in-place and out= variants)
+   // so caches derived from the contents, e.g. a packed weight, can tell
+   // when they are stale. Writes through raw pointers must bump it. Writers
+   // and cache readers may be on different threads: the release bump pairs
+   // with the acquire read.
+   std::uint64_t version() const noexcept {
+      return version_.load(std::memory_order_acquire);
+   }
+   void bump_version() noexcept {
+      version_.fetch_add(1, std::memory_order_release);
    }
 
    template <typename T> std::size_t size() const noexcept {
@@ -153,6 +182,7 @@ class TensorBuffer {
    size_t size_{0};
    size_t alignment_{alignof(std::max_align_t)};
    IAllocator *allocator_{nullptr};
+   std::atomic<std::uint64_t> version_{0};
 
    TensorBuffer(void *raw, size_t size, size_t alignment, IAllocator *alloc)
        : ptr_(raw, Deleter{alloc, size, alignment}), size_(size),
@@ -0,0 +1,69 @@
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+#include "Fusion/autodiff/ADTensor.hpp"
+#include "Fusion/autodiff/Executor.hpp"
+#include "Fusion/core/Parallel.h"
+
+namespace {
+
+RawTensor<float> make_raw(std::vector<std::size_t> shape, float start) {
+   std::size_t n = 1;
+   for (auto d : shape) {
+      n *= d;
+   }
+   std::vector<float> data(n);
+   for (std::size_t i = 0; i < n; ++i) {
+      data[i] = start + 0.1f * static_cast<float>(i);
+   }
+   return RawTensor<float>(shape, data, DType::FLOAT32,
+                           Device{DeviceType::CPU, 0});
+}
+
+std::vector<float> to_vec(const RawTensor<float> &t) {
+   return std::vector<float>(t.begin(), t.end());
+}
+
+} // namespace
+
+TEST(GraphExecutorTest, ReplayMatchesEagerWithNewInput) {
+   fusion::parallel::set_num_threads(4);
+   EngineScope<float> scope;
+   scope.enter();
+
+   ADTensor<float> x(make_raw({4, 4}, 0.0f), true);
+   ADTensor<float> w1(make_raw({4, 4}, 1.0f), true);
+   ADTensor<float> w2(make_raw({4, 4}, -1.0f), true);
+   // Two independent heads joined by an Add.
+   ADTensor<float> y = x.matmul(w1).exp() + x.matmul(w2).sum(-1, false);
+
+   GraphExecutor<float> exec(EngineContext<float>::get());
+   EXPECT_GE(exec.max_width(), 2u);
+   EXPECT_EQ(exec.inter_op_threads(), 2u);
+   EXPECT_EQ(exec.intra_op_threads(), 2u);
+
+   RawTensor<float> x2 = make_raw({4, 4}, 0.5f);
+   exec.feed(x.vid(), x2);
+   exec.run();
+
+   const RawTensor<float> expected =
+       x2.matmul(w1.raw()).exp() + x2.matmul(w2.raw()).sum(-1, false);
+   const auto got = to_vec(exec.value(y.vid()));
+   const auto want = to_vec(expected);
+   ASSERT_EQ(got.size(), want.size());
+   for (std::size_t i = 0; i < want.size(); ++i) {
+      EXPECT_FLOAT_EQ(got[i], want[i]);
+   }
+}
+
+TEST(GraphExecutorTest, RejectsFeedingIntermediateValue) {
+   EngineScope<float> scope;
+   scope.enter();
+   ADTensor<float> x(make_raw({2, 2}, 0.0f), true);
+   ADTensor<float> y = x.exp();
+   GraphExecutor<float> exec(EngineContext<float>::get());
+   EXPECT_THROW(exec.feed(y.vid(), make_raw({2, 2}, 0.0f)),
+                std::runtime_error);
+}
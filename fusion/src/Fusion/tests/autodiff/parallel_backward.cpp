@@ -0,0 +1,84 @@
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+#include "Fusion/autodiff/ADTensor.hpp"
+#include "Fusion/core/Parallel.h"
+
+namespace {
+
+RawTensor<float> make_raw(std::vector<std::size_t> shape, float start) {
+   std::size_t n = 1;
+   for (auto d : shape) {
+      n *= d;
+   }
+   std::vector<float> data(n);
+   for (std::size_t i = 0; i < n; ++i) {
+      data[i] = start + 0.01f * static_cast<float>(i % 17);
+   }
+   return RawTensor<float>(shape, data, DType::FLOAT32,
+                           Device{DeviceType::CPU, 0});
+}
+
+// Sum of `branches` independent x @ w_i -> exp -> sum chains that share x.
+std::vector<float> wide_graph_grad(bool parallel, std::size_t branches) {
+   EngineScope<float> scope;
+   scope.enter();
+   EngineContext<float>::get().set_parallel_backward(parallel);
+
+   ADTensor<float> x(make_raw({8, 8}, 0.1f), true);
+   ADTensor<float> total(make_raw({1}, 0.0f), false);
+   for (std::size_t b = 0; b < branches; ++b) {
+      ADTensor<float> w(make_raw({8, 8}, 0.05f * float(b)), false);
+      total = total + x.matmul(w).exp().sum(-1, false);
+   }
+   total.backward();
+   auto g = x.grad();
+   EXPECT_TRUE(g.has_value());
+   return std::vector<float>(g->raw().begin(), g->raw().end());
+}
+
+// x @ w_0 @ w_1 ... -> sum: one node per level, nothing to overlap.
+std::vector<float> chain_grad(bool parallel, std::size_t depth) {
+   EngineScope<float> scope;
+   scope.enter();
+   EngineContext<float>::get().set_parallel_backward(parallel);
+
+   ADTensor<float> x(make_raw({64, 64}, 0.1f), true);
+   ADTensor<float> w0(make_raw({64, 64}, 0.0f), false);
+   ADTensor<float> h = x.matmul(w0);
+   for (std::size_t d = 1; d < depth; ++d) {
+      ADTensor<float> w(make_raw({64, 64}, 0.01f * float(d)), false);
+      h = h.matmul(w);
+   }
+   h.sum(-1, false).sum(-1, false).backward();
+   auto g = x.grad();
+   EXPECT_TRUE(g.has_value());
+   return std::vector<float>(g->raw().begin(), g->raw().end());
+}
+
+} // namespace
+
+TEST(ParallelBackwardTest, MatchesSequentialOnWideGraph) {
+   fusion::parallel::set_num_threads(4);
+   const auto seq = wide_graph_grad(false, 16);
+   const auto par = wide_graph_grad(true, 16);
+   ASSERT_EQ(seq.size(), par.size());
+   for (std::size_t i = 0; i < seq.size(); ++i) {
+      EXPECT_NEAR(seq[i], par[i], 1e-4f * std::abs(seq[i]));
+   }
+}
+
+TEST(ParallelBackwardTest, IsReproducibleAcrossRuns) {
+   fusion::parallel::set_num_threads(4);
+   const auto a = wide_graph_grad(true, 16);
+   fusion::parallel::set_num_threads(2);
+   const auto b = wide_graph_grad(true, 16);
+   EXPECT_EQ(a, b);
+}
+
+TEST(ParallelBackwardTest, ChainKeepsTheSequentialWalk) {
+   fusion::parallel::set_num_threads(4);
+   EXPECT_EQ(chain_grad(true, 6), chain_grad(false, 6));
+}
@@ -0,0 +1,130 @@
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+#include "Fusion/autodiff/ADTensor.hpp"
+
+namespace {
+
+RawTensor<float> filled(std::vector<std::size_t> shape, float start,
+                        float step) {
+   std::size_t n = 1;
+   for (auto d : shape) {
+      n *= d;
+   }
+   std::vector<float> data(n);
+   for (std::size_t i = 0; i < n; ++i) {
+      data[i] = start + step * static_cast<float>(i);
+   }
+   return RawTensor<float>(shape, data, DType::FLOAT32,
+                           Device{DeviceType::CPU, 0});
+}
+
+} // namespace
+
+TEST(InplaceTest, AddBroadcastsSourceIntoDestination) {
+   RawTensor<float> x = filled({2, 3}, 0.0f, 1.0f);
+   RawTensor<float> b = filled({3}, 10.0f, 10.0f);
+   const float *before = x.get_ptr();
+   x += b;
+   EXPECT_EQ(x.get_ptr(), before);
+   const std::vector<float> expect{10, 21, 32, 13, 24, 35};
+   EXPECT_EQ(std::vector<float>(x.begin(), x.end()), expect);
+}
+
+TEST(InplaceTest, DestinationIsNeverBroadcast) {
+   RawTensor<float> b = filled({3}, 0.0f, 1.0f);
+   RawTensor<float> x = filled({2, 3}, 0.0f, 1.0f);
+   EXPECT_THROW(b.sub_(x), std::runtime_error);
+}
+
+TEST(InplaceTest, AddcmulMatchesUnfused) {
+   RawTensor<float> x = filled({2, 3}, 1.0f, 1.0f);
+   RawTensor<float> t1 = filled({2, 3}, 0.5f, 0.5f);
+   RawTensor<float> t2 = filled({3}, 2.0f, 1.0f);
+   RawTensor<float> ref = x + t1 * t2 * 0.5f;
+   x.addcmul_(t1, t2, 0.5f);
+   for (std::size_t i = 0; i < ref.flat_size(); ++i) {
+      EXPECT_FLOAT_EQ(x.get_ptr()[i], ref.get_ptr()[i]);
+   }
+
+   RawTensor<float> y = filled({2, 3}, 1.0f, 1.0f);
+   RawTensor<float> t3 = filled({2, 3}, 2.0f, 2.0f);
+   y.addcdiv_(t1, t3, 2.0f);
+   for (std::size_t i = 0; i < y.flat_size(); ++i) {
+      EXPECT_FLOAT_EQ(y.get_ptr()[i], 1.0f + float(i) + 0.5f);
+   }
+}
+
+TEST(InplaceTest, OutMustMatchResultShape) {
+   RawTensor<float> a = filled({2, 3}, 0.0f, 1.0f);
+   RawTensor<float> b = filled({3}, 1.0f, 0.0f);
+   RawTensor<float> out = filled({2, 3}, 0.0f, 0.0f);
+   fusion::math::add(a, b, out);
+   EXPECT_FLOAT_EQ(out.get_ptr()[5], 6.0f);
+
+   RawTensor<float> wrong = filled({3, 2}, 0.0f, 0.0f);
+   EXPECT_THROW(fusion::math::add(a, b, wrong), std::runtime_error);
+
+   RawTensor<float> s = filled({3}, 0.0f, 0.0f);
+   fusion::math::sum(a, {0}, false, s);
+   EXPECT_FLOAT_EQ(s.get_ptr()[2], 7.0f);
+}
+
+TEST(InplaceTest, OutAliasingRules) {
+   RawTensor<float> a = filled({2, 3}, 0.0f, 1.0f);
+   RawTensor<float> b = filled({3}, 1.0f, 0.0f);
+   // out == a element for element: fine.
+   fusion::math::mul(a, b, a);
+   EXPECT_FLOAT_EQ(a.get_ptr()[4], 4.0f);
+   // Reductions and contractions may not write into their input at all.
+   RawTensor<float> sq = filled({3, 3}, 0.0f, 1.0f);
+   EXPECT_THROW(fusion::math::sum(a, {0, 1}, true, a), std::runtime_error);
+   EXPECT_THROW(fusion::math::linalg::matmul(sq, sq, sq), std::runtime_error);
+   // Same buffer and shape but transposed: elements would be read after
+   // they were overwritten.
+   EXPECT_THROW(sq.add_(sq.swapaxes_view(0, 1)), std::runtime_error);
+   EXPECT_THROW(fusion::math::add(sq.swapaxes_view(0, 1), sq, sq),
+                std::runtime_error);
+}
+
+TEST(InplaceTest, BroadcastBiasGradientIsReduced) {
+   EngineScope<float> scope;
+   scope.enter();
+   ADTensor<float> x(filled({4, 3}, 0.0f, 1.0f), true);
+   ADTensor<float> b(filled({3}, 0.0f, 0.0f), true);
+   ADTensor<float> y = (x + b).sum(kGlobalReduceAxis, false);
+   y.backward();
+   auto g = b.grad();
+   ASSERT_TRUE(g.has_value());
+   EXPECT_EQ(g->raw().shape(), (std::vector<std::size_t>{3}));
+   for (float v : g->raw()) {
+      EXPECT_FLOAT_EQ(v, 4.0f);
+   }
+}
+
+TEST(InplaceTest, RvalueOperandDonatesItsBuffer) {
+   RawTensor<float> a = filled({2, 3}, 0.0f, 1.0f);
+   RawTensor<float> b = filled({3}, 1.0f, 1.0f);
+   const float *buf = a.get_ptr();
+   RawTensor<float> r = (std::move(a) + b) * 2.0f;
+   EXPECT_EQ(r.get_ptr(), buf);
+   const std::vector<float> expect{2, 6, 10, 8, 12, 16};
+   EXPECT_EQ(std::vector<float>(r.begin(), r.end()), expect);
+
+   // A shared buffer is never written through.
+   RawTensor<float> c = filled({2, 3}, 0.0f, 1.0f);
+   RawTensor<float> alias = c;
+   RawTensor<float> s = std::move(c) + b;
+   EXPECT_NE(s.get_ptr(), alias.get_ptr());
+   EXPECT_FLOAT_EQ(alias.get_ptr()[5], 5.0f);
+
+   // A broadcast rvalue cannot hold the result; the other rvalue can.
+   RawTensor<float> x = filled({2, 3}, 0.0f, 1.0f);
+   const float *xbuf = x.get_ptr();
+   RawTensor<float> t = filled({3}, 1.0f, 0.0f) - std::move(x);
+   EXPECT_EQ(t.get_ptr(), xbuf);
+   EXPECT_FLOAT_EQ(t.get_ptr()[4], -3.0f);
+}
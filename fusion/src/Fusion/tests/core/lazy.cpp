@@ -0,0 +1,137 @@
+#include <cmath>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+#include "Fusion/core/Expr.hpp"
+#include "Fusion/core/Lazy.hpp"
+
+namespace {
+
+RawTensor<float> ramp(std::vector<std::size_t> shape, float start,
+                      float step) {
+   std::size_t n = 1;
+   for (auto d : shape) {
+      n *= d;
+   }
+   std::vector<float> data(n);
+   for (std::size_t i = 0; i < n; ++i) {
+      data[i] = start + step * static_cast<float>(i % 97);
+   }
+   return RawTensor<float>(shape, data, DType::FLOAT32,
+                           Device{DeviceType::CPU, 0});
+}
+
+} // namespace
+
+using fusion::lazy::defer;
+
+TEST(LazyTest, FusedChainMatchesEager) {
+   // Several tiles plus a ragged tail.
+   RawTensor<float> a = ramp({3, 1500}, 0.5f, 0.25f);
+   RawTensor<float> b = ramp({3, 1500}, 1.0f, 0.5f);
+   RawTensor<float> eager = ((a - b) * (a - b) + 1.0f).sqrt() / b;
+   auto d = defer(a) - b;
+   RawTensor<float> fused = ((d * d + 1.0f).sqrt() / b).materialize();
+   ASSERT_EQ(fused.shape(), eager.shape());
+   for (std::size_t i = 0; i < eager.flat_size(); ++i) {
+      EXPECT_FLOAT_EQ(fused.get_ptr()[i], eager.get_ptr()[i]);
+   }
+}
+
+TEST(LazyTest, ScalarOnTheLeftKeepsOperandOrder) {
+   RawTensor<float> x = ramp({8}, 1.0f, 1.0f);
+   RawTensor<float> r = (2.0f - defer(x) / 4.0f).materialize();
+   RawTensor<float> e = scalar_t(2.0f) - x / 4.0f;
+   for (std::size_t i = 0; i < x.flat_size(); ++i) {
+      EXPECT_FLOAT_EQ(r.get_ptr()[i], 2.0f - x.get_ptr()[i] / 4.0f);
+      EXPECT_FLOAT_EQ(e.get_ptr()[i], r.get_ptr()[i]);
+   }
+}
+
+TEST(LazyTest, GeneralBroadcastFallsBackToEager) {
+   RawTensor<float> x = ramp({4, 3}, 0.0f, 1.0f);
+   RawTensor<float> bias = ramp({3}, 10.0f, 1.0f);
+   RawTensor<float> r = (defer(x) * 2.0f + bias).materialize();
+   RawTensor<float> e = x * 2.0f + bias;
+   ASSERT_EQ(r.shape(), e.shape());
+   for (std::size_t i = 0; i < e.flat_size(); ++i) {
+      EXPECT_FLOAT_EQ(r.get_ptr()[i], e.get_ptr()[i]);
+   }
+}
+
+TEST(LazyTest, MeanIsFusedIntoTheTileLoop) {
+   RawTensor<float> y = ramp({70000}, -1.0f, 0.02f);
+   RawTensor<float> p = ramp({70000}, 0.5f, 0.01f);
+   RawTensor<float> eager = ((y - p) * (y - p)).mean({}, false);
+   auto d = defer(y) - p;
+   RawTensor<float> fused = (d * d).mean({}, false);
+   EXPECT_EQ(fused.shape(), eager.shape());
+   EXPECT_NEAR(fused.get_ptr()[0], eager.get_ptr()[0],
+               1e-5f * std::abs(eager.get_ptr()[0]));
+}
+
+TEST(LazyTest, SumOfEmptyTensorIsZero) {
+   RawTensor<float> e({0, 3}, DType::FLOAT32, Device{DeviceType::CPU, 0});
+   EXPECT_EQ((defer(e) * 2.0f + e).sum(), 0.0f);
+}
+
+// u = t * t frees t's slot once, so a and b below get distinct buffers.
+TEST(LazyTest, SquaredOperandReleasesItsSlotOnce) {
+   RawTensor<float> x = ramp({8}, 0.0f, 1.0f);
+   auto t = defer(x) + 1.0f;
+   auto u = t * t;
+   auto a = defer(x) + 2.0f;
+   auto b = defer(x) + 3.0f;
+   RawTensor<float> r = (u + a * b).materialize();
+   for (std::size_t i = 0; i < x.flat_size(); ++i) {
+      const float v = x.get_ptr()[i];
+      EXPECT_FLOAT_EQ(r.get_ptr()[i], (v + 1) * (v + 1) + (v + 2) * (v + 3));
+   }
+}
+
+TEST(ExprTest, TemplateChainMatchesEager) {
+   using namespace fusion::expr;
+   RawTensor<float> a = ramp({5, 700}, 0.5f, 0.25f);
+   RawTensor<float> b = ramp({5, 700}, 1.0f, 0.5f);
+   RawTensor<float> c = ramp({5, 700}, -2.0f, 0.1f);
+   auto e = ref(a) * b + c;
+   RawTensor<float> r = e;
+   RawTensor<float> s = sqrt(maximum(2.0f - ref(c) / b, 0.0f)).eval();
+   RawTensor<float> eager = a * b + c;
+   RawTensor<float> eager_s = (scalar_t(2.0f) - c / b).maximum(0.0f).sqrt();
+   for (std::size_t i = 0; i < eager.flat_size(); ++i) {
+      EXPECT_FLOAT_EQ(r.get_ptr()[i], eager.get_ptr()[i]);
+      EXPECT_FLOAT_EQ(s.get_ptr()[i], eager_s.get_ptr()[i]);
+   }
+}
+
+TEST(ExprTest, BroadcastUsesThePlan) {
+   using namespace fusion::expr;
+   RawTensor<float> x = ramp({4, 3}, 0.0f, 1.0f);
+   RawTensor<float> col = ramp({4, 1}, 1.0f, 1.0f);
+   RawTensor<float> row = ramp({3}, 10.0f, 1.0f);
+   RawTensor<float> r = ref(x) * col + row;
+   RawTensor<float> eager = x * col + row;
+   ASSERT_EQ(r.shape(), eager.shape());
+   for (std::size_t i = 0; i < eager.flat_size(); ++i) {
+      EXPECT_FLOAT_EQ(r.get_ptr()[i], eager.get_ptr()[i]);
+   }
+}
+
+TEST(ExprTest, StridedLeafIsReadThroughItsStrides) {
+   using namespace fusion::expr;
+   RawTensor<float> x = ramp({3, 4}, 0.0f, 1.0f);
+   RawTensor<float> y = ramp({4, 3}, 5.0f, 2.0f);
+   RawTensor<float> xt = x.swapaxes_view(0, 1);
+   RawTensor<float> r = ref(xt) * 2.0f + y;
+   ASSERT_EQ(r.shape(), y.shape());
+   for (std::size_t i = 0; i < 4; ++i) {
+      for (std::size_t j = 0; j < 3; ++j) {
+         EXPECT_FLOAT_EQ(r.get_ptr()[i * 3 + j],
+                         2.0f * x.get_ptr()[j * 4 + i] +
+                             y.get_ptr()[i * 3 + j]);
+      }
+   }
+}
@@ -0,0 +1,790 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+#include "Fusion/autodiff/ADTensor.hpp"
+#include "Fusion/autodiff/AutodiffBridge.hpp"
+#include "Fusion/cpu/blas/PackedGemm.hpp"
+#include "Fusion/cpu/blas/VectorKernels.hpp"
+#include "Fusion/ops/PackedWeight.hpp"
+
+namespace {
+
+RawTensor<float> filled(std::vector<std::size_t> shape, float start,
+                        float step) {
+   std::size_t n = 1;
+   for (auto d : shape) {
+      n *= d;
+   }
+   std::vector<float> data(n);
+   for (std::size_t i = 0; i < n; ++i) {
+      data[i] = start + step * static_cast<float>(i % 7) -
+                0.25f * static_cast<float>(i % 3);
+   }
+   return RawTensor<float>(shape, data, DType::FLOAT32,
+                           Device{DeviceType::CPU, 0});
+}
+
+void expect_near(const RawTensor<float> &a, const RawTensor<float> &b) {
+   ASSERT_EQ(a.shape(), b.shape());
+   for (std::size_t i = 0; i < a.flat_size(); ++i) {
+      EXPECT_NEAR(a.get_ptr()[i], b.get_ptr()[i], 1e-4f) << "at " << i;
+   }
+}
+
+// out[..., i, j] = sum_k a[..., i, k] * b[..., k, j] with numpy batch
+// broadcasting, one index at a time.
+RawTensor<float> naive_matmul(const RawTensor<float> &a,
+                              const RawTensor<float> &b) {
+   const auto &as = a.shape();
+   const auto &bs = b.shape();
+   const std::size_t M = as[as.size() - 2], K = as.back(), N = bs.back();
+   const std::size_t nd = std::max(as.size(), bs.size());
+   std::vector<std::size_t> shape(nd);
+   for (std::size_t d = 0; d + 2 < nd; ++d) {
+      const std::size_t da = d + as.size() >= nd ? as[d + as.size() - nd] : 1;
+      const std::size_t db = d + bs.size() >= nd ? bs[d + bs.size() - nd] : 1;
+      shape[d] = std::max(da, db);
+   }
+   shape[nd - 2] = M;
+   shape[nd - 1] = N;
+   std::size_t batch = 1;
+   for (std::size_t d = 0; d + 2 < nd; ++d) {
+      batch *= shape[d];
+   }
+   std::vector<float> out(batch * M * N, 0.0f);
+   for (std::size_t t = 0; t < batch; ++t) {
+      // Row-major batch offsets, with extent-1 or missing axes repeating.
+      std::size_t rem = t, oa = 0, ob = 0, sa = M * K, sb = K * N;
+      for (std::size_t d = nd - 2; d-- > 0;) {
+         const std::size_t i = rem % shape[d];
+         rem /= shape[d];
+         if (d + as.size() >= nd) {
+            const std::size_t e = as[d + as.size() - nd];
+            oa += (e == 1 ? 0 : i) * sa;
+            sa *= e;
+         }
+         if (d + bs.size() >= nd) {
+            const std::size_t e = bs[d + bs.size() - nd];
+            ob += (e == 1 ? 0 : i) * sb;
+            sb *= e;
+         }
+      }
+      for (std::size_t i = 0; i < M; ++i) {
+         for (std::size_t j = 0; j < N; ++j) {
+            float acc = 0.0f;
+            for (std::size_t k = 0; k < K; ++k) {
+               acc += a.get_ptr()[oa + i * K + k] * b.get_ptr()[ob + k * N + j];
+            }
+            out[t * M * N + i * N + j] = acc;
+         }
+      }
+   }
+   return RawTensor<float>(shape, out, DType::FLOAT32,
+                           Device{DeviceType::CPU, 0});
+}
+
+} // namespace
+
+TEST(GemmTest, TransposedViewsMapOntoBlasWithoutCopy) {
+   RawTensor<float> a = filled({3, 5, 4}, 0.5f, 0.25f);
+   RawTensor<float> b = filled({3, 6, 4}, -1.0f, 0.5f);
+   RawTensor<float> bT = b.swapaxes_view(-1, -2);
+   EXPECT_EQ(bT.get_ptr(), b.get_ptr());
+   EXPECT_FALSE(bT.is_contiguous());
+
+   EinsumBinding binding = fusion::math::linalg::make_matmul_binding(3, 3);
+   ContractionMeta meta = make_contraction_meta_einsum<float>(a, bT, binding);
+   ASSERT_TRUE(meta.plan.gemm_like);
+   EXPECT_FALSE(meta.plan.gemm.a_transpose);
+   EXPECT_TRUE(meta.plan.gemm.b_transpose);
+   EXPECT_EQ(meta.plan.gemm.ldb, 4);
+   EXPECT_EQ(meta.plan.gemm.b_bs, 24);
+
+   expect_near(a.matmul(bT), a.matmul(b.swapaxes(-1, -2)));
+
+   RawTensor<float> aT = a.swapaxes_view(-1, -2); // [3, 4, 5]
+   RawTensor<float> c = filled({3, 5, 2}, 2.0f, -0.5f);
+   expect_near(aT.matmul(c), a.swapaxes(-1, -2).matmul(c));
+   expect_near(aT.matmul(a), a.swapaxes(-1, -2).matmul(a));
+}
+
+TEST(GemmTest, MatMulBackwardMatchesExplicitTransposes) {
+   EngineScope<float> scope;
+   scope.enter();
+   RawTensor<float> xr = filled({2, 3, 4}, 0.0f, 0.5f);
+   RawTensor<float> yr = filled({2, 4, 5}, 1.0f, -0.25f);
+   ADTensor<float> x(xr, true);
+   ADTensor<float> y(yr, true);
+   ADTensor<float> z = x.matmul(y).sum(kGlobalReduceAxis, false);
+   z.backward();
+
+   RawTensor<float> ones({2, 3, 5}, std::vector<float>(30, 1.0f),
+                         DType::FLOAT32, Device{DeviceType::CPU, 0});
+   expect_near(x.grad()->raw(), ones.matmul(yr.swapaxes(-1, -2)));
+   expect_near(y.grad()->raw(), xr.swapaxes(-1, -2).matmul(ones));
+}
+
+TEST(GemmTest, SharedWeightFoldsIntoOneTallGemm) {
+   RawTensor<float> x = filled({4, 3, 5}, 0.5f, 0.25f);
+   RawTensor<float> w = filled({5, 6}, -1.0f, 0.5f);
+
+   EinsumBinding binding = fusion::math::linalg::make_matmul_binding(3, 2);
+   ContractionMeta meta = make_contraction_meta_einsum<float>(x, w, binding);
+   ASSERT_TRUE(meta.plan.gemm_like);
+   EXPECT_EQ(meta.plan.gemm.batch, 1u);
+   EXPECT_EQ(meta.plan.gemm.M, 12u);
+   EXPECT_TRUE(meta.plan.gemm.outer_batch.empty());
+
+   expect_near(x.matmul(w), naive_matmul(x, w));
+   expect_near(w.swapaxes(-1, -2).matmul(x.swapaxes_view(-1, -2)),
+               naive_matmul(w.swapaxes(-1, -2), x.swapaxes(-1, -2)));
+}
+
+TEST(GemmTest, BatchAxesBroadcastWithoutExpanding) {
+   RawTensor<float> a = filled({2, 1, 3, 4}, 0.5f, 0.25f);
+   RawTensor<float> b = filled({3, 4, 5}, -1.0f, 0.5f);
+
+   EinsumBinding binding = fusion::math::linalg::make_matmul_binding(4, 3);
+   ContractionMeta meta = make_contraction_meta_einsum<float>(a, b, binding);
+   ASSERT_TRUE(meta.plan.gemm_like);
+   EXPECT_EQ(meta.plan.gemm.batch, 3u);
+   EXPECT_EQ(meta.plan.gemm.a_bs, 0);
+   EXPECT_EQ(meta.plan.gemm.outer_batch.size(), 1u);
+
+   RawTensor<float> c = a.matmul(b);
+   EXPECT_EQ(c.shape(), (std::vector<std::size_t>{2, 3, 3, 5}));
+   expect_near(c, naive_matmul(a, b));
+   expect_near(b.matmul(filled({2, 1, 5, 2}, 1.0f, -0.5f)),
+               naive_matmul(b, filled({2, 1, 5, 2}, 1.0f, -0.5f)));
+}
+
+TEST(GemmTest, BroadcastWeightGradientIsSummedOverBatch) {
+   EngineScope<float> scope;
+   scope.enter();
+   RawTensor<float> xr = filled({4, 3, 5}, 0.0f, 0.5f);
+   RawTensor<float> wr = filled({5, 2}, 1.0f, -0.25f);
+   ADTensor<float> x(xr, true);
+   ADTensor<float> w(wr, true);
+   ADTensor<float> z = x.matmul(w).sum(kGlobalReduceAxis, false);
+   z.backward();
+
+   RawTensor<float> ones({12, 2}, std::vector<float>(24, 1.0f),
+                         DType::FLOAT32, Device{DeviceType::CPU, 0});
+   EXPECT_EQ(w.grad()->raw().shape(), wr.shape());
+   expect_near(w.grad()->raw(),
+               naive_matmul(xr.reshape({12, 5}).swapaxes(-1, -2), ones));
+   expect_near(x.grad()->raw(),
+               naive_matmul(ones.reshape({4, 3, 2}), wr.swapaxes(-1, -2)));
+}
+
+TEST(GemmTest, AddmmAccumulatesOnEveryPath) {
+   // Small kernel, BLAS (with and without an outer batch loop), a transposed
+   // view, gemv and dot: each adds into out instead of overwriting it.
+   auto check = [](const RawTensor<float> &a, const RawTensor<float> &b,
+                   const RawTensor<float> &product) {
+      RawTensor<float> out = filled(product.shape(), 2.0f, -0.75f);
+      const RawTensor<float> expected = out + product;
+      out.addmm_(a, b);
+      expect_near(out, expected);
+   };
+   const std::vector<std::pair<RawTensor<float>, RawTensor<float>>> cases = {
+       {filled({4, 4}, -1.0f, 0.5f), filled({4, 4}, 0.5f, -0.25f)},
+       {filled({48, 40}, -1.0f, 0.5f), filled({40, 36}, 0.5f, -0.25f)},
+       {filled({2, 1, 3, 4}, 0.5f, 0.25f), filled({3, 4, 5}, -1.0f, 0.5f)},
+       {filled({6, 5}, 0.25f, 0.5f), filled({5, 1}, -0.5f, 0.25f)},
+       {filled({1, 5}, 0.25f, 0.5f), filled({5, 1}, -0.5f, 0.25f)},
+   };
+   for (const auto &[a, b] : cases) {
+      check(a, b, naive_matmul(a, b));
+   }
+   const RawTensor<float> a = filled({40, 48}, -1.0f, 0.5f);
+   const RawTensor<float> b = filled({40, 36}, 0.5f, -0.25f);
+   check(a.swapaxes_view(-1, -2), b,
+         naive_matmul(fusion::math::linalg::swapaxes(a, -1, -2), b));
+}
+
+TEST(GemmTest, SharedWeightGradientAccumulatesInPlace) {
+   EngineScope<float> scope;
+   scope.enter();
+   // The sequential pass offers gradient buffers to MatMul's backward.
+   EngineContext<float>::get().set_parallel_backward(false);
+   RawTensor<float> x1r = filled({6, 5}, 0.0f, 0.5f);
+   RawTensor<float> x2r = filled({2, 3, 5}, 1.0f, -0.25f);
+   RawTensor<float> wr = filled({5, 4}, 0.5f, 0.125f);
+   ADTensor<float> x1(x1r, true);
+   ADTensor<float> x2(x2r, true);
+   ADTensor<float> w(wr, true);
+   ADTensor<float> z = x1.matmul(w).sum(kGlobalReduceAxis, false) +
+                       x2.matmul(w).sum(kGlobalReduceAxis, false) +
+                       x1.matmul(w).sum(kGlobalReduceAxis, false);
+   z.backward();
+
+   RawTensor<float> ones({6, 4}, std::vector<float>(24, 1.0f),
+                         DType::FLOAT32, Device{DeviceType::CPU, 0});
+   const RawTensor<float> x1t = fusion::math::linalg::swapaxes(x1r, 0, 1);
+   const RawTensor<float> x2t =
+       fusion::math::linalg::swapaxes(x2r.reshape({6, 5}), 0, 1);
+   expect_near(w.grad()->raw(), naive_matmul(x1t, ones) +
+                                    naive_matmul(x2t, ones) +
+                                    naive_matmul(x1t, ones));
+   const RawTensor<float> gx1 = naive_matmul(ones, wr.swapaxes(-1, -2));
+   expect_near(x1.grad()->raw(), gx1 + gx1);
+}
+
+TEST(GemmTest, BatchedStrategiesAgree) {
+   using fusion::blas::BatchedGemmStrategy;
+   const int m = 5, n = 3, k = 4;
+   const std::size_t batch = 6;
+   RawTensor<float> a = filled({batch, 5, 4}, 0.5f, 0.25f);
+   RawTensor<float> b = filled({batch, 4, 3}, -1.0f, 0.5f);
+   const RawTensor<float> ref = naive_matmul(a, b);
+
+   for (auto s :
+        {BatchedGemmStrategy::Sequential, BatchedGemmStrategy::OverBatch,
+         BatchedGemmStrategy::LibraryBatch}) {
+      std::vector<float> c(batch * m * n, -7.0f);
+      fusion::blas::batched_gemm_rowmajor<float>(
+          false, false, m, n, k, 1.0f, a.get_ptr(), k, m * k, b.get_ptr(), n,
+          k * n, 0.0f, c.data(), n, m * n, batch, s);
+      for (std::size_t i = 0; i < c.size(); ++i) {
+         EXPECT_NEAR(c[i], ref.get_ptr()[i], 1e-4f);
+      }
+   }
+
+   EXPECT_EQ(fusion::blas::choose_batched_gemm_strategy(512, 512, 512, 2, 8),
+             BatchedGemmStrategy::Sequential);
+   EXPECT_EQ(fusion::blas::choose_batched_gemm_strategy(64, 64, 64, 64, 1),
+             BatchedGemmStrategy::Sequential);
+   EXPECT_NE(fusion::blas::choose_batched_gemm_strategy(64, 64, 64, 64, 8),
+             BatchedGemmStrategy::Sequential);
+}
+
+TEST(GemmTest, PackedKernelMatchesReference) {
+   // Edge tiles in every dimension, two K blocks and several row blocks.
+   const int m = 157, n = 45, k = 300;
+   for (const bool ta : {false, true}) {
+      for (const bool tb : {false, true}) {
+         const std::size_t as = std::size_t(m) * k, bs = std::size_t(k) * n;
+         RawTensor<float> a = filled({as}, -0.5f, 0.125f);
+         RawTensor<float> b = filled({bs}, 0.25f, -0.125f);
+         const int lda = ta ? m : k;
+         const int ldb = tb ? k : n;
+         std::vector<float> c(std::size_t(m) * n, 1.0f);
+         fusion::blas::packed::gemm<float>(ta, tb, m, n, k, 2.0f, a.get_ptr(),
+                                           lda, b.get_ptr(), ldb, 0.5f,
+                                           c.data(), n);
+         for (int i = 0; i < m; i += 7) {
+            for (int j = 0; j < n; ++j) {
+               double acc = 0.0;
+               for (int p = 0; p < k; ++p) {
+                  const float av = ta ? a.get_ptr()[p * lda + i]
+                                      : a.get_ptr()[i * lda + p];
+                  const float bv = tb ? b.get_ptr()[j * ldb + p]
+                                      : b.get_ptr()[p * ldb + j];
+                  acc += double(av) * double(bv);
+               }
+               EXPECT_NEAR(c[std::size_t(i) * n + j], 2.0 * acc + 0.5, 1e-2)
+                   << "ta=" << ta << " tb=" << tb;
+            }
+         }
+      }
+   }
+}
+
+// A gemm run on this thread while an outer one still needs its packed B
+// (as run_pending_task can do inside parallel_for; here from the epilogue,
+// which must be the same type to share the instantiation's buffer) must not
+// repack into the outer call's buffer.
+namespace {
+
+struct NestedGemm {
+   const float *a;
+   const float *other;
+   float *inner;
+   int n;
+   int k;
+   bool *ran;
+
+   void operator()(std::size_t, std::size_t, std::size_t, std::size_t,
+                   float *, std::size_t) const {
+      if (!*ran) {
+         *ran = true;
+         fusion::blas::packed::gemm<float>(false, false, 8, n, k, 1.0f, a, k,
+                                           other, n, 0.0f, inner, n, *this);
+      }
+   }
+};
+
+} // namespace
+
+TEST(GemmTest, NestedPackedGemmKeepsOuterPanels) {
+   const int m = 400, n = 45, k = 60;
+   RawTensor<float> a = filled({std::size_t(m) * k}, -0.5f, 0.125f);
+   RawTensor<float> b = filled({std::size_t(k) * n}, 0.25f, -0.125f);
+   RawTensor<float> other = filled({std::size_t(k) * n}, 3.0f, 1.0f);
+   std::vector<float> inner(std::size_t(8) * n);
+   bool ran = false;
+   const NestedGemm epi{a.get_ptr(), other.get_ptr(), inner.data(), n, k,
+                        &ran};
+   fusion::parallel::ParallelRegionGuard serial;
+   std::vector<float> c(std::size_t(m) * n);
+   fusion::blas::packed::gemm<float>(false, false, m, n, k, 1.0f, a.get_ptr(),
+                                     k, b.get_ptr(), n, 0.0f, c.data(), n,
+                                     epi);
+   ASSERT_TRUE(ran);
+   for (int i = 0; i < m; i += 5) {
+      for (int j = 0; j < n; ++j) {
+         double acc = 0.0;
+         for (int p = 0; p < k; ++p) {
+            acc += double(a.get_ptr()[i * k + p]) *
+                   double(b.get_ptr()[p * n + j]);
+         }
+         EXPECT_NEAR(c[std::size_t(i) * n + j], acc, 1e-3) << "at " << i;
+      }
+   }
+}
+
+// The same for gemm_widened: a nested call from the epilogue must not
+// overwrite the outer call's fp32 tile before it is narrowed into C.
+namespace {
+
+struct NestedWidenedGemm {
+   const fusion::bfloat16 *a;
+   const fusion::bfloat16 *other;
+   fusion::bfloat16 *inner;
+   int n;
+   int k;
+   bool *ran;
+
+   void operator()(std::size_t, std::size_t, std::size_t, std::size_t,
+                   float *, std::size_t) const {
+      if (!*ran) {
+         *ran = true;
+         fusion::blas::packed::gemm_widened<float>(
+             false, false, 8, n, k, 1.0f, a, k, other, n, 0.0f, inner, n,
+             *this);
+      }
+   }
+};
+
+} // namespace
+
+TEST(GemmTest, NestedWidenedGemmKeepsOuterTile) {
+   using fusion::bfloat16;
+   const int m = 40, n = 45, k = 60;
+   const RawTensor<bfloat16> a =
+       filled({std::size_t(m) * k}, -0.5f, 0.125f).astype<bfloat16>();
+   const RawTensor<bfloat16> b =
+       filled({std::size_t(k) * n}, 0.25f, -0.125f).astype<bfloat16>();
+   const RawTensor<bfloat16> other =
+       filled({std::size_t(k) * n}, 3.0f, 1.0f).astype<bfloat16>();
+   std::vector<bfloat16> inner(std::size_t(8) * n);
+   bool ran = false;
+   const NestedWidenedGemm epi{a.get_ptr(), other.get_ptr(), inner.data(),
+                               n, k, &ran};
+   fusion::parallel::ParallelRegionGuard serial;
+   std::vector<bfloat16> c(std::size_t(m) * n);
+   fusion::blas::packed::gemm_widened<float>(false, false, m, n, k, 1.0f,
+                                             a.get_ptr(), k, b.get_ptr(), n,
+                                             0.0f, c.data(), n, epi);
+   ASSERT_TRUE(ran);
+   for (int i = 0; i < m; ++i) {
+      for (int j = 0; j < n; ++j) {
+         double acc = 0.0;
+         for (int p = 0; p < k; ++p) {
+            acc += double(float(a.get_ptr()[i * k + p])) *
+                   double(float(b.get_ptr()[p * n + j]));
+         }
+         EXPECT_NEAR(float(c[std::size_t(i) * n + j]), acc,
+                     0.01 * std::max(1.0, std::abs(acc)))
+             << "at " << i << ", " << j;
+      }
+   }
+}
+
+TEST(GemmTest, SmallShapesBypassBlas) {
+   // Fixed-size kernels, the generic one, transposed views and a batch.
+   for (const std::size_t n : {2, 3, 4, 5, 8, 16, 32}) {
+      RawTensor<float> a = filled({n, n}, -1.0f, 0.5f);
+      RawTensor<float> b = filled({n, n}, 0.5f, -0.25f);
+      expect_near(a.matmul(b), naive_matmul(a, b));
+   }
+   RawTensor<float> a = filled({7, 3}, -1.0f, 0.5f);
+   RawTensor<float> b = filled({5, 3}, 0.5f, -0.25f);
+   expect_near(a.matmul(b.swapaxes_view(-1, -2)),
+               naive_matmul(a, fusion::math::linalg::swapaxes(b, -1, -2)));
+   RawTensor<float> x = filled({64, 4, 6}, 0.25f, 0.5f);
+   RawTensor<float> w = filled({64, 6, 4}, -0.5f, 0.25f);
+   expect_near(x.matmul(w), naive_matmul(x, w));
+}
+
+TEST(GemmTest, VectorShapesUseLevel12Plans) {
+   auto kind_of = [](const RawTensor<float> &a, const RawTensor<float> &b) {
+      EinsumBinding binding = fusion::math::linalg::make_matmul_binding(
+          a.shape().size(), b.shape().size());
+      return make_contraction_meta_einsum<float>(a, b, binding).plan.kind;
+   };
+   RawTensor<float> m = filled({40, 50}, 0.5f, 0.25f);
+   RawTensor<float> col = filled({50, 1}, -1.0f, 0.5f);
+   RawTensor<float> row = filled({1, 40}, 1.0f, -0.25f);
+   RawTensor<float> one = filled({1, 1}, 2.0f, 0.0f);
+
+   EXPECT_EQ(kind_of(m, col), ContractionKind::Gemv);
+   expect_near(m.matmul(col), naive_matmul(m, col));
+   EXPECT_EQ(kind_of(row, m), ContractionKind::Gemv);
+   expect_near(row.matmul(m), naive_matmul(row, m));
+   RawTensor<float> mT = m.swapaxes_view(-1, -2);
+   expect_near(mT.matmul(filled({40, 1}, 0.5f, 0.5f)),
+               naive_matmul(m.swapaxes(-1, -2), filled({40, 1}, 0.5f, 0.5f)));
+
+   RawTensor<float> a = filled({3, 1, 100}, 0.5f, 0.25f);
+   RawTensor<float> b = filled({3, 100, 1}, -1.0f, 0.5f);
+   EXPECT_EQ(kind_of(a, b), ContractionKind::Dot);
+   expect_near(a.matmul(b), naive_matmul(a, b));
+
+   RawTensor<float> tall = filled({60, 1}, 0.5f, 0.25f);
+   EXPECT_EQ(kind_of(tall, one), ContractionKind::Axpy);
+   expect_near(tall.matmul(one), naive_matmul(tall, one));
+   RawTensor<float> wide = filled({1, 60}, 0.5f, 0.25f);
+   expect_near(one.matmul(wide), naive_matmul(one, wide));
+}
+
+TEST(GemmTest, NativeGemvMatchesReference) {
+   const std::size_t rows = 37, cols = 70;
+   RawTensor<float> a = filled({rows * cols}, 0.5f, 0.25f);
+   RawTensor<float> x = filled({2 * std::max(rows, cols)}, -1.0f, 0.5f);
+   for (const bool trans : {false, true}) {
+      const std::size_t nx = trans ? rows : cols;
+      const std::size_t ny = trans ? cols : rows;
+      std::vector<float> y(ny, 1.0f);
+      // Every other element of x, to exercise the gather.
+      fusion::blas::native::gemv<float>(trans, rows, cols, 2.0f, a.get_ptr(),
+                                        cols, x.get_ptr(), 2, 0.5f, y.data(),
+                                        1);
+      for (std::size_t j = 0; j < ny; ++j) {
+         double acc = 0.0;
+         for (std::size_t i = 0; i < nx; ++i) {
+            const float av = trans ? a.get_ptr()[i * cols + j]
+                                   : a.get_ptr()[j * cols + i];
+            acc += double(av) * double(x.get_ptr()[2 * i]);
+         }
+         EXPECT_NEAR(y[j], 2.0 * acc + 0.5, 1e-2) << "trans=" << trans;
+      }
+   }
+}
+
+namespace {
+
+// Scalar act(z) and act'(z) for the linear() tests.
+float act_ref(Activation act, float z) {
+   switch (act) {
+   case Activation::ReLU:
+      return z > 0.0f ? z : 0.0f;
+   case Activation::GELU:
+      return 0.5f * z *
+             (1.0f + std::tanh(0.7978845608f * (z + 0.044715f * z * z * z)));
+   case Activation::Tanh:
+      return std::tanh(z);
+   case Activation::None:
+      break;
+   }
+   return z;
+}
+
+float act_grad_ref(Activation act, float z) {
+   switch (act) {
+   case Activation::ReLU:
+      return z > 0.0f ? 1.0f : 0.0f;
+   case Activation::GELU: {
+      const float c = 0.7978845608f;
+      const float t = std::tanh(c * (z + 0.044715f * z * z * z));
+      return 0.5f * (1.0f + t) +
+             0.5f * z * (1.0f - t * t) * c * (1.0f + 3.0f * 0.044715f * z * z);
+   }
+   case Activation::Tanh:
+      return 1.0f - std::tanh(z) * std::tanh(z);
+   case Activation::None:
+      break;
+   }
+   return 1.0f;
+}
+
+// x W^T + b, unfused.
+RawTensor<float> affine_ref(const RawTensor<float> &x,
+                            const RawTensor<float> &w,
+                            const RawTensor<float> &b) {
+   RawTensor<float> z =
+       naive_matmul(x, fusion::math::linalg::swapaxes(w, 0, 1));
+   const std::size_t units = w.shape()[0];
+   for (std::size_t i = 0; i < z.flat_size(); ++i) {
+      z.get_ptr()[i] += b.get_ptr()[i % units];
+   }
+   return z;
+}
+
+} // namespace
+
+TEST(GemmTest, LinearFusesBiasAndActivation) {
+   // Small-kernel, BLAS-panel and packed shapes; x rank 2 and 3.
+   const std::vector<std::vector<std::size_t>> x_shapes = {
+       {4, 3}, {300, 70}, {2, 150, 70}};
+   for (const auto &xs : x_shapes) {
+      const std::size_t in = xs.back();
+      const std::size_t units = in == 3 ? 5 : 90;
+      RawTensor<float> x = filled(xs, -1.0f, 0.5f);
+      RawTensor<float> w = filled({units, in}, 0.25f, -0.0625f);
+      RawTensor<float> b = filled({units}, -0.5f, 0.25f);
+      const RawTensor<float> z =
+          affine_ref(x.reshape({x.flat_size() / in, in}), w, b);
+      for (const Activation act : {Activation::None, Activation::ReLU,
+                                   Activation::GELU, Activation::Tanh}) {
+         RawTensor<float> pre;
+         RawTensor<float> y = fusion::math::linalg::linear(x, w, &b, act, &pre);
+         std::vector<std::size_t> ys = xs;
+         ys.back() = units;
+         ASSERT_EQ(y.shape(), ys);
+         for (std::size_t i = 0; i < y.flat_size(); ++i) {
+            const float zi = z.get_ptr()[i];
+            EXPECT_NEAR(pre.get_ptr()[i], zi, 1e-3f);
+            EXPECT_NEAR(y.get_ptr()[i], act_ref(act, zi), 1e-3f) << i;
+         }
+      }
+   }
+
+   // No bias, and W read through a transposed view of W^T.
+   RawTensor<float> x = filled({6, 4}, 0.5f, 0.25f);
+   RawTensor<float> wt = filled({4, 7}, -0.5f, 0.25f);
+   expect_near(x.linear(wt.swapaxes_view(0, 1)), naive_matmul(x, wt));
+}
+
+TEST(GemmTest, LinearBackwardFusesActivationDerivative) {
+   for (const Activation act :
+        {Activation::None, Activation::ReLU, Activation::GELU,
+         Activation::Tanh}) {
+      EngineScope<float> scope;
+      scope.enter();
+      RawTensor<float> xr = filled({2, 3, 4}, -1.0f, 0.5f);
+      RawTensor<float> wr = filled({5, 4}, 0.25f, -0.125f);
+      RawTensor<float> br = filled({5}, -0.5f, 0.25f);
+      ADTensor<float> x(xr, true);
+      ADTensor<float> w(wr, true);
+      ADTensor<float> b(br, true);
+      ADTensor<float> loss = x.linear(w, b, act).sum(kGlobalReduceAxis, false);
+      loss.backward();
+
+      // dz = act'(z) for an upstream gradient of ones.
+      const RawTensor<float> x2 = xr.reshape({6, 4});
+      RawTensor<float> dz = affine_ref(x2, wr, br);
+      for (std::size_t i = 0; i < dz.flat_size(); ++i) {
+         dz.get_ptr()[i] = act_grad_ref(act, dz.get_ptr()[i]);
+      }
+      expect_near(x.grad()->raw(), naive_matmul(dz, wr).reshape({2, 3, 4}));
+      expect_near(w.grad()->raw(),
+                  naive_matmul(fusion::math::linalg::swapaxes(dz, 0, 1), x2));
+      expect_near(b.grad()->raw(),
+                  dz.sum(std::vector<std::size_t>{0}, false));
+   }
+}
+
+TEST(GemmTest, PackedWeightMatchesAndFollowsWrites) {
+   using fusion::math::linalg::PackedWeight;
+   // N is not a multiple of NR and K spans two KC blocks.
+   RawTensor<float> x = filled({2, 33, 300}, -0.5f, 0.25f);
+   RawTensor<float> w = filled({300, 45}, 0.25f, -0.125f);
+   RawTensor<float> kernel = filled({45, 300}, 0.5f, -0.25f);
+   RawTensor<float> b = filled({45}, -1.0f, 0.5f);
+   const PackedWeight<float> pw(w);
+   const PackedWeight<float> pk(kernel, true);
+   EXPECT_EQ(pk.rows(), 300u);
+   EXPECT_EQ(pk.cols(), 45u);
+
+   expect_near(x.matmul(pw), x.matmul(w));
+   expect_near(x.linear(pk, b, Activation::ReLU),
+               x.linear(kernel, b, Activation::ReLU));
+   // A transposed view of the weight is packed without a copy first.
+   const PackedWeight<float> pv(kernel.swapaxes_view(0, 1));
+   expect_near(x.matmul(pv), x.linear(kernel));
+   // Tiny shapes read the weight directly.
+   RawTensor<float> small_w = filled({4, 4}, 0.25f, 0.5f);
+   RawTensor<float> small_x = filled({3, 4}, 1.0f, -0.5f);
+   expect_near(small_x.matmul(PackedWeight<float>(small_w)),
+               naive_matmul(small_x, small_w));
+
+   // A write through the tensor ops makes the packing stale; the next use
+   // repacks.
+   ASSERT_TRUE(pk.is_current());
+   const std::shared_ptr<const float> held = pk.data();
+   const float first = held.get()[0];
+   kernel.mul_(2.0f);
+   EXPECT_FALSE(pk.is_current());
+   expect_near(x.linear(pk, b), x.linear(kernel, b));
+   EXPECT_TRUE(pk.is_current());
+   // The repack went to a new buffer; panels taken before stay intact.
+   EXPECT_NE(pk.data().get(), held.get());
+   EXPECT_EQ(held.get()[0], first);
+}
+
+TEST(GemmTest, DoublePrecisionRunsEveryPath) {
+   const Device cpu{DeviceType::CPU, 0};
+   auto make = [&](std::vector<std::size_t> shape, double start) {
+      std::size_t n = 1;
+      for (auto d : shape) {
+         n *= d;
+      }
+      std::vector<double> data(n);
+      for (std::size_t i = 0; i < n; ++i) {
+         data[i] = start + 0.125 * static_cast<double>(i % 11) -
+                   0.5 * static_cast<double>(i % 3);
+      }
+      return RawTensor<double>(shape, data, DType::FLOAT64, cpu);
+   };
+   auto reference = [](const RawTensor<double> &a, const RawTensor<double> &b) {
+      const std::size_t M = a.shape()[0], K = a.shape()[1], N = b.shape()[1];
+      std::vector<double> out(M * N, 0.0);
+      for (std::size_t i = 0; i < M; ++i) {
+         for (std::size_t k = 0; k < K; ++k) {
+            for (std::size_t j = 0; j < N; ++j) {
+               out[i * N + j] +=
+                   a.get_ptr()[i * K + k] * b.get_ptr()[k * N + j];
+            }
+         }
+      }
+      return out;
+   };
+   auto expect_close = [](const double *a, const std::vector<double> &b) {
+      for (std::size_t i = 0; i < b.size(); ++i) {
+         EXPECT_NEAR(a[i], b[i], 1e-9) << "at " << i;
+      }
+   };
+
+   EXPECT_EQ(zeros<double>({2}, cpu).dtype(), DType::FLOAT64);
+
+   // GEMM (past the small kernel), its transposed view, GEMV and the dot.
+   RawTensor<double> a = make({70, 90}, -1.0);
+   RawTensor<double> b = make({90, 50}, 0.5);
+   expect_close(a.matmul(b).get_ptr(), reference(a, b));
+   RawTensor<double> bt = b.swapaxes(0, 1);
+   expect_close(a.matmul(bt.swapaxes_view(0, 1)).get_ptr(), reference(a, b));
+   RawTensor<double> v = make({90, 1}, 0.25);
+   expect_close(a.matmul(v).get_ptr(), reference(a, v));
+
+   // Fused linear and the element-wise kernels.
+   RawTensor<double> bias = make({50}, 1.0);
+   RawTensor<double> y = a.linear(bt, bias, Activation::ReLU);
+   std::vector<double> ref = reference(a, b);
+   for (std::size_t i = 0; i < ref.size(); ++i) {
+      ref[i] = std::max(ref[i] + bias.get_ptr()[i % 50], 0.0);
+   }
+   expect_close(y.get_ptr(), ref);
+   RawTensor<double> e = (a * 0.5 + 1.0).exp();
+   for (std::size_t i = 0; i < a.flat_size(); ++i) {
+      EXPECT_NEAR(e.get_ptr()[i], std::exp(a.get_ptr()[i] * 0.5 + 1.0), 1e-12);
+   }
+
+   // Reverse mode through a double graph, on the tape Python's grad_tape
+   // opens.
+   GradTape tape;
+   tape.enter();
+   ASSERT_TRUE(EngineContext<double>::has());
+   ADTensor<double> x(a, true);
+   ADTensor<double> w(b, true);
+   x.matmul(w).sum(kGlobalReduceAxis, false).backward();
+   const std::vector<double> gx =
+       reference(RawTensor<double>({70, 50}, std::vector<double>(3500, 1.0),
+                                   DType::FLOAT64, cpu),
+                 bt);
+   expect_close(x.grad()->raw().get_ptr(), gx);
+}
+
+// bfloat16/float16 storage: every path loads 16-bit data and accumulates in
+// fp32, so results match the float computation on the same (exactly
+// representable) inputs to within one 16-bit rounding of the output.
+template <typename H> void expect_half_matches_float() {
+   const Device cpu{DeviceType::CPU, 0};
+   const float tol = 2.0f * float(std::numeric_limits<H>::epsilon());
+   auto expect_close = [&](const RawTensor<H> &got,
+                           const RawTensor<float> &want) {
+      ASSERT_EQ(got.shape(), want.shape());
+      for (std::size_t i = 0; i < want.flat_size(); ++i) {
+         const float w = want.get_ptr()[i];
+         EXPECT_NEAR(float(got.get_ptr()[i]), w,
+                     tol * std::max(1.0f, std::abs(w)))
+             << "at " << i;
+      }
+   };
+
+   // Multiples of 1/8 below 4: exact in both formats.
+   RawTensor<float> a = filled({70, 90}, -1.0f, 0.125f);
+   RawTensor<float> b = filled({90, 50}, 0.5f, 0.125f);
+   const RawTensor<H> ah = a.astype<H>();
+   const RawTensor<H> bh = b.astype<H>();
+   EXPECT_EQ(ah.dtype(), dtype_of<H>());
+   EXPECT_EQ(get_dtype_size(ah.dtype()), 2u);
+   expect_near(ah.template astype<float>(), a);
+
+   // GEMM, its transposed view, GEMV, the small kernel and fused linear.
+   expect_close(ah.matmul(bh), a.matmul(b));
+   const RawTensor<H> bth = bh.swapaxes(0, 1);
+   expect_close(ah.matmul(bth.swapaxes_view(0, 1)), a.matmul(b));
+   RawTensor<float> v = filled({90, 1}, 0.25f, 0.125f);
+   expect_close(ah.matmul(v.astype<H>()), a.matmul(v));
+   RawTensor<float> s = filled({8, 8}, 0.5f, 0.125f);
+   expect_close(s.astype<H>().matmul(s.astype<H>()), s.matmul(s));
+   RawTensor<float> bias = filled({50}, 1.0f, 0.125f);
+   expect_close(ah.linear(bth, bias.astype<H>(), Activation::ReLU),
+                a.linear(b.swapaxes(0, 1), bias, Activation::ReLU));
+   // The bias is added to the fp32 sums (exact here), so x W^T + b is the
+   // fp32 result rounded once, not the 16-bit product rounded again.
+   const RawTensor<float> affine = a.linear(b.swapaxes(0, 1), bias);
+   const RawTensor<H> affine_h = ah.linear(bth, bias.astype<H>());
+   for (std::size_t i = 0; i < affine.flat_size(); ++i) {
+      EXPECT_EQ(affine_h.get_ptr()[i].bits, H(affine.get_ptr()[i]).bits)
+          << "at " << i;
+   }
+
+   // Element-wise kernels with a broadcast scalar, and reductions.
+   expect_close(ah * ah, a * a);
+   expect_close((ah * 0.5f + 1.0f).exp(), (a * 0.5f + 1.0f).exp());
+   expect_close(bh.sum(0, false), b.sum(0, false));
+   expect_close(bh.sum(1, false), b.sum(1, false));
+   expect_close(ah.var({}, false), a.var({}, false));
+
+   // 16-bit running sums of ones stall at 256 (bfloat16) and 2048 (float16);
+   // fp32 accumulation gets this one right up to the final rounding.
+   const std::size_t n = 20000;
+   RawTensor<H> ones({n}, dtype_of<H>(), cpu);
+   std::fill(ones.get_ptr(), ones.get_ptr() + n, H(1.0f));
+   EXPECT_NEAR(float(ones.sum(kGlobalReduceAxis, false).get_ptr()[0]),
+               float(n), tol * float(n));
+}
+
+TEST(GemmTest, HalfPrecisionAccumulatesInFloat) {
+   expect_half_matches_float<fusion::bfloat16>();
+   expect_half_matches_float<fusion::float16>();
+}
+
+// Transposed views are public, so element-wise ops and reductions must read
+// them through their strides like matmul does.
+TEST(GemmTest, ElementwiseOpsReadTransposedViewsThroughStrides) {
+   RawTensor<float> a = filled({5, 4}, 0.5f, 0.25f);
+   RawTensor<float> b = filled({4, 5}, -1.0f, 0.5f);
+   RawTensor<float> aT = a.swapaxes_view(0, 1);
+   const RawTensor<float> at = a.swapaxes(0, 1);
+   expect_near(aT + b, at + b);
+   expect_near(b * aT, b * at);
+   expect_near(aT.exp(), at.exp());
+   expect_near(aT.sum(0, false), at.sum(0, false));
+   expect_near(aT.sum(1, true), at.sum(1, true));
+   expect_near(aT.sum(kGlobalReduceAxis, false),
+               at.sum(kGlobalReduceAxis, false));
+   expect_near(aT.mean({0, 1}, false), at.mean({0, 1}, false));
+   expect_near(aT.var({0}, false), at.var({0}, false));
+   expect_near(aT.var({}, false), at.var({}, false));
+}
@@ -0,0 +1,71 @@
+#include <atomic>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Fusion/core/MPMCQueue.hpp"
+
+TEST(MPMCQueueTest, FifoOrderSingleThread) {
+   MPMCQueue<int> q(8);
+   EXPECT_TRUE(q.empty());
+   for (int i = 0; i < 5; ++i) {
+      q.push(i);
+   }
+   int v = -1;
+   for (int i = 0; i < 5; ++i) {
+      ASSERT_TRUE(q.try_pop(v));
+      EXPECT_EQ(v, i);
+   }
+   EXPECT_FALSE(q.try_pop(v));
+   EXPECT_EQ(q.try_pop(), nullptr);
+}
+
+TEST(MPMCQueueTest, BoundedCapacity) {
+   MPMCQueue<int> q(4);
+   for (int i = 0; i < 4; ++i) {
+      EXPECT_TRUE(q.try_push(i));
+   }
+   EXPECT_FALSE(q.try_push(99));
+   EXPECT_EQ(*q.wait_and_pop(), 0);
+   EXPECT_TRUE(q.try_push(4));
+}
+
+TEST(MPMCQueueTest, RejectsNonPowerOfTwoCapacity) {
+   EXPECT_THROW(MPMCQueue<int>(6), std::invalid_argument);
+}
+
+TEST(MPMCQueueTest, ConcurrentProducersConsumers) {
+   constexpr int kThreads = 4;
+   constexpr long kPerProducer = 20000;
+   MPMCQueue<long> q(64);
+   std::atomic<long> sum{0};
+   std::atomic<long> popped{0};
+
+   std::vector<std::thread> threads;
+   for (int p = 0; p < kThreads; ++p) {
+      threads.emplace_back([&] {
+         for (long i = 1; i <= kPerProducer; ++i) {
+            q.push(i);
+         }
+      });
+   }
+   for (int c = 0; c < kThreads; ++c) {
+      threads.emplace_back([&] {
+         long v;
+         while (popped.load() < kThreads * kPerProducer) {
+            if (q.try_pop(v)) {
+               sum += v;
+               ++popped;
+            } else {
+               std::this_thread::yield();
+            }
+         }
+      });
+   }
+   for (auto &t : threads) {
+      t.join();
+   }
+   EXPECT_EQ(sum.load(), kThreads * kPerProducer * (kPerProducer + 1) / 2);
+}
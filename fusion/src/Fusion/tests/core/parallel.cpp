@@ -0,0 +1,106 @@
+#include <atomic>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "Fusion/core/Parallel.h"
+
+using namespace fusion::parallel;
+
+TEST(ParallelTest, ParallelForCoversRangeOnce) {
+   set_num_threads(4);
+   std::vector<int> hits(1000, 0);
+   parallel_for(0, hits.size(), 16, [&](std::size_t lo, std::size_t hi) {
+      for (std::size_t i = lo; i < hi; ++i) {
+         ++hits[i];
+      }
+   });
+   EXPECT_EQ(std::accumulate(hits.begin(), hits.end(), 0), 1000);
+   for (int h : hits) {
+      EXPECT_EQ(h, 1);
+   }
+}
+
+TEST(ParallelTest, NestedRegionRunsSerially) {
+   set_num_threads(4);
+   std::atomic<int> nested_chunks{0};
+   parallel_for(0, 4, 1, [&](std::size_t, std::size_t) {
+      EXPECT_TRUE(in_parallel_region());
+      EXPECT_EQ(max_concurrency(), 1u);
+      parallel_for(0, 64, 1,
+                   [&](std::size_t, std::size_t) { ++nested_chunks; });
+   });
+   // Every nested call collapses into a single chunk on its own thread.
+   EXPECT_EQ(nested_chunks.load(), 4);
+   EXPECT_FALSE(in_parallel_region());
+}
+
+TEST(ParallelTest, RegionGuardSetsBudget) {
+   set_num_threads(8);
+   {
+      ParallelRegionGuard guard(2);
+      EXPECT_EQ(max_concurrency(), 2u);
+   }
+   EXPECT_EQ(max_concurrency(), 8u);
+}
+
+TEST(ParallelTest, ExceptionPropagatesToCaller) {
+   set_num_threads(4);
+   EXPECT_THROW(parallel_for(0, 100, 1,
+                             [](std::size_t lo, std::size_t) {
+                                if (lo == 0) {
+                                   throw std::runtime_error("boom");
+                                }
+                             }),
+                std::runtime_error);
+}
+
+TEST(ParallelTest, SingleThreadPoolRunsInline) {
+   set_num_threads(1);
+   EXPECT_EQ(thread_pool().size(), 0u);
+   int ran = 0;
+   thread_pool().submit([&] { ++ran; });
+   EXPECT_EQ(ran, 1);
+}
+
+// Scopes closed out of order must not leave BLAS on an inner scope's count.
+TEST(ParallelTest, OverlappingBlasScopesRestoreOuterCount) {
+   const std::size_t outer = get_blas_num_threads();
+   std::optional<BlasThreadScope> a(std::in_place, 3);
+   std::optional<BlasThreadScope> b(std::in_place, 2);
+   EXPECT_LE(get_blas_num_threads(), 2u);
+   a.reset();
+   b.reset();
+   EXPECT_EQ(get_blas_num_threads(), outer);
+}
+
+TEST(ParallelTest, ResizingUnderRunningWorkThrows) {
+   set_num_threads(4);
+   parallel_for(0, 4, 1, [](std::size_t lo, std::size_t) {
+      if (lo == 0) {
+         EXPECT_THROW(set_num_threads(2), std::runtime_error);
+         EXPECT_THROW(set_cpu_affinity({0}), std::runtime_error);
+      }
+   });
+   EXPECT_EQ(get_num_threads(), 4u);
+   set_num_threads(2);
+   EXPECT_EQ(get_num_threads(), 2u);
+}
+
+// A count set while a scope is open is the one left behind when it closes.
+TEST(ParallelTest, BlasCountSetInsideAScopeOutlivesIt) {
+   const std::size_t outer = get_blas_num_threads();
+   set_blas_num_threads(2);
+   const std::size_t two = get_blas_num_threads(); // 1 without OpenBLAS
+   set_blas_num_threads(1);
+   {
+      BlasThreadScope scope(1);
+      set_blas_num_threads(2);
+      EXPECT_EQ(get_blas_num_threads(), 1u);
+   }
+   EXPECT_EQ(get_blas_num_threads(), two);
+   set_blas_num_threads(outer);
+}
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+#include "Fusion/ops/Quantize.hpp"
+
+using namespace fusion::math::quant;
+
+namespace {
+
+RawTensor<float> wave(std::vector<std::size_t> shape, float freq, float amp,
+                      float offset) {
+   std::size_t n = 1;
+   for (auto d : shape) {
+      n *= d;
+   }
+   std::vector<float> data(n);
+   for (std::size_t i = 0; i < n; ++i) {
+      data[i] = offset + amp * std::sin(freq * static_cast<float>(i) + 0.3f);
+   }
+   return RawTensor<float>(shape, data, DType::FLOAT32,
+                           Device{DeviceType::CPU, 0});
+}
+
+} // namespace
+
+TEST(QuantizeTest, RoundTripIsWithinHalfAStep) {
+   const RawTensor<float> x = wave({6, 50}, 0.37f, 2.0f, 0.5f);
+
+   const QuantizedTensor t = quantize(x, QuantScheme::Affine);
+   EXPECT_EQ(t.data().dtype(), DType::INT8);
+   const RawTensor<float> back = dequantize(t);
+   const float step = t.params().scale[0];
+   for (std::size_t i = 0; i < x.flat_size(); ++i) {
+      EXPECT_LE(std::abs(back.get_ptr()[i] - x.get_ptr()[i]),
+                0.5f * step + 1e-6f)
+          << "at " << i;
+   }
+
+   // Per row, symmetric: each row gets its own scale and zero stays exact.
+   const QuantizedTensor c = quantize(x, QuantScheme::Symmetric, 0);
+   ASSERT_EQ(c.params().scale.size(), 6u);
+   const RawTensor<float> back_c = dequantize(c);
+   for (std::size_t i = 0; i < x.flat_size(); ++i) {
+      const float row_step = c.params().scale[i / 50];
+      EXPECT_EQ(c.params().zero_point[i / 50], 0);
+      EXPECT_LE(std::abs(back_c.get_ptr()[i] - x.get_ptr()[i]),
+                0.5f * row_step + 1e-6f)
+          << "at " << i;
+      EXPECT_GE(c.data().get_ptr()[i], kQMin);
+   }
+
+   // Raw data holding -128 is refused: the AVX2 and VNNI kernels would
+   // disagree on it.
+   RawTensor<std::int8_t> raw({4, 8}, std::vector<std::int8_t>(32, -128),
+                              DType::INT8, Device{DeviceType::CPU, 0});
+   EXPECT_THROW(QuantizedTensor(raw, QuantParams{{1.0f}, {0}, -1}),
+                std::runtime_error);
+}
+
+// The int8 GEMM is exact integer arithmetic, so it must match the float
+// linear over the dequantized operands up to float rounding: shapes off the
+// 4 x 16 tile, K off the 4-byte quad, both zero points non-zero.
+TEST(QuantizeTest, LinearMatchesDequantizedReference) {
+   const RawTensor<float> x = wave({2, 37, 70}, 0.41f, 1.5f, 0.4f);
+   const RawTensor<float> w = wave({45, 70}, 0.13f, 0.5f, 0.2f);
+   const RawTensor<float> b = wave({45}, 0.7f, 0.3f, 0.0f);
+
+   const QuantizedTensor xq = quantize(x, QuantScheme::Affine);
+   for (const QuantScheme scheme :
+        {QuantScheme::Affine, QuantScheme::Symmetric}) {
+      const QuantizedTensor wt = scheme == QuantScheme::Affine
+                                     ? quantize(w, scheme)
+                                     : quantize(w, scheme, 0);
+      const QuantizedWeight wq(wt);
+      const RawTensor<float> ref =
+          dequantize(xq).linear(dequantize(wt), b, Activation::ReLU);
+      const RawTensor<float> y = linear(xq, wq, &b, Activation::ReLU);
+      ASSERT_EQ(y.shape(), ref.shape());
+      for (std::size_t i = 0; i < ref.flat_size(); ++i) {
+         EXPECT_NEAR(y.get_ptr()[i], ref.get_ptr()[i], 1e-4f) << "at " << i;
+      }
+   }
+}
+
+// Requantizing in the epilogue gives what quantizing the float output
+// would, give or take one step where rounding ties land differently.
+TEST(QuantizeTest, RequantizedLinearMatchesQuantizedOutput) {
+   const RawTensor<float> x = wave({40, 96}, 0.29f, 1.0f, 0.0f);
+   const RawTensor<float> w = wave({300, 96}, 0.05f, 0.25f, 0.0f);
+
+   const QuantizedTensor xq = quantize(x, QuantScheme::Affine);
+   const QuantizedWeight wq(w);
+   const RawTensor<float> y = linear(xq, wq);
+   const QuantParams out = calibrate(y, QuantScheme::Affine);
+   const QuantizedTensor want = quantize(y, out);
+   const QuantizedTensor got = linear(xq, wq, nullptr, Activation::None, out);
+   ASSERT_EQ(got.shape(), want.shape());
+   for (std::size_t i = 0; i < y.flat_size(); ++i) {
+      EXPECT_LE(std::abs(int(got.data().get_ptr()[i]) -
+                         int(want.data().get_ptr()[i])),
+                1)
+          << "at " << i;
+   }
+}
@@ -0,0 +1,199 @@
+#include <cmath>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "Fusion/Tensor.h"
+#include "Fusion/autodiff/ADTensor.hpp"
+#include "Fusion/core/Parallel.h"
+#include "Fusion/core/TreeReduce.hpp"
+
+namespace {
+
+RawTensor<float> iota_raw(std::vector<std::size_t> shape) {
+   std::size_t n = 1;
+   for (auto d : shape) {
+      n *= d;
+   }
+   std::vector<float> data(n);
+   for (std::size_t i = 0; i < n; ++i) {
+      data[i] = static_cast<float>(i);
+   }
+   return RawTensor<float>(shape, data, DType::FLOAT32,
+                           Device{DeviceType::CPU, 0});
+}
+
+} // namespace
+
+TEST(ReductionTest, TrailingAxesCoalesceIntoOneLoop) {
+   TensorDescription in{3, {2, 3, 4}, {12, 4, 1}, sizeof(float)};
+   TensorDescription out{1, {2}, {1}, sizeof(float)};
+   ReductionPlan plan = make_reduction_plan({out, in}, {1, 2}, false);
+   ASSERT_EQ(plan.loop.size(), 2u);
+   EXPECT_EQ(plan.loop[1].kind, LoopKind::Reduction);
+   EXPECT_EQ(plan.loop[1].size, 12u);
+   EXPECT_EQ(plan.loop[1].stride_bytes[1], 4);
+   EXPECT_EQ(plan.reduction_axes, (std::vector<std::size_t>{1, 2}));
+}
+
+TEST(ReductionTest, SumOverAxisSetMatchesChainedSums) {
+   RawTensor<float> x = iota_raw({2, 3, 4});
+   RawTensor<float> chained = x.sum(2, false).sum(0, false);
+   RawTensor<float> fused = x.sum(std::vector<std::size_t>{0, 2}, false);
+   ASSERT_EQ(fused.shape(), (std::vector<std::size_t>{3}));
+   for (std::size_t i = 0; i < 3; ++i) {
+      EXPECT_FLOAT_EQ(fused[i], chained[i]);
+   }
+
+   RawTensor<float> kept = x.sum(std::vector<std::size_t>{0, 2}, true);
+   EXPECT_EQ(kept.shape(), (std::vector<std::size_t>{1, 3, 1}));
+   RawTensor<float> neg =
+       x.mean(std::vector<std::size_t>{0, std::size_t(-1)}, false);
+   EXPECT_FLOAT_EQ(neg[1], fused[1] / 8.0f);
+}
+
+TEST(ReductionTest, GlobalKeepdimReducesEveryAxis) {
+   RawTensor<float> x = iota_raw({2, 3, 4});
+   RawTensor<float> s = x.sum(kGlobalReduceAxis, true);
+   EXPECT_EQ(s.shape(), (std::vector<std::size_t>{1, 1, 1}));
+   EXPECT_FLOAT_EQ(s[0], 276.0f);
+   RawTensor<float> m = x.mean(kGlobalReduceAxis, true);
+   EXPECT_EQ(m.shape(), (std::vector<std::size_t>{1, 1, 1}));
+   EXPECT_FLOAT_EQ(m[0], 11.5f);
+   EXPECT_EQ(x.sum(kGlobalReduceAxis, false).shape(),
+             (std::vector<std::size_t>{1}));
+}
+
+TEST(ReductionTest, MeanBackwardBroadcastsOverReducedAxes) {
+   EngineScope<float> scope;
+   scope.enter();
+   ADTensor<float> x(iota_raw({2, 3, 4}), true);
+   ADTensor<float> y = x.mean(std::vector<std::size_t>{1, 2}, false).sum(
+       kGlobalReduceAxis, false);
+   y.backward();
+   auto g = x.grad();
+   ASSERT_TRUE(g.has_value());
+   EXPECT_EQ(g->raw().shape(), (std::vector<std::size_t>{2, 3, 4}));
+   for (float v : g->raw()) {
+      EXPECT_FLOAT_EQ(v, 1.0f / 12.0f);
+   }
+}
+
+TEST(ReductionTest, ColumnSumMatchesScalarReference) {
+   // Tall and wider than one column panel, with ragged row/column tails.
+   const std::size_t rows = 37, cols = 1100;
+   RawTensor<float> x = iota_raw({rows, cols});
+   ReductionMeta meta = make_reduction_meta(x, 0, false);
+   EXPECT_TRUE(fusion::iter::is_column_reduction<float>(meta.plan));
+
+   RawTensor<float> s = x.sum(0, false);
+   ASSERT_EQ(s.shape(), (std::vector<std::size_t>{cols}));
+   for (std::size_t j = 0; j < cols; ++j) {
+      double ref = 0.0;
+      for (std::size_t i = 0; i < rows; ++i) {
+         ref += static_cast<double>(i * cols + j);
+      }
+      EXPECT_FLOAT_EQ(s[j], static_cast<float>(ref));
+   }
+}
+
+// mean scales as it stores, so every reduction path must agree with sum / n:
+// the global fast path, column blocks, contiguous runs and, through a
+// transposed view, strided runs.
+TEST(ReductionTest, MeanScalesOnEveryReductionPath) {
+   const RawTensor<float> x = iota_raw({6, 5, 7});
+   const std::vector<std::vector<std::size_t>> axis_sets = {
+       {0}, {1}, {2}, {0, 1}, {0, 2}, {1, 2}, {0, 1, 2}};
+   for (const RawTensor<float> &t : {x, x.swapaxes_view(0, 2)}) {
+      for (const auto &axes : axis_sets) {
+         std::size_t n = 1;
+         for (auto ax : axes) {
+            n *= t.shape()[ax];
+         }
+         RawTensor<float> s = t.sum(axes, false);
+         RawTensor<float> m = t.mean(axes, false);
+         ASSERT_EQ(m.shape(), s.shape());
+         for (std::size_t i = 0; i < s.flat_size(); ++i) {
+            EXPECT_FLOAT_EQ(m[i], s[i] / static_cast<float>(n))
+                << "axes of size " << axes.size() << " at " << i;
+         }
+      }
+   }
+   RawTensor<float> m0 = x.mean(0, false);
+   EXPECT_FLOAT_EQ(m0[0], 87.5f);
+}
+
+TEST(ReductionTest, TreeSumIsIndependentOfThreadCount) {
+   std::vector<float> v(10 * fusion::reduce::kTreeChunk + 123);
+   for (std::size_t i = 0; i < v.size(); ++i) {
+      v[i] = 1.0f / static_cast<float>(1 + i % 1000);
+   }
+   fusion::parallel::set_num_threads(1);
+   const float one = fusion::reduce::tree_sum(v.data(), v.size());
+   fusion::parallel::set_num_threads(4);
+   const float four = fusion::reduce::tree_sum(v.data(), v.size());
+   EXPECT_EQ(one, four);
+}
+
+TEST(ReductionTest, CompensatedSumRecoversSmallAddends) {
+   // 1 followed by many values below half an ulp of 1: a naive float sum
+   // never moves off 1.
+   std::vector<float> v(1 << 16, 1e-8f);
+   v[0] = 1.0f;
+   RawTensor<float> x({v.size()}, v, DType::FLOAT32,
+                      Device{DeviceType::CPU, 0});
+   const double exact = 1.0 + 1e-8 * double(v.size() - 1);
+   const float plain = x.sum(std::vector<std::size_t>{}, false)[0];
+   const float comp =
+       x.sum(std::vector<std::size_t>{}, false, SumMode::Compensated)[0];
+   EXPECT_LT(std::abs(comp - exact), std::abs(plain - exact));
+   EXPECT_NEAR(comp, exact, 1e-6);
+}
+
+TEST(ReductionTest, VarianceMatchesTwoPassReference) {
+   const std::size_t rows = 5, cols = 7;
+   RawTensor<float> x = iota_raw({rows, cols});
+   auto reference = [&](bool over_rows, std::size_t k) {
+      const std::size_t n = over_rows ? rows : cols;
+      double mean = 0.0, m2 = 0.0;
+      for (std::size_t i = 0; i < n; ++i) {
+         mean += x[over_rows ? i * cols + k : k * cols + i];
+      }
+      mean /= double(n);
+      for (std::size_t i = 0; i < n; ++i) {
+         const double d = x[over_rows ? i * cols + k : k * cols + i] - mean;
+         m2 += d * d;
+      }
+      return m2 / double(n - 1);
+   };
+
+   RawTensor<float> v0 = x.var({0}, false, 1);
+   RawTensor<float> v1 = x.var({1}, true, 1);
+   ASSERT_EQ(v1.shape(), (std::vector<std::size_t>{rows, 1}));
+   for (std::size_t j = 0; j < cols; ++j) {
+      EXPECT_NEAR(v0[j], reference(true, j), 1e-3);
+   }
+   for (std::size_t i = 0; i < rows; ++i) {
+      EXPECT_NEAR(v1[i], reference(false, i), 1e-3);
+   }
+
+   // 0..n-1 has population variance (n^2 - 1) / 12.
+   const double n = double(rows * cols);
+   EXPECT_NEAR(x.var({}, false)[0], (n * n - 1.0) / 12.0, 1e-2);
+   EXPECT_NEAR(x.stddev({}, false)[0], std::sqrt((n * n - 1.0) / 12.0), 1e-3);
+}
+
+TEST(ReductionTest, VarianceBackwardIsCentredScaledInput) {
+   EngineScope<float> scope;
+   scope.enter();
+   ADTensor<float> x(iota_raw({2, 4}), true);
+   ADTensor<float> y = x.var({1}, false).sum(kGlobalReduceAxis, false);
+   y.backward();
+   auto g = x.grad();
+   ASSERT_TRUE(g.has_value());
+   // Row mean is 1.5 / 5.5; d var / dx = 2 (x - mean) / 4.
+   const float expected[] = {-0.75f, -0.25f, 0.25f, 0.75f};
+   for (std::size_t i = 0; i < 8; ++i) {
+      EXPECT_FLOAT_EQ(g->raw()[int(i)], expected[i % 4]);
+   }
+}
@@ -1,5 +1,5 @@
 """
-Fusion Tensor module exposing Tensor<float> (for composition)
+Fusion Tensor module exposing Tensor<float> and Tensor<double> (for composition)
 """
 
 from __future__ import annotations
@@ -7,16 +7,22 @@ import numpy
 import typing
 from . import autodiff
 from . import factory
+from . import factory64
 
 __all__ = [
     "CppDType",
     "CppDevice",
     "CppDeviceType",
     "Random",
+    "Random64",
     "Tensor",
+    "Tensor64",
     "autodiff",
     "factory",
+    "factory64",
+    "get_num_threads",
     "grad_tape",
+    "set_num_threads",
 ]
 
 class CppDType:
@@ -32,16 +38,25 @@ class CppDType:
       INT64
 
       BOOL
+
+      BFLOAT16
+
+      FLOAT16
+
+      INT8
     """
 
+    BFLOAT16: typing.ClassVar[CppDType]  # value = <CppDType.BFLOAT16: 5>
     BOOL: typing.ClassVar[CppDType]  # value = <CppDType.BOOL: 4>
+    FLOAT16: typing.ClassVar[CppDType]  # value = <CppDType.FLOAT16: 6>
     FLOAT32: typing.ClassVar[CppDType]  # value = <CppDType.FLOAT32: 0>
     FLOAT64: typing.ClassVar[CppDType]  # value = <CppDType.FLOAT64: 1>
     INT32: typing.ClassVar[CppDType]  # value = <CppDType.INT32: 2>
     INT64: typing.ClassVar[CppDType]  # value = <CppDType.INT64: 3>
+    INT8: typing.ClassVar[CppDType]  # value = <CppDType.INT8: 7>
     __members__: typing.ClassVar[
         dict[str, CppDType]
-    ]  # value = {'FLOAT32': <CppDType.FLOAT32: 0>, 'FLOAT64': <CppDType.FLOAT64: 1>, 'INT32': <CppDType.INT32: 2>, 'INT64': <CppDType.INT64: 3>, 'BOOL': <CppDType.BOOL: 4>}
+    ]  # value = {'FLOAT32': <CppDType.FLOAT32: 0>, 'FLOAT64': <CppDType.FLOAT64: 1>, 'INT32': <CppDType.INT32: 2>, 'INT64': <CppDType.INT64: 3>, 'BOOL': <CppDType.BOOL: 4>, 'BFLOAT16': <CppDType.BFLOAT16: 5>, 'FLOAT16': <CppDType.FLOAT16: 6>, 'INT8': <CppDType.INT8: 7>}
     def __eq__(self, other: typing.Any) -> bool: ...
     def __getstate__(self) -> int: ...
     def __hash__(self) -> int: ...
@@ -98,6 +113,12 @@ class Random:
         self, shape: list[int], min: float, max: float, device: Device
     ) -> Tensor: ...
 
+class Random64:
+    def __init__(self, seed: int = 2999322463) -> None: ...
+    def uniform_cpp(
+        self, shape: list[int], min: float, max: float, device: Device
+    ) -> Tensor64: ...
+
 class Tensor:
     @typing.overload
     def __add__(self, arg0: Tensor) -> Tensor: ...
@@ -161,23 +182,51 @@ class Tensor:
     def diag(self) -> ...: ...
     def exp(self) -> Tensor: ...
     def get_grad(self) -> Tensor: ...
+    @typing.overload
+    def linear(self, kernel: Tensor, activation: str = "none") -> Tensor:
+        """
+        activation(x @ kernel.T), fused into one GEMM.
+        """
+
+    @typing.overload
+    def linear(
+        self, kernel: Tensor, bias: Tensor, activation: str = "none"
+    ) -> Tensor:
+        """
+        activation(x @ kernel.T + bias), with the bias and activation applied in the GEMM epilogue.
+        """
+
     def log(self) -> Tensor: ...
     @typing.overload
     def maximum(self, arg0: Tensor) -> Tensor: ...
     @typing.overload
     def maximum(self, arg0: float) -> Tensor: ...
+    @typing.overload
     def mean(self) -> Tensor:
         """
         Return the global mean of the Tensor.
         """
 
+    @typing.overload
+    def mean(self, axis: int, keepdim: bool = False) -> Tensor: ...
+    @typing.overload
+    def mean(self, axis: list[int], keepdim: bool = False) -> Tensor: ...
+
     def set_values(self, values: list[float]) -> None:
         """
         Fill the Tensor with a flat list of length prod(shape).
         """
 
     def sqrt(self) -> Tensor: ...
+    def std(
+        self, axis: list[int] = [], keepdim: bool = False, correction: int = 0
+    ) -> Tensor: ...
+    @typing.overload
     def sum(self) -> Tensor: ...
+    @typing.overload
+    def sum(self, axis: int, keepdim: bool = False) -> Tensor: ...
+    @typing.overload
+    def sum(self, axis: list[int], keepdim: bool = False) -> Tensor: ...
     def swapaxes(self, axis1: int, axis2: int) -> Tensor: ...
     def to_numpy(self) -> numpy.ndarray[numpy.float32]:
         """
@@ -189,6 +238,9 @@ class Tensor:
         Return the transpose.
         """
 
+    def var(
+        self, axis: list[int] = [], keepdim: bool = False, correction: int = 0
+    ) -> Tensor: ...
     @property
     def dtype(self) -> numpy.dtype[typing.Any]:
         """
@@ -227,9 +279,179 @@ class Tensor:
         Total number of elements (product of shape).
         """
 
+class Tensor64:
+    @typing.overload
+    def __add__(self, arg0: Tensor64) -> Tensor64: ...
+    @typing.overload
+    def __add__(self, arg0: float) -> Tensor64: ...
+    @typing.overload
+    def __ge__(self, arg0: Tensor64) -> Tensor64: ...
+    @typing.overload
+    def __ge__(self, arg0: float) -> Tensor64: ...
+    def __gt__(self, arg0: Tensor64) -> Tensor64: ...
+    @typing.overload
+    def __init__(
+        self, shape: list[int], dtype: DType, device: Device, requires_grad: bool
+    ) -> None:
+        """
+        Construct a Tensor64 of given shape, zero-initialized. Optionally set requires_grad.
+        """
+
+    @typing.overload
+    def __init__(
+        self,
+        shape: list[int],
+        data: list[float],
+        dtype: DType,
+        device: Device,
+        requires_grad: bool,
+    ) -> None:
+        """
+        Construct a Tensor64 from a shape list and a flat data list. Optionally set requires_grad.
+        """
+
+    def __isub__(self, arg0: Tensor64) -> Tensor64: ...
+    def __matmul__(self, arg0: Tensor64) -> Tensor64:
+        """
+        Matrix multiplication (A @ B)
+        """
+
+    @typing.overload
+    def __mul__(self, arg0: Tensor64) -> Tensor64: ...
+    @typing.overload
+    def __mul__(self, arg0: float) -> Tensor64: ...
+    def __neg__(self) -> Tensor64: ...
+    @typing.overload
+    def __pow__(self, arg0: Tensor64) -> Tensor64: ...
+    @typing.overload
+    def __pow__(self, arg0: float) -> Tensor64: ...
+    @typing.overload
+    def __pow__(self, arg0: Tensor64) -> Tensor64: ...
+    @typing.overload
+    def __pow__(self, arg0: float) -> Tensor64: ...
+    def __repr__(self) -> str: ...
+    @typing.overload
+    def __sub__(self, arg0: Tensor64) -> Tensor64: ...
+    @typing.overload
+    def __sub__(self, arg0: float) -> Tensor64: ...
+    @typing.overload
+    def __truediv__(self, arg0: Tensor64) -> Tensor64: ...
+    @typing.overload
+    def __truediv__(self, arg0: float) -> Tensor64: ...
+    def backward(self) -> None: ...
+    def diag(self) -> ...: ...
+    def exp(self) -> Tensor64: ...
+    def get_grad(self) -> Tensor64: ...
+    @typing.overload
+    def linear(self, kernel: Tensor64, activation: str = "none") -> Tensor64:
+        """
+        activation(x @ kernel.T), fused into one GEMM.
+        """
+
+    @typing.overload
+    def linear(
+        self, kernel: Tensor64, bias: Tensor64, activation: str = "none"
+    ) -> Tensor64:
+        """
+        activation(x @ kernel.T + bias), with the bias and activation applied in the GEMM epilogue.
+        """
+
+    def log(self) -> Tensor64: ...
+    @typing.overload
+    def maximum(self, arg0: Tensor64) -> Tensor64: ...
+    @typing.overload
+    def maximum(self, arg0: float) -> Tensor64: ...
+    @typing.overload
+    def mean(self) -> Tensor64:
+        """
+        Return the global mean of the Tensor64.
+        """
+
+    @typing.overload
+    def mean(self, axis: int, keepdim: bool = False) -> Tensor64: ...
+    @typing.overload
+    def mean(self, axis: list[int], keepdim: bool = False) -> Tensor64: ...
+
+    def set_values(self, values: list[float]) -> None:
+        """
+        Fill the Tensor64 with a flat list of length prod(shape).
+        """
+
+    def sqrt(self) -> Tensor64: ...
+    def std(
+        self, axis: list[int] = [], keepdim: bool = False, correction: int = 0
+    ) -> Tensor64: ...
+    @typing.overload
+    def sum(self) -> Tensor64: ...
+    @typing.overload
+    def sum(self, axis: int, keepdim: bool = False) -> Tensor64: ...
+    @typing.overload
+    def sum(self, axis: list[int], keepdim: bool = False) -> Tensor64: ...
+    def swapaxes(self, axis1: int, axis2: int) -> Tensor64: ...
+    def to_numpy(self) -> numpy.ndarray[numpy.float64]:
+        """
+        Return a NumPy array view of the Tensor64’s contents.
+        """
+
+    def transpose(self) -> ...:
+        """
+        Return the transpose.
+        """
+
+    def var(
+        self, axis: list[int] = [], keepdim: bool = False, correction: int = 0
+    ) -> Tensor64: ...
+    @property
+    def dtype(self) -> numpy.dtype[typing.Any]:
+        """
+        NumPy dtype of the tensor.
+        """
+
+    @property
+    def name(self) -> str:
+        """
+        Returns the name of the Tensor64
+        """
+
+    @property
+    def ndim(self) -> int:
+        """
+        Number of dimensions.
+        """
+
+    @property
+    def requires_grad(self) -> bool:
+        """
+        Requires grad flag
+        """
+
+    @requires_grad.setter
+    def requires_grad(self, arg1: bool) -> None: ...
+    @property
+    def shape(self) -> list[int]:
+        """
+        Returns the shape as a list of ints.
+        """
+
+    @property
+    def size(self) -> int:
+        """
+        Total number of elements (product of shape).
+        """
+
 class grad_tape:
     def __enter__(self) -> grad_tape: ...
     def __exit__(
         self, arg0: typing.Any, arg1: typing.Any, arg2: typing.Any
     ) -> bool: ...
     def __init__(self) -> None: ...
+
+def get_num_threads() -> int:
+    """
+    Number of threads used by Fusion kernels.
+    """
+
+def set_num_threads(num_threads: int) -> None:
+    """
+    Set the number of threads used by Fusion kernels and BLAS. Defaults to FUSION_NUM_THREADS or the CPUs this process may run on.
+    """
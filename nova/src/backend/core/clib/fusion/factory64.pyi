@@ -0,0 +1,39 @@
+"""
+factory functions for Tensor<d>
+"""
+
+from __future__ import annotations
+import nova.src.backend.core.clib.fusion
+
+__all__ = ["fill", "ones", "ones_like", "zeros", "zeros_like"]
+
+def fill(
+    shape: list[int], value: float, device: Device
+) -> nova.src.backend.core.clib.fusion.Tensor64:
+    """
+    Create a tensor filled with a given value
+    """
+
+def ones(shape: list[int], device: Device) -> nova.src.backend.core.clib.fusion.Tensor64:
+    """
+    Create a tensor of ones
+    """
+
+def ones_like(
+    other: nova.src.backend.core.clib.fusion.Tensor64,
+) -> nova.src.backend.core.clib.fusion.Tensor64:
+    """
+    Create a ones tensor with the same shape as another
+    """
+
+def zeros(shape: list[int], device: Device) -> nova.src.backend.core.clib.fusion.Tensor64:
+    """
+    Create a tensor of zeros
+    """
+
+def zeros_like(
+    other: nova.src.backend.core.clib.fusion.Tensor64,
+) -> nova.src.backend.core.clib.fusion.Tensor64:
+    """
+    Create a zeros tensor with the same shape as another
+    """
@@ -11,6 +11,9 @@ class DType(Enum):
     INT32 = 2
     INT64 = 3
     BOOL = 4
+    BFLOAT16 = 5
+    FLOAT16 = 6
+    INT8 = 7
 
 
 class Float32:
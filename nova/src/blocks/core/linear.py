@@ -41,8 +41,8 @@ class Linear(Block):
 
     def call(self, inputs):
         # For an input of shape (batch, in_features) and a kernel of shape (units, in_features),
-        # we compute the output as: output = inputs @ kernel.T + bias.
-        output = inputs @ self.kernel.T
+        # we compute the output as: output = inputs @ kernel.T + bias, with the bias added
+        # inside the GEMM rather than as a second pass over the output.
         if self.bias:
-            output += self.bias_value
-        return output
+            return inputs.linear(self.kernel, self.bias_value)
+        return inputs.linear(self.kernel)
@@ -107,6 +107,10 @@ def test_sum(input_data, expected_data, requires_grad):
         ([[1, 2], [3, 4]], 0, False, [4, 6], False),
         ([[1, 2], [3, 4]], 1, True, [[3], [7]], False),
         ([[1, 2], [3, 4]], 0, True, [[4, 6]], False),
+        ([[1, 2], [3, 4]], -1, False, [3, 7], False),
+        ([[1, 2], [3, 4]], -2, True, [[4, 6]], False),
+        ([[1, 2], [3, 4]], [0, 1], True, [[10]], False),
+        ([[1, 2], [3, 4]], [0, 1], False, [10], False),
     ],
 )
 def test_sum_with_axis(input_data, axis, keepdim, expected_data, requires_grad):
@@ -142,6 +146,8 @@ def test_mean(input_data, expected_data, requires_grad):
         ([[1, 2], [3, 4]], 0, False, [2.0, 3.0], False),
         ([[1, 2], [3, 4]], 1, True, [[1.5], [3.5]], False),
         ([[1, 2], [3, 4]], 0, True, [[2.0, 3.0]], False),
+        ([[1, 2], [3, 4]], -1, False, [1.5, 3.5], False),
+        ([[1, 2], [3, 4]], [0, 1], True, [[2.5]], False),
     ],
 )
 def test_mean_with_axis(input_data, axis, keepdim, expected_data, requires_grad):
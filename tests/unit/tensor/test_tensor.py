@@ -3,6 +3,12 @@ import pytest
 
 from nova.src.backend.core import Tensor
 from nova.src.backend.core.clib import factory_methods as fm
+from nova.src.backend.core.clib.fusion import (
+    CppDevice,
+    CppDeviceType,
+    CppDType,
+    Tensor64,
+)
 from tests.integration.gradient import set_grad_tape
 
 
@@ -110,6 +116,18 @@ def test_tensor_backward_right_subtraction(
     np.testing.assert_array_equal(b.grad.to_numpy(), expected_grad_b)
 
 
+@set_grad_tape
+def test_tensor64_backward_multiplication():
+    """grad_tape records Tensor64 ops too, so float64 graphs backpropagate."""
+    cpu = CppDevice(CppDeviceType.CPU, 0)
+    a = Tensor64([3], [1.0, 2.0, 3.0], CppDType.FLOAT64, cpu, True)
+    b = Tensor64([3], [4.0, 5.0, 6.0], CppDType.FLOAT64, cpu, True)
+    c = a * b
+    c.backward()
+    np.testing.assert_array_equal(a.get_grad().to_numpy(), [4.0, 5.0, 6.0])
+    np.testing.assert_array_equal(b.get_grad().to_numpy(), [1.0, 2.0, 3.0])
+
+
 @pytest.mark.parametrize(
     "data_a, data_b, expected_data",
     [